@@ -27,6 +27,12 @@ elseif("${LEARNING}" MATCHES "(0|OFF)")
     set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DLEARNING=0")
 endif()
 
+if("${TUNING}" MATCHES "(1|ON)")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DTUNING=1")
+elseif("${TUNING}" MATCHES "(0|OFF)")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DTUNING=0")
+endif()
+
 if("${MATERIAL_LEARNING}" MATCHES "(1|ON)")
     set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DMATERIAL_LEARNING=1")
 elseif("${MATERIAL_LEARNING}" MATCHES "(0|OFF)")
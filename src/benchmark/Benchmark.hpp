@@ -7,12 +7,17 @@
 #define SUNFIS_BENCHMARK_BENCHMARK_HPP__
 
 #include "common/Def.hpp"
-#include "common/time/Timer.hpp"
+#include "common/string/Wildcard.hpp"
 #include "logger/Logger.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <iomanip>
+#include <iostream>
 #include <string>
 #include <sstream>
 #include <map>
@@ -24,9 +29,8 @@
 
 #if WIN32
 # include <windows.h>
-#else
-# include <csignal>
-# include <unistd.h>
+#elif defined(__linux__)
+# include <sched.h>
 #endif
 
 #define BENCHMARK(n, f) auto n ## __bm_object__ = sunfish::create_bm_object__(#n, (f))
@@ -45,75 +49,76 @@ inline const char* BMSTR(T&& str) {
 using BMTimeType = uint64_t;
 using BMCounterType = uint64_t;
 
+/** significant changes smaller than this rate are ignored. */
+CONSTEXPR_CONST double BMMinimumChangeRate = 0.02;
+
+/**
+ * BenchmarkController runs the loop of a benchmark function
+ * for a fixed number of iterations and measures the elapsed time.
+ */
 class BenchmarkController {
 public:
 
-  BenchmarkController(BMTimeType usec) : usec_(usec) {
+  BenchmarkController(BMCounterType iterations) :
+    iterations_(iterations),
+    count_(0),
+    elapsed_(0) {
   }
 
   void start() {
-    interrupted_ = false;
     count_ = 0;
-    swap(this);
-    timer_.start();
-#ifdef WIN32
-    timeSetEvent(usec_ / 1000, 10, sigtime, 0, TIME_ONESHOT);
-#else
-    signal(SIGALRM, sigalrm);
-    if (usec_ < 1000 * 1000) {
-      ualarm(usec_, 0);
-    } else {
-      alarm(usec_ / (1000 * 1000));
-    }
-#endif
+    base_ = Clock::now();
   }
 
   bool cont() {
-    count_++;
-    if (interrupted_) {
-      elapsed_ = timer_.elapsed() * 1000000;
-      return false;
+    if (count_ < iterations_) {
+      count_++;
+      return true;
     }
-    return true;
+    auto elapsed = Clock::now() - base_;
+    elapsed_ = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return false;
   }
 
   BMCounterType getCount() const {
     return count_;
   }
 
-  BMTimeType getElapsed() const {
+  /**
+   * the elapsed time in nano seconds.
+   */
+  BMTimeType getElapsedNs() const {
     return elapsed_;
   }
 
 private:
 
-  static BenchmarkController* swap(BenchmarkController* newIns) {
-    static BenchmarkController* ins;
-    auto prevIns = ins;
-    ins = newIns;
-    return prevIns;
-  }
-
-#ifdef WIN32
-  static VOID CALLBACK sigalrm(UINT uTimerID, UINT uMsg, DWORD dwUser, DWORD dw1, DWORD dw2)
-#else
-  static void sigalrm(int)
-#endif
-  {
-    auto ins = swap(nullptr);
-    ASSERT(ins != nullptr);
-    ASSERT(!ins->interrupted_);
-    ins->interrupted_ = true;
-  }
+  using Clock = std::chrono::steady_clock;
 
-  volatile bool interrupted_;
-  BMTimeType usec_;
+  BMCounterType iterations_;
   BMCounterType count_;
-  Timer timer_;
+  Clock::time_point base_;
   BMTimeType elapsed_;
 
 };
 
+/**
+ * the statistics of nano seconds per iteration.
+ */
+struct BenchmarkStatistics {
+  std::string name;
+  std::string params;
+  int index;
+  BMCounterType iterations;
+  int samples;
+  double median;
+  double p95;
+  double mean;
+  double stddev;
+  double ciLower;
+  double ciUpper;
+};
+
 class BenchmarkSuite {
 public:
 
@@ -123,6 +128,13 @@ public:
     BMTimeType time;
   };
 
+  struct Config {
+    int samples;
+    int warmup;
+    /** a wildcard pattern matched with a part of the names (empty: all) */
+    std::string filter;
+  };
+
   template <class T>
   static void addInitializer(intptr_t ptr, T&& initializer) {
     auto& ins = getInstance();
@@ -152,45 +164,304 @@ public:
     }
   }
 
+  static const Config& getConfig() {
+    return getInstance().config_;
+  }
+
+  static void setConfig(const Config& config) {
+    getInstance().config_ = config;
+  }
+
   static void run() {
     auto& ins = getInstance();
+    ins.results_.clear();
+
+    MSG(info) << "Benchmark                                  Iterations  Median[ns]     P95[ns]  95% CI[ns]";
+    MSG(info) << "-------------------------------------------------------------------------------------------";
+
+    Wildcard filter("*" + ins.config_.filter + "*");
     for (const auto& pair : ins.entries_) {
       const auto& name = pair.first;
       const auto& list = pair.second;
-      run(name, list);
+      for (size_t i = 0; i < list.size(); i++) {
+        std::string longName = getLongName(name, list[i].params);
+        if (!filter.match(longName)) {
+          continue;
+        }
+        run(name, static_cast<int>(i), list[i]);
+      }
     }
-  }
 
-private:
+    MSG(info) << "";
+  }
 
-  static void run(const std::string& name, const std::vector<Entry>& list) {
-    MSG(info) << "Benchmark                                        Time[us]      Iterations";
-    MSG(info) << "-------------------------------------------------------------------------";
+  static const std::vector<BenchmarkStatistics>& getResults() {
+    return getInstance().results_;
+  }
 
-    for (const auto& entry : list) {
-      BenchmarkController bc(entry.time);
+  /**
+   * pin the current thread to the specified CPU.
+   */
+  static bool pinCpu(int cpu) {
+#if defined(WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+  }
 
-      entry.function(bc);
+  static void writeJson(std::ostream& os) {
+    const auto& results = getInstance().results_;
+    os << "{\n";
+    os << "\"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+      const auto& r = results[i];
+      // one benchmark per line so that readJson can parse it line by line.
+      os << "{"
+         << "\"name\": \"" << escape(r.name) << "\", "
+         << "\"params\": \"" << escape(r.params) << "\", "
+         << "\"index\": " << r.index << ", "
+         << "\"iterations\": " << r.iterations << ", "
+         << "\"samples\": " << r.samples << ", "
+         << "\"median\": " << r.median << ", "
+         << "\"p95\": " << r.p95 << ", "
+         << "\"mean\": " << r.mean << ", "
+         << "\"stddev\": " << r.stddev << ", "
+         << "\"ciLower\": " << r.ciLower << ", "
+         << "\"ciUpper\": " << r.ciUpper
+         << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "]\n";
+    os << "}\n";
+  }
 
-      std::ostringstream longName;
-      longName << name;
-      if (!entry.params.empty()) {
-        longName << '/' << entry.params;
+  /**
+   * read a file written by writeJson.
+   */
+  static bool readJson(std::istream& is, std::vector<BenchmarkStatistics>& results) {
+    std::string line;
+    while (std::getline(is, line)) {
+      if (line.compare(0, 8, "{\"name\":") != 0) {
+        continue;
       }
+      BenchmarkStatistics r;
+      if (!getString(line, "name", r.name) ||
+          !getString(line, "params", r.params)) {
+        return false;
+      }
+      double index, iterations, samples;
+      if (!getNumber(line, "index", index) ||
+          !getNumber(line, "iterations", iterations) ||
+          !getNumber(line, "samples", samples) ||
+          !getNumber(line, "median", r.median) ||
+          !getNumber(line, "p95", r.p95) ||
+          !getNumber(line, "mean", r.mean) ||
+          !getNumber(line, "stddev", r.stddev) ||
+          !getNumber(line, "ciLower", r.ciLower) ||
+          !getNumber(line, "ciUpper", r.ciUpper)) {
+        return false;
+      }
+      r.index = static_cast<int>(index);
+      r.iterations = static_cast<BMCounterType>(iterations);
+      r.samples = static_cast<int>(samples);
+      results.push_back(r);
+    }
+    return true;
+  }
 
-      float ips = (float)bc.getCount() / bc.getElapsed() * 1e+6;
+  /**
+   * compare two result sets.
+   * A change is significant when the confidence intervals do not
+   * overlap and the medians differ by BMMinimumChangeRate or more.
+   * @return false if a significant regression is found.
+   */
+  static bool compare(const std::vector<BenchmarkStatistics>& base,
+                      const std::vector<BenchmarkStatistics>& target) {
+    MSG(info) << "Benchmark                                    Base[ns]  Target[ns]    Change";
+    MSG(info) << "---------------------------------------------------------------------------";
+
+    bool ok = true;
+    for (const auto& t : target) {
+      auto ite = std::find_if(base.begin(), base.end(), [&t](const BenchmarkStatistics& b) {
+        return b.name == t.name && b.index == t.index;
+      });
+      if (ite == base.end()) {
+        continue;
+      }
+      const auto& b = *ite;
+
+      double rate = (t.median - b.median) / b.median;
+      bool significant = (t.ciLower > b.ciUpper || t.ciUpper < b.ciLower) &&
+                         std::fabs(rate) >= BMMinimumChangeRate;
+      const char* mark = "";
+      if (significant && rate > 0.0) {
+        mark = "  REGRESSION";
+        ok = false;
+      } else if (significant) {
+        mark = "  improvement";
+      }
 
       MSG(info)
-        << std::setw(41) << std::left  << longName.str() << ' '
-        << std::setw(15) << std::right << bc.getElapsed() << ' '
-        << std::setw(15) << std::right << bc.getCount() << ' '
-        << ips << "/sec";
+        << std::setw(41) << std::left  << getLongName(t.name, t.params) << ' '
+        << std::setw(11) << std::right << std::fixed << std::setprecision(1) << b.median << ' '
+        << std::setw(11) << std::right << t.median << ' '
+        << std::setw(8)  << std::right << std::showpos << rate * 100.0 << std::noshowpos << '%'
+        << mark;
     }
 
     MSG(info) << "";
+
+    return ok;
+  }
+
+private:
+
+  static void run(const std::string& name, int index, const Entry& entry) {
+    const auto& config = getInstance().config_;
+    BMTimeType sampleNs = entry.time * 1000;
+
+    // calibration
+    BMCounterType iterations = 1;
+    while (true) {
+      BenchmarkController bc(iterations);
+      entry.function(bc);
+      BMTimeType elapsed = bc.getElapsedNs();
+      if (elapsed >= sampleNs / 4) {
+        iterations = std::max<BMCounterType>(1, iterations * sampleNs / std::max<BMTimeType>(elapsed, 1));
+        break;
+      }
+      iterations *= 2;
+    }
+
+    for (int i = 0; i < config.warmup; i++) {
+      BenchmarkController bc(iterations);
+      entry.function(bc);
+    }
+
+    int samples = std::max(config.samples, 2);
+    std::vector<double> times;
+    for (int i = 0; i < samples; i++) {
+      BenchmarkController bc(iterations);
+      entry.function(bc);
+      times.push_back(static_cast<double>(bc.getElapsedNs()) / iterations);
+    }
+
+    BenchmarkStatistics r = calculateStatistics(times);
+    r.name = name;
+    r.params = entry.params;
+    r.index = index;
+    r.iterations = iterations;
+
+    std::ostringstream ci;
+    ci << std::fixed << std::setprecision(1) << r.ciLower << '-' << r.ciUpper;
+
+    MSG(info)
+      << std::setw(41) << std::left  << getLongName(name, entry.params) << ' '
+      << std::setw(11) << std::right << iterations << ' '
+      << std::setw(11) << std::right << std::fixed << std::setprecision(1) << r.median << ' '
+      << std::setw(11) << std::right << r.p95 << ' '
+      << std::setw(11) << std::right << ci.str();
+
+    getInstance().results_.push_back(r);
   }
 
-  BenchmarkSuite() = default;
+  static BenchmarkStatistics calculateStatistics(std::vector<double> times) {
+    BenchmarkStatistics r;
+    size_t n = times.size();
+    std::sort(times.begin(), times.end());
+
+    r.samples = static_cast<int>(n);
+    r.median = n % 2 == 1 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) * 0.5;
+    r.p95 = times[std::min(n - 1, static_cast<size_t>(std::ceil(n * 0.95)) - 1)];
+
+    double sum = 0.0;
+    for (auto t : times) {
+      sum += t;
+    }
+    r.mean = sum / n;
+
+    double sq = 0.0;
+    for (auto t : times) {
+      sq += (t - r.mean) * (t - r.mean);
+    }
+    r.stddev = std::sqrt(sq / (n - 1));
+
+    double margin = tValue95(static_cast<int>(n - 1)) * r.stddev / std::sqrt(static_cast<double>(n));
+    r.ciLower = r.mean - margin;
+    r.ciUpper = r.mean + margin;
+
+    return r;
+  }
+
+  /**
+   * the two-sided 95% critical value of Student's t-distribution.
+   */
+  static double tValue95(int df) {
+    static const double table[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df <= 0) {
+      return table[0];
+    } else if (df <= 30) {
+      return table[df - 1];
+    }
+    return 1.960;
+  }
+
+  static std::string getLongName(const std::string& name, const std::string& params) {
+    return params.empty() ? name : name + '/' + params;
+  }
+
+  static std::string escape(const std::string& str) {
+    std::string ret;
+    for (auto c : str) {
+      if (c == '"' || c == '\\') {
+        ret += '\\';
+      }
+      ret += c;
+    }
+    return ret;
+  }
+
+  static bool getString(const std::string& line, const char* key, std::string& value) {
+    std::string k = std::string("\"") + key + "\": \"";
+    auto pos = line.find(k);
+    if (pos == std::string::npos) {
+      return false;
+    }
+    value.clear();
+    for (pos += k.length(); pos < line.length(); pos++) {
+      char c = line[pos];
+      if (c == '"') {
+        return true;
+      } else if (c == '\\' && pos + 1 < line.length()) {
+        c = line[++pos];
+      }
+      value += c;
+    }
+    return false;
+  }
+
+  static bool getNumber(const std::string& line, const char* key, double& value) {
+    std::string k = std::string("\"") + key + "\": ";
+    auto pos = line.find(k);
+    if (pos == std::string::npos) {
+      return false;
+    }
+    value = std::strtod(line.c_str() + pos + k.length(), nullptr);
+    return true;
+  }
+
+  BenchmarkSuite() : config_({ 15, 2, "" }) {
+  }
   BenchmarkSuite(const BenchmarkSuite&) = delete;
   BenchmarkSuite(BenchmarkSuite&&) = delete;
 
@@ -201,6 +472,8 @@ private:
 
   std::map<std::string, std::vector<Entry>> entries_;
   std::map<intptr_t, std::function<void()>> initializerMap_;
+  Config config_;
+  std::vector<BenchmarkStatistics> results_;
 
 };
 
@@ -216,6 +489,7 @@ public:
     std::string params;
   };
 
+  /** the duration of each sample in micro seconds */
   static CONSTEXPR_CONST BMTimeType DefaultMicroSecondTime = 32 * 1000;
 
   template <class T>
@@ -9,6 +9,7 @@
 #include "benchmark/Benchmark.hpp"
 #include "logger/Logger.hpp"
 #include <fstream>
+#include <string>
 
 using namespace sunfish;
 
@@ -20,6 +21,12 @@ int main(int argc, char** argv, char**) {
   ProgramOptions po;
   po.addOption("silent", "s", "silent mode");
   po.addOption("out", "o", "output file name", true);
+  po.addOption("filter", "f", "run only benchmarks whose names contain the wildcard pattern (*, ?)", true);
+  po.addOption("samples", "n", "the number of samples of each benchmark", true);
+  po.addOption("warmup", "w", "the number of warmup samples of each benchmark", true);
+  po.addOption("cpu", "c", "pin the benchmark thread to the specified CPU", true);
+  po.addOption("json", "j", "write results to the specified JSON file", true);
+  po.addOption("compare", "compare two JSON files (usage: --compare BASE TARGET)");
   po.addOption("help", "h", "show this help");
   po.parse(argc, argv);
 
@@ -63,11 +70,63 @@ int main(int argc, char** argv, char**) {
     return 1;
   }
 
+  // compare mode
+  if (po.has("compare")) {
+    const auto& args = po.getStdArguments();
+    if (args.size() != 2) {
+      MSG(error) << "--compare requires 2 files";
+      return 1;
+    }
+
+    std::vector<BenchmarkStatistics> results[2];
+    for (int i = 0; i < 2; i++) {
+      std::ifstream fin(args[i]);
+      if (!fin || !BenchmarkSuite::readJson(fin, results[i])) {
+        MSG(error) << "Could not read the result file: " << args[i];
+        return 1;
+      }
+    }
+
+    bool ok = BenchmarkSuite::compare(results[0], results[1]);
+    return ok ? 0 : 1;
+  }
+
+  // configuration
+  auto config = BenchmarkSuite::getConfig();
+  if (po.has("filter")) {
+    config.filter = po.getValue("filter");
+  }
+  if (po.has("samples")) {
+    config.samples = std::stoi(po.getValue("samples"));
+  }
+  if (po.has("warmup")) {
+    config.warmup = std::stoi(po.getValue("warmup"));
+  }
+  BenchmarkSuite::setConfig(config);
+
+  if (po.has("cpu")) {
+    int cpu = std::stoi(po.getValue("cpu"));
+    if (!BenchmarkSuite::pinCpu(cpu)) {
+      MSG(warning) << "Could not pin the thread to CPU " << cpu;
+    }
+  }
+
   // initialization
   BenchmarkSuite::initialize();
 
   // execute
   BenchmarkSuite::run();
 
+  // write results
+  if (po.has("json")) {
+    std::string jsonFileName = po.getValue("json");
+    std::ofstream fjson(jsonFileName, std::ios::out);
+    if (!fjson) {
+      MSG(error) << "Could not open JSON file: " << jsonFileName;
+      return 1;
+    }
+    BenchmarkSuite::writeJson(fjson);
+  }
+
   return 0;
 }
@@ -104,3 +104,16 @@ BENCHMARK(GenerateEvasions, [](BenchmarkController& bc, bmstr_t data) {
   }
 })->args(BMSTR(DATA_X))
   ->args(BMSTR(DATA_Y));
+
+BENCHMARK(GenerateLegalMoves, [](BenchmarkController& bc, bmstr_t data) {
+  Position pos = PositionUtil::createPositionFromCsaString(data);
+
+  bc.start();
+  while(bc.cont()) {
+    Moves moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
+  }
+})->args(BMSTR(DATA_A))
+  ->args(BMSTR(DATA_B))
+  ->args(BMSTR(DATA_X))
+  ->args(BMSTR(DATA_Y));
@@ -4,6 +4,7 @@
  */
 
 #include "benchmark/Benchmark.hpp"
+#include "core/move/MoveGenerator.hpp"
 #include "core/util/PositionUtil.hpp"
 
 using namespace sunfish;
@@ -40,6 +41,21 @@ auto DATA_MATE_B =
   "P-\n"
   "+\n";
 
+auto DATA_MIDDLE_GAME =
+  "'-- DATA_MIDDLE_GAME --------\n"
+  "P1-KY-KE *  *  *  *  *  * -KY\n"
+  "P2 * -HI *  *  *  * -KI-OU * \n"
+  "P3 *  * -GI-FU-FU-KI-KE-GI * \n"
+  "P4-FU * -FU-KA *  * -FU-FU-FU\n"
+  "P5 * -FU *  *  * -FU *  *  * \n"
+  "P6+FU * +FU+FU+GI *  *  * +FU\n"
+  "P7 * +FU+GI+KI+FU+FU+FU+FU * \n"
+  "P8 *  * +KI+OU *  *  * +HI * \n"
+  "P9+KY+KE *  *  *  *  * +KE+KY\n"
+  "P+00KA\n"
+  "P-\n"
+  "+\n";
+
 }
 
 BENCHMARK(IsMate, [](BenchmarkController& bc, bmstr_t data) {
@@ -52,3 +68,48 @@ BENCHMARK(IsMate, [](BenchmarkController& bc, bmstr_t data) {
 })
 ->args(BMSTR(DATA_MATE_A))
 ->args(BMSTR(DATA_MATE_B));
+
+BENCHMARK(IsMateWithEffectBoard, [](BenchmarkController& bc, bmstr_t data) {
+  Position pos = PositionUtil::createPositionFromCsaString(data);
+  pos.enableEffectBoard();
+
+  bc.start();
+  while(bc.cont()) {
+    pos.isMate();
+  }
+})
+->args(BMSTR(DATA_MATE_A))
+->args(BMSTR(DATA_MATE_B));
+
+BENCHMARK(DoMove, [](BenchmarkController& bc, bmstr_t data) {
+  Position pos = PositionUtil::createPositionFromCsaString(data);
+  Moves moves;
+  MoveGenerator::generateLegalMoves(pos, moves);
+  Piece captured;
+
+  bc.start();
+  while(bc.cont()) {
+    for (auto& move : moves) {
+      pos.doMove(move, captured);
+      pos.undoMove(move, captured);
+    }
+  }
+})
+->args(BMSTR(DATA_MIDDLE_GAME));
+
+BENCHMARK(DoMoveWithEffectBoard, [](BenchmarkController& bc, bmstr_t data) {
+  Position pos = PositionUtil::createPositionFromCsaString(data);
+  pos.enableEffectBoard();
+  Moves moves;
+  MoveGenerator::generateLegalMoves(pos, moves);
+  Piece captured;
+
+  bc.start();
+  while(bc.cont()) {
+    for (auto& move : moves) {
+      pos.doMove(move, captured);
+      pos.undoMove(move, captured);
+    }
+  }
+})
+->args(BMSTR(DATA_MIDDLE_GAME));
@@ -21,6 +21,10 @@ public:
   BaseRandom(const BaseRandom&) = delete;
   BaseRandom(BaseRandom&&) = delete;
 
+  void seed(unsigned s) {
+    rgen.seed(s);
+  }
+
   uint16_t int16() {
     std::uniform_int_distribution<uint16_t> dst16;
     return dst16(rgen);
@@ -0,0 +1,165 @@
+/* UdpSocket.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "common/network/UdpSocket.hpp"
+#include "logger/Logger.hpp"
+#include <cstring>
+
+#if !defined(WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#endif
+
+namespace sunfish {
+
+UdpSocket::UdpSocket() : sock_(-1), port_(0) {
+}
+
+UdpSocket::~UdpSocket() {
+  close();
+}
+
+#if defined(WIN32)
+
+bool UdpSocket::open(int) {
+  LOG(error) << "UdpSocket is not supported on this platform";
+  return false;
+}
+
+void UdpSocket::close() {
+}
+
+bool UdpSocket::sendTo(const Address&, const void*, size_t) {
+  return false;
+}
+
+int UdpSocket::receive(void*, size_t, int, Address&) {
+  return -1;
+}
+
+bool UdpSocket::resolve(const std::string&, int, Address&) {
+  return false;
+}
+
+#else
+
+bool UdpSocket::open(int port) {
+  close();
+
+  sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock_ == -1) {
+    LOG(error) << "an error occured in socket function. (errno: " << errno << ")";
+    return false;
+  }
+  fcntl(sock_, F_SETFD, fcntl(sock_, F_GETFD) | FD_CLOEXEC);
+
+  struct sockaddr_in sin;
+  memset(&sin, 0, sizeof(sin));
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_ANY);
+  sin.sin_port = htons(static_cast<uint16_t>(port));
+  if (bind(sock_, reinterpret_cast<struct sockaddr*>(&sin), sizeof(sin)) == -1) {
+    LOG(error) << "an error occured in bind function. (port: " << port << ", errno: " << errno << ")";
+    close();
+    return false;
+  }
+
+  socklen_t length = sizeof(sin);
+  if (getsockname(sock_, reinterpret_cast<struct sockaddr*>(&sin), &length) == -1) {
+    LOG(error) << "an error occured in getsockname function. (errno: " << errno << ")";
+    close();
+    return false;
+  }
+  port_ = ntohs(sin.sin_port);
+
+  return true;
+}
+
+void UdpSocket::close() {
+  if (sock_ != -1) {
+    ::close(sock_);
+    sock_ = -1;
+  }
+}
+
+bool UdpSocket::sendTo(const Address& address, const void* data, size_t size) {
+  struct sockaddr_in sin;
+  memset(&sin, 0, sizeof(sin));
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = address.ip;
+  sin.sin_port = address.port;
+
+  for (;;) {
+    ssize_t sent = sendto(sock_, data, size, 0,
+                          reinterpret_cast<struct sockaddr*>(&sin), sizeof(sin));
+    if (sent != -1) {
+      return true;
+    }
+    if (errno != EINTR) {
+      // a datagram may be lost at any time, so it is not an error.
+      return false;
+    }
+  }
+}
+
+int UdpSocket::receive(void* buffer, size_t size, int timeoutMs, Address& source) {
+  struct pollfd pfd;
+  pfd.fd = sock_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  int ret = poll(&pfd, 1, timeoutMs);
+  if (ret == 0 || (ret == -1 && errno == EINTR)) {
+    return 0;
+  }
+  if (ret == -1) {
+    LOG(error) << "an error occured in poll function. (errno: " << errno << ")";
+    return -1;
+  }
+
+  struct sockaddr_in sin;
+  socklen_t length = sizeof(sin);
+  memset(&sin, 0, sizeof(sin));
+  ssize_t received = recvfrom(sock_, buffer, size, 0,
+                              reinterpret_cast<struct sockaddr*>(&sin), &length);
+  if (received == -1) {
+    // ECONNREFUSED is reported when a peer has not opened its port yet.
+    return errno == EINTR || errno == EAGAIN || errno == ECONNREFUSED ? 0 : -1;
+  }
+  source.ip = sin.sin_addr.s_addr;
+  source.port = sin.sin_port;
+  return static_cast<int>(received);
+}
+
+bool UdpSocket::resolve(const std::string& host, int port, Address& address) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+
+  struct addrinfo* result;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr) {
+    LOG(error) << "could not resolve the host: " << host;
+    return false;
+  }
+
+  auto sin = reinterpret_cast<struct sockaddr_in*>(result->ai_addr);
+  address.ip = sin->sin_addr.s_addr;
+  address.port = htons(static_cast<uint16_t>(port));
+  freeaddrinfo(result);
+
+  return true;
+}
+
+#endif
+
+} // namespace sunfish
@@ -0,0 +1,78 @@
+/* UdpSocket.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_COMMON_NETWORK_UDPSOCKET_HPP__
+#define SUNFISH_COMMON_NETWORK_UDPSOCKET_HPP__
+
+#include "common/Def.hpp"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * UdpSocket sends and receives datagrams over IPv4.
+ */
+class UdpSocket {
+public:
+
+  struct Address {
+    /** in network byte order */
+    uint32_t ip;
+    /** in network byte order */
+    uint16_t port;
+  };
+
+  UdpSocket();
+  UdpSocket(const UdpSocket&) = delete;
+  UdpSocket(UdpSocket&&) = delete;
+
+  ~UdpSocket();
+
+  /**
+   * Open a socket bound to the specified port of all interfaces.
+   * If the port is 0, a free port is assigned. (see getPort)
+   */
+  bool open(int port);
+
+  void close();
+
+  bool isOpen() const {
+    return sock_ != -1;
+  }
+
+  int getPort() const {
+    return port_;
+  }
+
+  bool sendTo(const Address& address, const void* data, size_t size);
+
+  /**
+   * Receive a datagram.
+   * Returns the size of the datagram, 0 if the timeout expired or -1 on error.
+   */
+  int receive(void* buffer, size_t size, int timeoutMs) {
+    Address source;
+    return receive(buffer, size, timeoutMs, source);
+  }
+
+  /**
+   * Receive a datagram and the address of its sender.
+   */
+  int receive(void* buffer, size_t size, int timeoutMs, Address& source);
+
+  static bool resolve(const std::string& host, int port, Address& address);
+
+private:
+
+  int sock_;
+  int port_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_COMMON_NETWORK_UDPSOCKET_HPP__
@@ -0,0 +1,249 @@
+/* ChildProcess.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "common/process/ChildProcess.hpp"
+#include "logger/Logger.hpp"
+#include <chrono>
+#include <thread>
+
+#if !defined(WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+#if !defined(WIN32)
+/**
+ * create a pipe whose both ends are closed on exec,
+ * so that the other child processes do not inherit them.
+ */
+bool createPipe(int fds[2]) {
+#if defined(__linux__)
+  return pipe2(fds, O_CLOEXEC) == 0;
+#else
+  // pipe2 is unavailable.
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, fcntl(fds[0], F_GETFD) | FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, fcntl(fds[1], F_GETFD) | FD_CLOEXEC);
+  return true;
+#endif
+}
+#endif
+
+} // namespace
+
+namespace sunfish {
+
+ChildProcess::ChildProcess() : pid_(-1), inFd_(-1), outFd_(-1) {
+}
+
+ChildProcess::~ChildProcess() {
+  stop();
+}
+
+#if defined(WIN32)
+
+bool ChildProcess::start(const std::string&, const std::vector<std::string>&) {
+  LOG(error) << "ChildProcess is not supported on this platform";
+  return false;
+}
+
+bool ChildProcess::writeLine(const std::string&) {
+  return false;
+}
+
+bool ChildProcess::readLine(std::string&, int) {
+  return false;
+}
+
+void ChildProcess::stop(int) {
+}
+
+#else
+
+bool ChildProcess::start(const std::string& path,
+                         const std::vector<std::string>& args) {
+  stop();
+
+  // a write to the exited process must not kill this process.
+  signal(SIGPIPE, SIG_IGN);
+
+  int inPipe[2];
+  int outPipe[2];
+  if (!createPipe(inPipe)) {
+    LOG(error) << "pipe() failed: " << errno;
+    return false;
+  }
+  if (!createPipe(outPipe)) {
+    LOG(error) << "pipe() failed: " << errno;
+    close(inPipe[0]);
+    close(inPipe[1]);
+    return false;
+  }
+
+  // the arguments are built before fork,
+  // because the child must not allocate memory.
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(path.c_str()));
+  for (const auto& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid == -1) {
+    LOG(error) << "fork() failed: " << errno;
+    close(inPipe[0]);
+    close(inPipe[1]);
+    close(outPipe[0]);
+    close(outPipe[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    // the descriptors duplicated by dup2 are not closed on exec.
+    dup2(inPipe[0], STDIN_FILENO);
+    dup2(outPipe[1], STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull != -1) {
+      dup2(devNull, STDERR_FILENO);
+      close(devNull);
+    }
+    close(inPipe[0]);
+    close(outPipe[1]);
+    execv(path.c_str(), argv.data());
+    _exit(127);
+  }
+
+  close(inPipe[0]);
+  close(outPipe[1]);
+  pid_ = pid;
+  inFd_ = inPipe[1];
+  outFd_ = outPipe[0];
+  buffer_.clear();
+
+  return true;
+}
+
+bool ChildProcess::writeLine(const std::string& line) {
+  if (!isRunning()) {
+    return false;
+  }
+
+  std::string data = line + '\n';
+  size_t offset = 0;
+  while (offset < data.size()) {
+    ssize_t n = write(inFd_, data.c_str() + offset, data.size() - offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    offset += n;
+  }
+  return true;
+}
+
+bool ChildProcess::readLine(std::string& line, int timeoutMs) {
+  if (!isRunning()) {
+    return false;
+  }
+
+  auto deadline = std::chrono::steady_clock::now()
+                + std::chrono::milliseconds(timeoutMs);
+
+  for (;;) {
+    auto pos = buffer_.find('\n');
+    if (pos != std::string::npos) {
+      line = buffer_.substr(0, pos);
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      buffer_.erase(0, pos + 1);
+      return true;
+    }
+
+    int waitMs = -1;
+    if (timeoutMs != InfinityTime) {
+      auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now()).count();
+      if (remaining <= 0) {
+        return false;
+      }
+      waitMs = static_cast<int>(remaining);
+    }
+
+    struct pollfd pfd;
+    pfd.fd = outFd_;
+    pfd.events = POLLIN;
+    int ret = poll(&pfd, 1, waitMs);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (ret == 0) {
+      return false;
+    }
+
+    char buf[4096];
+    ssize_t n = read(outFd_, buf, sizeof(buf));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      // end of file
+      return false;
+    }
+    buffer_.append(buf, n);
+  }
+}
+
+void ChildProcess::stop(int timeoutMs) {
+  if (!isRunning()) {
+    return;
+  }
+
+  // the standard input is closed, so that the program can detect EOF.
+  close(inFd_);
+  close(outFd_);
+  inFd_ = -1;
+  outFd_ = -1;
+
+  auto deadline = std::chrono::steady_clock::now()
+                + std::chrono::milliseconds(timeoutMs);
+  for (;;) {
+    int status;
+    pid_t ret = waitpid(pid_, &status, WNOHANG);
+    if (ret != 0) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      kill(pid_, SIGKILL);
+      waitpid(pid_, &status, 0);
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  pid_ = -1;
+}
+
+#endif
+
+} // namespace sunfish
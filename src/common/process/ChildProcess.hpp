@@ -0,0 +1,63 @@
+/* ChildProcess.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_COMMON_PROCESS_CHILDPROCESS_HPP__
+#define SUNFISH_COMMON_PROCESS_CHILDPROCESS_HPP__
+
+#include "common/Def.hpp"
+#include <string>
+#include <vector>
+
+namespace sunfish {
+
+/**
+ * ChildProcess runs an external program and talks to it
+ * line by line through its standard input and output.
+ * The standard error of the program is discarded.
+ */
+class ChildProcess {
+public:
+
+  static CONSTEXPR_CONST int InfinityTime = -1;
+
+  ChildProcess();
+  ChildProcess(const ChildProcess&) = delete;
+  ChildProcess(ChildProcess&&) = delete;
+
+  ~ChildProcess();
+
+  bool start(const std::string& path,
+             const std::vector<std::string>& args = {});
+
+  bool isRunning() const {
+    return pid_ != -1;
+  }
+
+  bool writeLine(const std::string& line);
+
+  /**
+   * Read a line without the line break.
+   * Returns false if the process exited or the timeout expired.
+   */
+  bool readLine(std::string& line, int timeoutMs = InfinityTime);
+
+  /**
+   * Wait for the exit of the process up to the specified time,
+   * and kill it if it is still running.
+   */
+  void stop(int timeoutMs = 1000);
+
+private:
+
+  int pid_;
+  int inFd_;
+  int outFd_;
+  std::string buffer_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_COMMON_PROCESS_CHILDPROCESS_HPP__
@@ -18,12 +18,7 @@ public:
   }
 
   ~ScopedThread() {
-    if (thread_.joinable()) {
-      if (stop_) {
-        stop_();
-      }
-      thread_.join();
-    }
+    stop();
   }
 
   template <class T, class U>
@@ -33,6 +28,15 @@ public:
     stop_ = std::forward<U>(stop);
   }
 
+  void stop() {
+    if (thread_.joinable()) {
+      if (stop_) {
+        stop_();
+      }
+      thread_.join();
+    }
+  }
+
 private:
 
   std::thread thread_;
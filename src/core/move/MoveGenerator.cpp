@@ -6,12 +6,39 @@
 #include "core/move/MoveGenerator.hpp"
 #include "core/move/MoveTables.hpp"
 
+namespace {
+
+using namespace sunfish;
+
+/**
+ * Get the squares to which the pinned piece can move.
+ */
+Bitboard pinLine(const Square& kingSquare, const Square& from) {
+  switch (kingSquare.dir(from)) {
+  case Direction::Up       : return MoveTables::up(Bitboard::zero(), kingSquare);
+  case Direction::Down     : return MoveTables::down(Bitboard::zero(), kingSquare);
+  case Direction::Left     : return MoveTables::left(RotatedBitboard::zero(), kingSquare);
+  case Direction::Right    : return MoveTables::right(RotatedBitboard::zero(), kingSquare);
+  case Direction::LeftUp   : return MoveTables::leftUp45(RotatedBitboard::zero(), kingSquare);
+  case Direction::LeftDown : return MoveTables::leftDown45(RotatedBitboard::zero(), kingSquare);
+  case Direction::RightUp  : return MoveTables::rightUp45(RotatedBitboard::zero(), kingSquare);
+  case Direction::RightDown: return MoveTables::rightDown45(RotatedBitboard::zero(), kingSquare);
+  default                  : return Bitboard::zero();
+  }
+}
+
+} // namespace
+
 namespace sunfish {
 
-template <Turn turn, MoveGenerator::GenerationType type, bool exceptKing>
-void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, const Bitboard& mask) {
+template <Turn turn, MoveGenerator::GenerationType type, bool exceptKing, bool legal, class MovesType>
+void MoveGenerator::generateMovesOnBoard(const Position& pos, MovesType& moves, const Bitboard& mask) {
   auto occ = pos.getBOccupiedBitboard() | pos.getWOccupiedBitboard();
 
+  // pinned pieces can move only along the line between the king and the pinning piece.
+  auto kingSquare = turn == Turn::Black ? pos.getBlackKingSquare() : pos.getWhiteKingSquare();
+  auto pinned = legal ? pos.getPinnedBitboard() : Bitboard::zero();
+
   auto notSelfOcc = turn == Turn::Black ? ~pos.getBOccupiedBitboard() : ~pos.getWOccupiedBitboard();
   auto cap = turn == Turn::Black ? pos.getWOccupiedBitboard() : pos.getBOccupiedBitboard();
   auto prom = turn == Turn::Black ? Bitboard::blackPromotable() : Bitboard::whitePromotable();
@@ -33,6 +60,9 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
 
     BB_EACH(from, fbb) {
       Square to = turn == Turn::Black ? from.up() : from.down();
+      if (legal && pinned.check(from) && !pinLine(kingSquare, from).check(to)) {
+        continue;
+      }
       moves.add(Move(from, to, to.isPromotable<turn>()));
     }
   }
@@ -52,6 +82,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         if (from.isPromotable<turn>() || to.isPromotable<turn>()) {
           moves.add(Move(from, to, true));
@@ -78,6 +112,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         moves.add(Move(from, to, false));
       }
@@ -96,6 +134,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
       tbb &= mask;
     }
 
+    if (legal) {
+      tbb = pos.extractKingSafeSquares(tbb);
+    }
+
     BB_EACH(to, tbb) {
       moves.add(Move(from, to, false));
     }
@@ -119,6 +161,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         if (type == GenerationType::Capture || type == GenerationType::All) {
           auto promotable = from.isPromotable<turn>() || to.isPromotable<turn>();
@@ -146,6 +192,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         moves.add(Move(from, to, false));
       }
@@ -170,6 +220,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         if (type == GenerationType::Capture || type == GenerationType::All) {
           auto promotable = from.isPromotable<turn>() || to.isPromotable<turn>();
@@ -197,6 +251,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         moves.add(Move(from, to, false));
       }
@@ -223,6 +281,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         if (to.isPromotable<turn>()) {
           if (type == GenerationType::Capture) {
@@ -261,6 +323,10 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
         tbb &= mask;
       }
 
+      if (legal && pinned.check(from)) {
+        tbb &= pinLine(kingSquare, from);
+      }
+
       BB_EACH(to, tbb) {
         if (to.isPromotable<turn>()) {
           if (type == GenerationType::Capture) {
@@ -284,13 +350,25 @@ void MoveGenerator::generateMovesOnBoard(const Position& pos, Moves& moves, cons
     }
   }
 }
-template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Capture, false>(const Position&, Moves&, const Bitboard&);
-template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Capture, false>(const Position&, Moves&, const Bitboard&);
-template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Quiet, false>(const Position&, Moves&, const Bitboard&);
-template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Quiet, false>(const Position&, Moves&, const Bitboard&);
-
-template <Turn turn>
-void MoveGenerator::generateDrops(const Position& pos, Moves& moves, const Bitboard& mask) {
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Capture, false, false, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Capture, false, false, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Capture, false, false, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Capture, false, false, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Quiet, false, false, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Quiet, false, false, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Quiet, false, false, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Quiet, false, false, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Capture, false, true, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Capture, false, true, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Capture, false, true, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Capture, false, true, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Quiet, false, true, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::Black, MoveGenerator::GenerationType::Quiet, false, true, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Quiet, false, true, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateMovesOnBoard<Turn::White, MoveGenerator::GenerationType::Quiet, false, true, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+
+template <Turn turn, class MovesType>
+void MoveGenerator::generateDrops(const Position& pos, MovesType& moves, const Bitboard& mask) {
   PieceType pieces[6];
   int kn = 0;
   int ln = 0;
@@ -372,11 +450,13 @@ void MoveGenerator::generateDrops(const Position& pos, Moves& moves, const Bitbo
     }
   }
 }
-template void MoveGenerator::generateDrops<Turn::Black>(const Position&, Moves&, const Bitboard&);
-template void MoveGenerator::generateDrops<Turn::White>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateDrops<Turn::Black, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateDrops<Turn::Black, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
+template void MoveGenerator::generateDrops<Turn::White, Moves>(const Position&, Moves&, const Bitboard&);
+template void MoveGenerator::generateDrops<Turn::White, MoveSlice>(const Position&, MoveSlice&, const Bitboard&);
 
-template <Turn turn>
-void MoveGenerator::generateEvasions(const Position& pos, CheckState checkState, Moves& moves) {
+template <Turn turn, bool legal, class MovesType>
+void MoveGenerator::generateEvasions(const Position& pos, CheckState checkState, MovesType& moves) {
   ASSERT(isCheck(checkState));
 
   auto kingSquare = turn == Turn::Black ? pos.getBlackKingSquare() : pos.getWhiteKingSquare();
@@ -392,7 +472,7 @@ void MoveGenerator::generateEvasions(const Position& pos, CheckState checkState,
       generateDrops<turn>(pos, moves, tbb);
     }
 
-    generateMovesOnBoard<turn, GenerationType::All, true>(pos, moves, tbb);
+    generateMovesOnBoard<turn, GenerationType::All, true, legal>(pos, moves, tbb);
   }
 
   auto tbb = MoveTables::king(kingSquare);
@@ -402,11 +482,21 @@ void MoveGenerator::generateEvasions(const Position& pos, CheckState checkState,
     tbb = pos.getWOccupiedBitboard().andNot(tbb);
   }
 
+  if (legal) {
+    tbb = pos.extractKingSafeSquares(tbb);
+  }
+
   BB_EACH(to, tbb) {
     moves.add(Move(kingSquare, to, false));
   }
 }
-template void MoveGenerator::generateEvasions<Turn::Black>(const Position&, CheckState, Moves&);
-template void MoveGenerator::generateEvasions<Turn::White>(const Position&, CheckState, Moves&);
+template void MoveGenerator::generateEvasions<Turn::Black, false, Moves>(const Position&, CheckState, Moves&);
+template void MoveGenerator::generateEvasions<Turn::Black, false, MoveSlice>(const Position&, CheckState, MoveSlice&);
+template void MoveGenerator::generateEvasions<Turn::White, false, Moves>(const Position&, CheckState, Moves&);
+template void MoveGenerator::generateEvasions<Turn::White, false, MoveSlice>(const Position&, CheckState, MoveSlice&);
+template void MoveGenerator::generateEvasions<Turn::Black, true, Moves>(const Position&, CheckState, Moves&);
+template void MoveGenerator::generateEvasions<Turn::Black, true, MoveSlice>(const Position&, CheckState, MoveSlice&);
+template void MoveGenerator::generateEvasions<Turn::White, true, Moves>(const Position&, CheckState, Moves&);
+template void MoveGenerator::generateEvasions<Turn::White, true, MoveSlice>(const Position&, CheckState, MoveSlice&);
 
 } // namespace sunfish
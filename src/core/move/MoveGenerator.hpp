@@ -18,12 +18,13 @@ public:
    * Generate capturing moves.
    * The result includes the illegal moves which leave check.
    */
-  static void generateCaptures(const Position& pos, Moves& moves) {
+  template <class MovesType>
+  static void generateCaptures(const Position& pos, MovesType& moves) {
     ASSERT(!pos.inCheck());
     if (pos.getTurn() == Turn::Black) {
-      generateMovesOnBoard<Turn::Black, GenerationType::Capture, false>(pos, moves, Bitboard::full());
+      generateMovesOnBoard<Turn::Black, GenerationType::Capture, false, false>(pos, moves, Bitboard::full());
     } else {
-      generateMovesOnBoard<Turn::White, GenerationType::Capture, false>(pos, moves, Bitboard::full());
+      generateMovesOnBoard<Turn::White, GenerationType::Capture, false, false>(pos, moves, Bitboard::full());
     }
   }
 
@@ -31,13 +32,14 @@ public:
    * Generate not-capturing moves.
    * The result includes the illegal moves which leave check.
    */
-  static void generateQuiets(const Position& pos, Moves& moves) {
+  template <class MovesType>
+  static void generateQuiets(const Position& pos, MovesType& moves) {
     ASSERT(!pos.inCheck());
     if (pos.getTurn() == Turn::Black) {
-      generateMovesOnBoard<Turn::Black, GenerationType::Quiet, false>(pos, moves, Bitboard::full());
+      generateMovesOnBoard<Turn::Black, GenerationType::Quiet, false, false>(pos, moves, Bitboard::full());
       generateDrops<Turn::Black>(pos, moves, Bitboard::full());
     } else {
-      generateMovesOnBoard<Turn::White, GenerationType::Quiet, false>(pos, moves, Bitboard::full());
+      generateMovesOnBoard<Turn::White, GenerationType::Quiet, false, false>(pos, moves, Bitboard::full());
       generateDrops<Turn::White>(pos, moves, Bitboard::full());
     }
   }
@@ -46,12 +48,71 @@ public:
    * Generate evasions.
    * The result includes the illegal moves which leave check.
    */
-  static void generateEvasions(const Position& pos, CheckState checkState, Moves& moves) {
+  template <class MovesType>
+  static void generateEvasions(const Position& pos, CheckState checkState, MovesType& moves) {
     ASSERT(pos.inCheck());
     if (pos.getTurn() == Turn::Black) {
-      generateEvasions<Turn::Black>(pos, checkState, moves);
+      generateEvasions<Turn::Black, false>(pos, checkState, moves);
     } else {
-      generateEvasions<Turn::White>(pos, checkState, moves);
+      generateEvasions<Turn::White, false>(pos, checkState, moves);
+    }
+  }
+
+  /**
+   * Generate legal capturing moves.
+   * The result doesn't include the illegal moves.
+   */
+  template <class MovesType>
+  static void generateLegalCaptures(const Position& pos, MovesType& moves) {
+    ASSERT(!pos.inCheck());
+    if (pos.getTurn() == Turn::Black) {
+      generateMovesOnBoard<Turn::Black, GenerationType::Capture, false, true>(pos, moves, Bitboard::full());
+    } else {
+      generateMovesOnBoard<Turn::White, GenerationType::Capture, false, true>(pos, moves, Bitboard::full());
+    }
+  }
+
+  /**
+   * Generate legal not-capturing moves.
+   * The result doesn't include the illegal moves.
+   */
+  template <class MovesType>
+  static void generateLegalQuiets(const Position& pos, MovesType& moves) {
+    ASSERT(!pos.inCheck());
+    if (pos.getTurn() == Turn::Black) {
+      generateMovesOnBoard<Turn::Black, GenerationType::Quiet, false, true>(pos, moves, Bitboard::full());
+      generateDrops<Turn::Black>(pos, moves, Bitboard::full());
+    } else {
+      generateMovesOnBoard<Turn::White, GenerationType::Quiet, false, true>(pos, moves, Bitboard::full());
+      generateDrops<Turn::White>(pos, moves, Bitboard::full());
+    }
+  }
+
+  /**
+   * Generate legal evasions.
+   * The result doesn't include the illegal moves.
+   */
+  template <class MovesType>
+  static void generateLegalEvasions(const Position& pos, CheckState checkState, MovesType& moves) {
+    ASSERT(pos.inCheck());
+    if (pos.getTurn() == Turn::Black) {
+      generateEvasions<Turn::Black, true>(pos, checkState, moves);
+    } else {
+      generateEvasions<Turn::White, true>(pos, checkState, moves);
+    }
+  }
+
+  /**
+   * Generate all legal moves.
+   */
+  template <class MovesType>
+  static void generateLegalMoves(const Position& pos, MovesType& moves) {
+    CheckState checkState = pos.getCheckState();
+    if (!isCheck(checkState)) {
+      generateLegalCaptures(pos, moves);
+      generateLegalQuiets(pos, moves);
+    } else {
+      generateLegalEvasions(pos, checkState, moves);
     }
   }
 
@@ -65,14 +126,14 @@ private:
     All,
   };
 
-  template <Turn turn, GenerationType type, bool exceptKing>
-  static void generateMovesOnBoard(const Position& pos, Moves& moves, const Bitboard& mask);
+  template <Turn turn, GenerationType type, bool exceptKing, bool legal, class MovesType>
+  static void generateMovesOnBoard(const Position& pos, MovesType& moves, const Bitboard& mask);
 
-  template <Turn turn>
-  static void generateDrops(const Position& pos, Moves& moves, const Bitboard& mask);
+  template <Turn turn, class MovesType>
+  static void generateDrops(const Position& pos, MovesType& moves, const Bitboard& mask);
 
-  template <Turn turn>
-  static void generateEvasions(const Position& pos, CheckState checkState, Moves& moves);
+  template <Turn turn, bool legal, class MovesType>
+  static void generateEvasions(const Position& pos, CheckState checkState, MovesType& moves);
 
 };
 
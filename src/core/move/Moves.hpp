@@ -10,6 +10,7 @@
 #include "core/move/Move.hpp"
 #include "core/position/Position.hpp"
 #include <array>
+#include <cstddef>
 #include <sstream>
 #include <cstdint>
 
@@ -216,6 +217,136 @@ private:
 
 using Moves = MoveArray<MAX_NUMBER_OF_MOVES>;
 
+/**
+ * A list of moves stored in a buffer owned by another object.
+ * The caller must guarantee that enough space follows the beginning.
+ */
+class MoveSlice {
+public:
+
+  using value_type = Move;
+  using size_type = uint32_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = Move&;
+  using const_reference = const Move&;
+  using pointer = Move*;
+  using const_pointer = const Move*;
+  using iterator = Move*;
+  using const_iterator = const Move*;
+
+  /**
+   * Default constructor
+   */
+  MoveSlice() : begin_(nullptr), size_(0) {
+  }
+
+  /**
+   * Set the beginning of the buffer and clear the contents.
+   */
+  void reset(iterator begin) {
+    begin_ = begin;
+    size_ = 0;
+  }
+
+  /**
+   * Clear the contents.
+   */
+  void clear() {
+    size_ = 0;
+  }
+
+  /**
+   * Return the number of moves.
+   */
+  size_type size() const {
+    return size_;
+  }
+
+  /**
+   * Add a move to the end.
+   */
+  void add(const value_type& move) {
+    begin_[size_++] = move;
+  }
+
+  /**
+   * Remove specified move.
+   */
+  iterator remove(iterator ite) {
+    (*ite) = begin_[--size_];
+    return ite;
+  }
+
+  /**
+   * Remove specified move and moves after it.
+   */
+  void removeAfter(iterator ite) {
+    size_ = (size_type)(ite - begin_);
+  }
+
+  /**
+   * Access specified move.
+   */
+  value_type& operator[](size_type index) {
+    return begin_[index];
+  }
+
+  /**
+   * Access specified move.
+   */
+  const value_type& operator[](size_type index) const {
+    return begin_[index];
+  }
+
+  /**
+   * Return an iterator to the begining.
+   */
+  iterator begin() {
+    return begin_;
+  }
+
+  /**
+   * Return an iterator to the begining.
+   */
+  const_iterator begin() const {
+    return begin_;
+  }
+
+  /**
+   * Return an iterator to the begining.
+   */
+  const_iterator cbegin() const {
+    return begin_;
+  }
+
+  /**
+   * Return an iterator to the end.
+   */
+  iterator end() {
+    return begin_ + size_;
+  }
+
+  /**
+   * Return an iterator to the end.
+   */
+  const_iterator end() const {
+    return begin_ + size_;
+  }
+
+  /**
+   * Return an iterator to the end.
+   */
+  const_iterator cend() const {
+    return begin_ + size_;
+  }
+
+private:
+
+  iterator begin_;
+  size_type size_;
+
+};
+
 inline void remove(Moves& moves,
                    Moves::iterator begin,
                    const Move& move) {
@@ -241,6 +372,19 @@ inline void remove(Moves& moves,
   }
 }
 
+template <class T>
+inline void remove(MoveSlice& moves,
+                   MoveSlice::iterator begin,
+                   T&& f) {
+  for (auto ite = begin; ite != moves.end();) {
+    if (f(*ite)) {
+      ite = moves.remove(ite);
+    } else {
+      ite++;
+    }
+  }
+}
+
 void sortMovesForDebug(Moves& moves, const Position& position);
 
 } // namespace sunfish
@@ -0,0 +1,112 @@
+/* EffectBoard.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "core/position/EffectBoard.hpp"
+#include "core/move/MoveTables.hpp"
+
+namespace {
+
+using namespace sunfish;
+
+/**
+ * the adjacent square of each square in each direction. (-1: out of the board)
+ */
+struct NeighborTable {
+  int8_t squares[static_cast<int>(Direction::End)][Square::N];
+
+  NeighborTable() {
+    DIR_EACH(dir) {
+      SQUARE_EACH(square) {
+        squares[static_cast<int>(dir)][square.raw()] = static_cast<int8_t>(square.safetyMove(dir).raw());
+      }
+    }
+  }
+
+  int8_t get(int square, Direction dir) const {
+    return squares[static_cast<int>(dir)][square];
+  }
+};
+
+const NeighborTable Neighbor;
+
+} // namespace
+
+namespace sunfish {
+
+void EffectBoard::initialize(const BoardArrayType& board) {
+  for (auto& counts : counts_) {
+    counts.fill(0);
+  }
+  for (auto& longEffects : longEffects_) {
+    longEffects.fill(0);
+  }
+
+  SQUARE_EACH(square) {
+    auto piece = board[square.raw()];
+    if (!piece.isEmpty()) {
+      addPiece(board, square, piece);
+    }
+  }
+}
+
+template <bool add>
+void EffectBoard::updatePiece(const BoardArrayType& board, const Square& square, const Piece& piece) {
+  int t = piece.isBlack() ? 0 : 1;
+
+  DIR_EACH(dir) {
+    if (MoveTables::isMovableInLongStep(piece, dir)) {
+      updateRay<add>(board, t, square, dir);
+    } else if (MoveTables::isMovableInOneStep(piece, dir)) {
+      int to = Neighbor.get(square.raw(), dir);
+      if (to >= 0) {
+        if (add) {
+          counts_[t][to]++;
+        } else {
+          counts_[t][to]--;
+        }
+      }
+    }
+  }
+}
+template void EffectBoard::updatePiece<true>(const BoardArrayType&, const Square&, const Piece&);
+template void EffectBoard::updatePiece<false>(const BoardArrayType&, const Square&, const Piece&);
+
+template <bool add>
+void EffectBoard::updateThrough(const BoardArrayType& board, const Square& square) {
+  for (int t = 0; t < 2; t++) {
+    DirectionSet dirs = longEffects_[t][square.raw()];
+    if (dirs == 0) {
+      continue;
+    }
+
+    DIR_EACH_S(dir) {
+      if (dirs & bit(dir)) {
+        updateRay<add>(board, t, square, dir);
+      }
+    }
+  }
+}
+template void EffectBoard::updateThrough<true>(const BoardArrayType&, const Square&);
+template void EffectBoard::updateThrough<false>(const BoardArrayType&, const Square&);
+
+template <bool add>
+void EffectBoard::updateRay(const BoardArrayType& board, int t, Square square, Direction dir) {
+  DirectionSet b = bit(dir);
+  for (int sq = Neighbor.get(square.raw(), dir); sq >= 0; sq = Neighbor.get(sq, dir)) {
+    if (add) {
+      counts_[t][sq]++;
+      longEffects_[t][sq] |= b;
+    } else {
+      counts_[t][sq]--;
+      longEffects_[t][sq] &= ~b;
+    }
+
+    if (!board[sq].isEmpty()) {
+      break;
+    }
+  }
+}
+
+} // namespace sunfish
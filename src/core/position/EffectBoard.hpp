@@ -0,0 +1,123 @@
+/* EffectBoard.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_CORE_POSITION_EFFECTBOARD_HPP__
+#define SUNFISH_CORE_POSITION_EFFECTBOARD_HPP__
+
+#include "core/base/Turn.hpp"
+#include "core/base/Piece.hpp"
+#include "core/base/Square.hpp"
+#include <array>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * EffectBoard holds the number of pieces which have effects on each
+ * square for each side, and the directions of the long effects which
+ * reach each square.
+ * The bit (1 << dir) of getLongEffects() means that the effect goes
+ * toward the direction dir, that is, the piece is on the opposite side.
+ * All operations except initialize() are incremental;
+ * Position calls them in doMove and undoMove.
+ */
+class EffectBoard {
+public:
+
+  using BoardArrayType = std::array<Piece, Square::N>;
+  using CountType = uint8_t;
+  using DirectionSet = uint8_t;
+
+  void initialize(const BoardArrayType& board);
+
+  /**
+   * Add the effects of the piece on the square.
+   */
+  void addPiece(const BoardArrayType& board, const Square& square, const Piece& piece) {
+    updatePiece<true>(board, square, piece);
+  }
+
+  /**
+   * Remove the effects of the piece on the square.
+   */
+  void removePiece(const BoardArrayType& board, const Square& square, const Piece& piece) {
+    updatePiece<false>(board, square, piece);
+  }
+
+  /**
+   * Cut the long effects which pass through the square
+   * because a piece is put on it.
+   */
+  void cut(const BoardArrayType& board, const Square& square) {
+    updateThrough<false>(board, square);
+  }
+
+  /**
+   * Extend the long effects which stopped at the square
+   * because the square becomes empty.
+   */
+  void extend(const BoardArrayType& board, const Square& square) {
+    updateThrough<true>(board, square);
+  }
+
+  int getCount(Turn turn, const Square& square) const {
+    return counts_[turnIndex(turn)][square.raw()];
+  }
+
+  int getBlackCount(const Square& square) const {
+    return counts_[0][square.raw()];
+  }
+
+  int getWhiteCount(const Square& square) const {
+    return counts_[1][square.raw()];
+  }
+
+  DirectionSet getLongEffects(Turn turn, const Square& square) const {
+    return longEffects_[turnIndex(turn)][square.raw()];
+  }
+
+  /**
+   * Indicate whether the long effect of the turn reaches the square
+   * toward the specified direction.
+   */
+  bool hasLongEffect(Turn turn, const Square& square, Direction dir) const {
+    return getLongEffects(turn, square) & bit(dir);
+  }
+
+  bool operator==(const EffectBoard& rhs) const {
+    return counts_ == rhs.counts_ && longEffects_ == rhs.longEffects_;
+  }
+
+  bool operator!=(const EffectBoard& rhs) const {
+    return !operator==(rhs);
+  }
+
+private:
+
+  static int turnIndex(Turn turn) {
+    return turn == Turn::Black ? 0 : 1;
+  }
+
+  static DirectionSet bit(Direction dir) {
+    return static_cast<DirectionSet>(1 << static_cast<int32_t>(dir));
+  }
+
+  template <bool add>
+  void updatePiece(const BoardArrayType& board, const Square& square, const Piece& piece);
+
+  template <bool add>
+  void updateThrough(const BoardArrayType& board, const Square& square);
+
+  template <bool add>
+  void updateRay(const BoardArrayType& board, int t, Square square, Direction dir);
+
+  std::array<std::array<CountType, Square::N>, 2> counts_;
+  std::array<std::array<DirectionSet, Square::N>, 2> longEffects_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_CORE_POSITION_EFFECTBOARD_HPP__
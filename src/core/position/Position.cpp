@@ -447,6 +447,10 @@ void Position::onChanged() {
       }
     }
   }
+
+  if (effectBoardEnabled_) {
+    effectBoard_.initialize(board_);
+  }
 }
 
 MutablePosition Position::getMutablePosition() const {
@@ -632,6 +636,10 @@ bool Position::doMove(Move move, Piece& wbCaptured) {
     Piece piece = turn == Turn::Black ? pieceType.black() : pieceType.white();
     captured = Piece::empty();
 
+    if (effectBoardEnabled_) {
+      doMoveOnEffectBoard(Square::invalid(), to, piece, piece, captured);
+    }
+
     // update piece number array
     board_[to.raw()] = piece;
 
@@ -681,6 +689,10 @@ bool Position::doMove(Move move, Piece& wbCaptured) {
 
       Piece pieceAfter = move.isPromotion() ? piece.promote() : piece;
 
+      if (effectBoardEnabled_) {
+        doMoveOnEffectBoard(from, to, piece, pieceAfter, captured);
+      }
+
       // update piece number array
       board_[from.raw()] = Piece::empty();
       board_[to.raw()] = pieceAfter;
@@ -730,6 +742,10 @@ bool Position::doMove(Move move, Piece& wbCaptured) {
     } else {
       Piece pieceAfter = move.isPromotion() ? piece.promote() : piece;
 
+      if (effectBoardEnabled_) {
+        doMoveOnEffectBoard(from, to, piece, pieceAfter, captured);
+      }
+
       // update piece number array
       board_[from.raw()] = Piece::empty();
       board_[to.raw()] = pieceAfter;
@@ -801,6 +817,10 @@ void Position::undoMove(Move move, Piece captured) {
     PieceType pieceType = move.droppingPieceType();
     Piece piece = turn == Turn::Black ? pieceType.black() : pieceType.white();
 
+    if (effectBoardEnabled_) {
+      undoMoveOnEffectBoard(Square::invalid(), to, piece, piece, captured);
+    }
+
     // update piece number array
     board_[to.raw()] = Piece::empty();
 
@@ -849,6 +869,10 @@ void Position::undoMove(Move move, Piece captured) {
         whiteHand_.decUnsafe(handType);
       }
 
+      if (effectBoardEnabled_) {
+        undoMoveOnEffectBoard(from, to, piece, pieceAfter, captured);
+      }
+
       // update piece number array
       board_[from.raw()] = piece;
       board_[to.raw()] = captured;
@@ -898,6 +922,10 @@ void Position::undoMove(Move move, Piece captured) {
     } else {
       Piece pieceAfter = board_[to.raw()];
 
+      if (effectBoardEnabled_) {
+        undoMoveOnEffectBoard(from, to, piece, pieceAfter, captured);
+      }
+
       // update piece number array
       board_[from.raw()] = piece;
       board_[to.raw()] = Piece::empty();
@@ -951,6 +979,44 @@ void Position::undoMove(Move move, Piece captured) {
 template void Position::undoMove<Turn::Black>(Move, Piece);
 template void Position::undoMove<Turn::White>(Move, Piece);
 
+void Position::doMoveOnEffectBoard(const Square& from, const Square& to,
+                                   Piece piece, Piece pieceAfter, Piece captured) {
+  // each step changes the board by only one square
+  // in order to keep the effects consistent with it.
+  if (from.isValid()) {
+    effectBoard_.removePiece(board_, from, piece);
+    if (!captured.isEmpty()) {
+      effectBoard_.removePiece(board_, to, captured);
+    }
+    board_[from.raw()] = Piece::empty();
+    effectBoard_.extend(board_, from);
+  }
+
+  board_[to.raw()] = pieceAfter;
+  if (captured.isEmpty()) {
+    effectBoard_.cut(board_, to);
+  }
+  effectBoard_.addPiece(board_, to, pieceAfter);
+}
+
+void Position::undoMoveOnEffectBoard(const Square& from, const Square& to,
+                                     Piece piece, Piece pieceAfter, Piece captured) {
+  effectBoard_.removePiece(board_, to, pieceAfter);
+  board_[to.raw()] = captured;
+  if (captured.isEmpty()) {
+    effectBoard_.extend(board_, to);
+  }
+
+  if (from.isValid()) {
+    board_[from.raw()] = piece;
+    effectBoard_.cut(board_, from);
+    effectBoard_.addPiece(board_, from, piece);
+    if (!captured.isEmpty()) {
+      effectBoard_.addPiece(board_, to, captured);
+    }
+  }
+}
+
 void Position::doNullMove() {
   turn_ = turn_ == Turn::Black ? Turn::White : Turn::Black;
 }
@@ -1102,6 +1168,12 @@ template bool Position::isCheck<Turn::White>(Move) const;
 
 template <Turn turn>
 bool Position::inCheck() const {
+  if (effectBoardEnabled_) {
+    const Square& square = turn == Turn::Black ? blackKingSquare_ : whiteKingSquare_;
+    return square.isValid() &&
+           effectBoard_.getCount(turn == Turn::Black ? Turn::White : Turn::Black, square) != 0;
+  }
+
   if (turn == Turn::Black) {
     const Square& square = blackKingSquare_;
     return detectShortEffect<Turn::White>(*this, square).isValid()
@@ -1153,6 +1225,15 @@ bool Position::isForced(const Square& square) const {
 template bool Position::isForced<Turn::Black>(const Square& square) const;
 template bool Position::isForced<Turn::White>(const Square& square) const;
 
+template <Turn turn>
+bool Position::isForcedAroundKing(const Square& kingSquare, const Square& square) const {
+  // the long effects which reach the king also reach the squares behind it.
+  return effectBoard_.getCount(turn, square) != 0
+      || effectBoard_.hasLongEffect(turn, kingSquare, kingSquare.dir(square));
+}
+template bool Position::isForcedAroundKing<Turn::Black>(const Square&, const Square&) const;
+template bool Position::isForcedAroundKing<Turn::White>(const Square&, const Square&) const;
+
 template <Turn turn>
 bool Position::isPinned(const Square& square) const {
   auto kingSquare = turn == Turn::Black ? blackKingSquare_ : whiteKingSquare_;
@@ -1178,6 +1259,91 @@ bool Position::isPinned(const Square& square) const {
 template bool Position::isPinned<Turn::Black>(const Square& square) const;
 template bool Position::isPinned<Turn::White>(const Square& square) const;
 
+template <Turn turn>
+Bitboard Position::getPinnedBitboard() const {
+  auto kingSquare = turn == Turn::Black ? blackKingSquare_ : whiteKingSquare_;
+  const auto& self = turn == Turn::Black ? bbBOccupied_ : bbWOccupied_;
+  auto occ = bbBOccupied_ | bbWOccupied_;
+  Bitboard pinned = Bitboard::zero();
+
+  if (!kingSquare.isValid()) {
+    return pinned;
+  }
+
+  // the nearest pieces on each line from the king
+  auto bb = (MoveTables::ver(occ, kingSquare) |
+             MoveTables::hor(bbRotated90_, kingSquare) |
+             MoveTables::diagR45(bbRotatedR45_, kingSquare) |
+             MoveTables::diagL45(bbRotatedL45_, kingSquare)) & self;
+
+  BB_EACH(square, bb) {
+    if (isPinned<turn>(square)) {
+      pinned.set(square);
+    }
+  }
+
+  return pinned;
+}
+template Bitboard Position::getPinnedBitboard<Turn::Black>() const;
+template Bitboard Position::getPinnedBitboard<Turn::White>() const;
+
+template <Turn turn>
+Bitboard Position::extractKingSafeSquares(Bitboard bb) {
+  auto kingSquare = turn == Turn::Black ? blackKingSquare_ : whiteKingSquare_;
+  Bitboard safe = Bitboard::zero();
+
+  if (effectBoardEnabled_) {
+    BB_EACH(to, bb) {
+      if (turn == Turn::Black) {
+        if (!isForcedAroundKing<Turn::White>(kingSquare, to)) {
+          safe.set(to);
+        }
+      } else {
+        if (!isForcedAroundKing<Turn::Black>(kingSquare, to)) {
+          safe.set(to);
+        }
+      }
+    }
+    return safe;
+  }
+
+  // remove the king from the board temporarily
+  // in order to detect long effects which pass through its square.
+  if (turn == Turn::Black) {
+    bbBOccupied_ = Bitboard::mask(kingSquare).andNot(bbBOccupied_);
+  } else {
+    bbWOccupied_ = Bitboard::mask(kingSquare).andNot(bbWOccupied_);
+  }
+  bbRotated90_.unset(kingSquare.rotate90());
+  bbRotatedR45_.unset(kingSquare.rotateRight45());
+  bbRotatedL45_.unset(kingSquare.rotateLeft45());
+
+  BB_EACH(to, bb) {
+    if (turn == Turn::Black) {
+      if (!isForced<Turn::White>(to)) {
+        safe.set(to);
+      }
+    } else {
+      if (!isForced<Turn::Black>(to)) {
+        safe.set(to);
+      }
+    }
+  }
+
+  if (turn == Turn::Black) {
+    bbBOccupied_ |= Bitboard::mask(kingSquare);
+  } else {
+    bbWOccupied_ |= Bitboard::mask(kingSquare);
+  }
+  bbRotated90_.set(kingSquare.rotate90());
+  bbRotatedR45_.set(kingSquare.rotateRight45());
+  bbRotatedL45_.set(kingSquare.rotateLeft45());
+
+  return safe;
+}
+template Bitboard Position::extractKingSafeSquares<Turn::Black>(Bitboard);
+template Bitboard Position::extractKingSafeSquares<Turn::White>(Bitboard);
+
 template <Turn turn>
 bool Position::isDroppable(const Bitboard& mask) const {
   const auto& hand = turn == Turn::Black ? blackHand_ : whiteHand_;
@@ -1422,6 +1588,21 @@ bool Position::isMate(const CheckState& checkState) {
   auto tbb = MoveTables::king(kingSquare);
   auto mate = true;
 
+  if (effectBoardEnabled_) {
+    BB_EACH(to, tbb) {
+      if (turn == Turn::Black) {
+        if (!board_[to.raw()].isBlack() && !isForcedAroundKing<Turn::White>(kingSquare, to)) {
+          return false;
+        }
+      } else {
+        if (!board_[to.raw()].isWhite() && !isForcedAroundKing<Turn::Black>(kingSquare, to)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
   if (turn == Turn::Black) {
     bbBOccupied_ = Bitboard::mask(kingSquare).andNot(bbBOccupied_);
   } else {
@@ -1480,12 +1661,17 @@ bool Position::isMateWithPawnDrop() {
   board_[to.raw()] = turn == Turn::Black ? Piece::blackPawn() : Piece::whitePawn();
 
   // detect whether checkmate
+  // The effect board does not have the effects blocked by the pawn,
+  // so the bitboards are used.
+  bool effectBoardEnabled = effectBoardEnabled_;
+  effectBoardEnabled_ = false;
   CheckState checkState;
   checkState.from1 = to;
   checkState.from2 = Square::invalid();
   bool result = turn == Turn::Black
       ? isMate<Turn::White>(checkState)
       : isMate<Turn::Black>(checkState);
+  effectBoardEnabled_ = effectBoardEnabled;
 
   // undo move
   if (turn == Turn::Black) {
@@ -10,6 +10,7 @@
 #include "core/base/Piece.hpp"
 #include "core/move/Move.hpp"
 #include "core/position/Bitboard.hpp"
+#include "core/position/EffectBoard.hpp"
 #include "core/position/Hand.hpp"
 #include "core/position/Zobrist.hpp"
 
@@ -282,6 +283,32 @@ public:
     return (turn_ == Turn::Black) ? Zobrist::black() : 0x00ULL;
   }
 
+  /**
+   * Start maintaining the effect board in doMove and undoMove.
+   */
+  void enableEffectBoard() {
+    if (!effectBoardEnabled_) {
+      effectBoardEnabled_ = true;
+      effectBoard_.initialize(board_);
+    }
+  }
+
+  void disableEffectBoard() {
+    effectBoardEnabled_ = false;
+  }
+
+  bool isEffectBoardEnabled() const {
+    return effectBoardEnabled_;
+  }
+
+  /**
+   * Get the effect board.
+   * It is valid only while isEffectBoardEnabled() returns true.
+   */
+  const EffectBoard& getEffectBoard() const {
+    return effectBoard_;
+  }
+
   bool hasBlackPawnInFile(int file) const {
     return hasPawnInFile<Turn::Black>(file);
   }
@@ -396,6 +423,30 @@ public:
     }
   }
 
+  /**
+   * Get a bitboard of the pieces which are pinned against the king
+   * of the side to move.
+   */
+  Bitboard getPinnedBitboard() const {
+    if (turn_ == Turn::Black) {
+      return getPinnedBitboard<Turn::Black>();
+    } else {
+      return getPinnedBitboard<Turn::White>();
+    }
+  }
+
+  /**
+   * Extract the squares to which the king of the side to move can move
+   * without being checked.
+   */
+  Bitboard extractKingSafeSquares(const Bitboard& bb) const {
+    if (turn_ == Turn::Black) {
+      return const_cast<Position*>(this)->extractKingSafeSquares<Turn::Black>(bb);
+    } else {
+      return const_cast<Position*>(this)->extractKingSafeSquares<Turn::White>(bb);
+    }
+  }
+
   /**
    * Get a string of CSA format
    */
@@ -493,6 +544,15 @@ private:
   template <Turn turn>
   void undoMove(Move move, Piece captured);
 
+  void doMoveOnEffectBoard(const Square& from, const Square& to,
+                           Piece piece, Piece pieceAfter, Piece captured);
+
+  void undoMoveOnEffectBoard(const Square& from, const Square& to,
+                             Piece piece, Piece pieceAfter, Piece captured);
+
+  template <Turn turn>
+  bool isForcedAroundKing(const Square& kingSquare, const Square& square) const;
+
   template <Turn turn>
   std::tuple<Square, Square> detectLongEffects(const Square& square, Square) const;
 
@@ -521,6 +581,12 @@ private:
   template <Turn turn>
   bool isPinned(const Square& square) const;
 
+  template <Turn turn>
+  Bitboard getPinnedBitboard() const;
+
+  template <Turn turn>
+  Bitboard extractKingSafeSquares(Bitboard bb);
+
   template <Turn turn>
   bool isDroppable(const Bitboard& mask) const;
 
@@ -575,6 +641,9 @@ private:
   Zobrist::Type boardHash_;
   Zobrist::Type handHash_;
 
+  EffectBoard effectBoard_;
+  bool effectBoardEnabled_ = false;
+
 };
 
 }
@@ -14,7 +14,6 @@
 #include "logger/Logger.hpp"
 #include <functional>
 #include <fstream>
-#include <chrono>
 #include <utility>
 #include <sstream>
 
@@ -33,7 +32,10 @@ CONSTEXPR_CONST int DefaultRepeat    = 1000;
 CONSTEXPR_CONST int DefaultPonder    = 1;
 CONSTEXPR_CONST int DefaultUseBook   = 1;
 CONSTEXPR_CONST int DefaultHashMem   = 64;
-CONSTEXPR_CONST int DefaultMarginMs  = 1000;
+CONSTEXPR_CONST int DefaultEvalHashMem = 2;
+CONSTEXPR_CONST int DefaultEvalHashPerThread = 0;
+CONSTEXPR_CONST int DefaultMarginMs  = 200;
+CONSTEXPR_CONST int DefaultAutoMargin = 1;
 CONSTEXPR_CONST int DefaultMultiPV   = 1;
 
 CONSTEXPR_CONST int DefaultKeepAlive = 0;
@@ -41,6 +43,9 @@ CONSTEXPR_CONST int DefaultKeepIdle  = 120;
 CONSTEXPR_CONST int DefaultKeepIntvl = 60;
 CONSTEXPR_CONST int DefaultKeepCnt   = 10;
 
+/** the search time when the margin eats up the remaining time */
+CONSTEXPR_CONST int MinimumSearchMs = 100;
+
 const Wildcard LoginOk("LOGIN:* OK");
 const Wildcard Start("START:*");
 const Wildcard BeginGameSummary("BEGIN Game_Summary");
@@ -92,6 +97,7 @@ bool CsaClient::start() {
   }
   searcher_->setHandler(this);
   searcher_->ttResizeMB(config_.hashMem);
+  searcher_->evalCacheResizeMB(config_.evalHashMem, config_.evalHashPerThread);
 
   playOnRepeat();
 
@@ -114,7 +120,10 @@ void CsaClient::readConfigFromIniFile() {
   config_.ponder   = StringUtil::toInt(getValue(ini, "Search", "Ponder"), DefaultPonder);
   config_.useBook     = StringUtil::toInt(getValue(ini, "Search", "UseBook"), DefaultUseBook);
   config_.hashMem  = StringUtil::toInt(getValue(ini, "Search", "HashMem"), DefaultHashMem);
+  config_.evalHashMem = StringUtil::toInt(getValue(ini, "Search", "EvalHashMem"), DefaultEvalHashMem);
+  config_.evalHashPerThread = StringUtil::toInt(getValue(ini, "Search", "EvalHashPerThread"), DefaultEvalHashPerThread);
   config_.marginMs = StringUtil::toInt(getValue(ini, "Search", "MarginMs"), DefaultMarginMs);
+  config_.autoMargin = StringUtil::toInt(getValue(ini, "Search", "AutoMargin"), DefaultAutoMargin);
   config_.multiPV  = StringUtil::toInt(getValue(ini, "Search", "MultiPV"), DefaultMultiPV);
 
   config_.keepalive = StringUtil::toInt(getValue(ini, "KeepAlive", "KeepAlive"), DefaultKeepAlive);
@@ -139,7 +148,10 @@ void CsaClient::readConfigFromIniFile() {
   MSG(info) << "    Ponder  : " << config_.ponder;
   MSG(info) << "    UseBook : " << config_.useBook;
   MSG(info) << "    HashMem : " << config_.hashMem;
+  MSG(info) << "    EvalHashMem: " << config_.evalHashMem;
+  MSG(info) << "    EvalHashPerThread: " << config_.evalHashPerThread;
   MSG(info) << "    MarginMs: " << config_.marginMs;
+  MSG(info) << "    AutoMargin: " << config_.autoMargin;
   MSG(info) << "    MultiPV : " << config_.multiPV;
   MSG(info) << "  KeepAlive";
   MSG(info) << "    Keepalive: " << config_.keepalive;
@@ -237,6 +249,9 @@ void CsaClient::play() {
       return;
     }
 
+    // the search must be finished before the game history is changed.
+    searchThread.stop();
+
     if (!onMove()) {
       return;
     }
@@ -255,9 +270,22 @@ void CsaClient::play() {
 bool CsaClient::login() {
   std::ostringstream os;
   os << "LOGIN " << config_.user << ' ' << config_.pass;
-  return send(os.str()) &&
-         receive() &&
-         LoginOk.match(lastReceivedString_);
+  if (!send(os.str(), true) ||
+      !receive() ||
+      !LoginOk.match(lastReceivedString_)) {
+    return false;
+  }
+
+  addRoundTripTime();
+
+  return true;
+}
+
+void CsaClient::addRoundTripTime() {
+  rtt_.add(lastResponseMs_);
+  MSG(info) << "round-trip time: " << lastResponseMs_ << "ms"
+            << " (smoothed: " << static_cast<int>(rtt_.smoothedMs()) << "ms"
+            << ", delay: " << rtt_.delayMs() << "ms)";
 }
 
 bool CsaClient::logout() {
@@ -422,6 +450,7 @@ bool CsaClient::onGameSummaryPosition() {
     return false;
   }
   position_ = generatePosition(record_, -1);
+  history_.sync(record_);
 
   return true;
 }
@@ -584,9 +613,15 @@ bool CsaClient::onMove() {
     return false;
   }
   record_.moveList.push_back(move);
+  history_.append(move);
 
   MSG(info) << position_;
 
+  // the server echoes my move back.
+  if (turn == gameSummary_.myTurn) {
+    addRoundTripTime();
+  }
+
   if (!tstr.empty() && tstr[0] == 'T') {
     int reduced = std::stoi(tstr.c_str() + 1);
     if (turn == Turn::Black) {
@@ -607,7 +642,7 @@ void CsaClient::runSearch(ScopedThread& searchThread) {
     Move bookMove = BookUtil::select(book_, position_, random_);
     if (!bookMove.isNone()) {
       MSG(info) << "opening book hit";
-      send(bookMove.toString(position_));
+      send(bookMove.toString(position_), true);
       return;
     }
   }
@@ -631,7 +666,14 @@ void CsaClient::search() {
                            : whiteTime_ * 1000;
   TimeType byoyomiMs = gameSummary_.byoyomi * 1000;
   TimeType incrementMs = gameSummary_.increment * 1000;
-  config.maximumTimeMs = remainingTimeMs + byoyomiMs - config_.marginMs;
+  TimeType marginMs = config_.marginMs;
+  if (config_.autoMargin) {
+    // the server counts the network delay as my thinking time.
+    marginMs += rtt_.delayMs();
+  }
+  config.maximumTimeMs = remainingTimeMs + byoyomiMs > marginMs + MinimumSearchMs
+                       ? remainingTimeMs + byoyomiMs - marginMs
+                       : MinimumSearchMs;
   config.optimumTimeMs = std::max(remainingTimeMs / 50,
                          std::min(remainingTimeMs, byoyomiMs + incrementMs))
                        + byoyomiMs;
@@ -652,7 +694,7 @@ void CsaClient::search() {
 
   searcher_->idsearch(position_,
                      Searcher::DepthInfinity,
-                     &record_);
+                     &history_);
   auto& result = searcher_->getResult();
 
   if (result.move.isNone()) {
@@ -664,7 +706,8 @@ void CsaClient::search() {
   oss << result.move.toString(position_);
 
   // floodgate mode
-  if (config_.floodgate) {
+  // (no score and PV if the move is not searched)
+  if (config_.floodgate && result.depth != 0) {
     // score
     auto score = position_.getTurn() == Turn::Black
                ? result.score.raw()
@@ -685,7 +728,7 @@ void CsaClient::search() {
     }
   }
 
-  send(oss.str());
+  send(oss.str(), true);
 }
 
 void CsaClient::runPonder(ScopedThread& searchThread) {
@@ -710,22 +753,26 @@ void CsaClient::ponder() {
 
   searcher_->idsearch(position_,
                      Searcher::DepthInfinity,
-                     &record_);
+                     &history_);
 }
 
 void CsaClient::waitForSearcherStart() {
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    if (searcherIsStarted_) { break; }
-  }
+  std::unique_lock<std::mutex> lock(searcherMutex_);
+  searcherCond_.wait(lock, [this]() {
+    return searcherIsStarted_.load();
+  });
 }
 
 void CsaClient::onStart(const Searcher&) {
-  searcherIsStarted_ = true;
+  {
+    std::lock_guard<std::mutex> lock(searcherMutex_);
+    searcherIsStarted_ = true;
+  }
+  searcherCond_.notify_all();
 }
 
 template <class T>
-bool CsaClient::send(const T& str) {
+bool CsaClient::send(const T& str, bool timed) {
   std::lock_guard<std::mutex> lock(sendMutex_);
 
   std::ostringstream os;
@@ -733,6 +780,9 @@ bool CsaClient::send(const T& str) {
   if (!socket_.sendString(os.str())) {
     return false;
   }
+  if (timed) {
+    sendTimer_.start();
+  }
 
   MSG(send) << str;
 
@@ -744,6 +794,11 @@ bool CsaClient::receive() {
     return false;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    lastResponseMs_ = sendTimer_.elapsedMs();
+  }
+
   // chomp
   if (lastReceivedString_.length() != 0 &&
       lastReceivedString_.back() == '\n') {
@@ -11,8 +11,11 @@
 #include "core/record/Record.hpp"
 #include "book/Book.hpp"
 #include "csa/client/Socket.hpp"
+#include "csa/client/RoundTripTime.hpp"
+#include "common/time/Timer.hpp"
 #include <string>
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 
@@ -39,7 +42,10 @@ public:
     int ponder;
     int useBook;
     int hashMem;
+    int evalHashMem;
+    int evalHashPerThread;
     int marginMs;
+    int autoMargin;
     int multiPV;
 
     int keepalive;
@@ -91,6 +97,8 @@ private:
 
   bool login();
 
+  void addRoundTripTime();
+
   bool logout();
 
   bool onGameSummary();
@@ -119,8 +127,13 @@ private:
 
   void onStart(const Searcher&) override;
 
+  /**
+   * Send a command.
+   * The round-trip time is measured only from a timed command,
+   * which the server replies to. (LOGIN and moves)
+   */
   template <class T>
-  bool send(const T& str);
+  bool send(const T& str, bool timed = false);
 
   bool receive();
 
@@ -131,16 +144,25 @@ private:
   Socket socket_;
   std::string lastReceivedString_;
 
+  /** the time of the last timed command sent */
+  Timer sendTimer_;
+  /** the time from the last timed command sent to the last command received */
+  uint32_t lastResponseMs_;
+  RoundTripTime rtt_;
+
   Config config_;
   GameSummary gameSummary_;
   std::string gameId_;
   Record record_;
+  GameHistory history_;
   Position position_;
   int blackTime_;
   int whiteTime_;
 
   std::unique_ptr<Searcher> searcher_;
   std::atomic<bool> searcherIsStarted_;
+  std::mutex searcherMutex_;
+  std::condition_variable searcherCond_;
   std::mutex sendMutex_;
 
   Book book_;
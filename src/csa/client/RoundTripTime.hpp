@@ -0,0 +1,66 @@
+/* RoundTripTime.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_CSA_CLIENT_ROUNDTRIPTIME_HPP__
+#define SUNFISH_CSA_CLIENT_ROUNDTRIPTIME_HPP__
+
+#include <cmath>
+
+namespace sunfish {
+
+/**
+ * RoundTripTime estimates a network delay from samples of round-trip
+ * times in the same way as the retransmission timer of TCP (RFC 6298).
+ */
+class RoundTripTime {
+public:
+
+  RoundTripTime() {
+    clear();
+  }
+
+  void clear() {
+    samples_ = 0;
+    smoothedMs_ = 0.0f;
+    variationMs_ = 0.0f;
+  }
+
+  void add(float ms) {
+    if (samples_ == 0) {
+      smoothedMs_ = ms;
+      variationMs_ = ms / 2.0f;
+    } else {
+      variationMs_ = 0.75f * variationMs_ + 0.25f * std::fabs(smoothedMs_ - ms);
+      smoothedMs_ = 0.875f * smoothedMs_ + 0.125f * ms;
+    }
+    samples_++;
+  }
+
+  int samples() const {
+    return samples_;
+  }
+
+  float smoothedMs() const {
+    return smoothedMs_;
+  }
+
+  /**
+   * a conservative estimation of the delay.
+   */
+  int delayMs() const {
+    return static_cast<int>(smoothedMs_ + 4.0f * variationMs_ + 0.5f);
+  }
+
+private:
+
+  int samples_;
+  float smoothedMs_;
+  float variationMs_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_CSA_CLIENT_ROUNDTRIPTIME_HPP__
@@ -16,6 +16,8 @@
 using ssize_t = int;
 #else
 # include <unistd.h>
+# include <fcntl.h>
+# include <poll.h>
 # include <dirent.h>
 # include <strings.h>
 # include <sched.h>
@@ -26,6 +28,32 @@ using ssize_t = int;
 # include <netdb.h>
 #endif
 
+namespace {
+
+using namespace sunfish;
+
+#ifndef WIN32
+bool waitFor(Socket::SocketType sock, short events) {
+  struct pollfd pfd;
+  pfd.fd = sock;
+  pfd.events = events;
+  pfd.revents = 0;
+
+  for (;;) {
+    int ret = poll(&pfd, 1, -1);
+    if (ret > 0) {
+      return true;
+    }
+    if (ret == -1 && errno != EINTR) {
+      LOG(error) << "an error occured in poll function. (errno: " << errno << ")";
+      return false;
+    }
+  }
+}
+#endif
+
+} // namespace
+
 namespace sunfish {
 
 Socket::Socket() :
@@ -87,6 +115,14 @@ bool Socket::connect() {
 # endif // BSD
 #endif // UNIX
 
+  // disable Nagle's algorithm so that a move is sent immediately.
+  int nodelay = 1;
+  if (0 != setsockopt(sock_, IPPROTO_TCP, TCP_NODELAY,
+      reinterpret_cast<const char*>(&nodelay), sizeof(nodelay))) {
+    LOG(error) << "an error occured in setsockopt function. (errno: " << errno << ")";
+    return false;
+  }
+
   memcpy(&sin.sin_addr, he->h_addr, sizeof(struct in_addr));
   sin.sin_family = AF_INET;
   sin.sin_port = htons(port_);
@@ -96,6 +132,17 @@ bool Socket::connect() {
     return false;
   }
 
+#ifndef WIN32
+  int flags = fcntl(sock_, F_GETFL, 0);
+  if (flags == -1 || fcntl(sock_, F_SETFL, flags | O_NONBLOCK) == -1) {
+    LOG(error) << "an error occured in fcntl function. (errno: " << errno << ")";
+    disconnect();
+    return false;
+  }
+#endif
+
+  receivedBuffer_.clear();
+
   MSG(info) << "connected to " << host_ << ':' << port_;
 
   return true;
@@ -117,29 +164,66 @@ void Socket::disconnect() {
 
 bool Socket::receiveString(std::string& out) {
   for (;;) {
-    if (getline(receivedStringStream_, out)) {
+    auto pos = receivedBuffer_.find('\n');
+    if (pos != std::string::npos) {
+      out = receivedBuffer_.substr(0, pos + 1);
+      receivedBuffer_.erase(0, pos + 1);
       return true;
     }
 
+#ifndef WIN32
+    if (!waitFor(sock_, POLLIN)) {
+      return false;
+    }
+#endif
+
     char buffer[1024];
     ssize_t size = recv(sock_,
                         buffer,
                         sizeof(buffer),
                         0);
     if (size == -1) {
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+        continue;
+      }
+      LOG(error) << "an error occured in recv function. (errno: " << errno << ")";
+      return false;
+    }
+    if (size == 0) {
+      LOG(error) << "the connection is closed by the server.";
       return false;
     }
 
-    receivedStringStream_.str(std::string(buffer, size));
-    receivedStringStream_.clear(std::stringstream::goodbit);
+    receivedBuffer_.append(buffer, size);
   }
 }
 
 bool Socket::sendString(const std::string& str) {
-  return ::send(sock_,
-                str.c_str(),
-                str.length(),
-                0) != -1;
+  const char* p = str.c_str();
+  size_t remaining = str.length();
+
+  while (remaining != 0) {
+    ssize_t size = ::send(sock_,
+                          p,
+                          remaining,
+                          0);
+    if (size == -1) {
+#ifndef WIN32
+      if (errno == EINTR) {
+        continue;
+      }
+      if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitFor(sock_, POLLOUT)) {
+        continue;
+      }
+#endif
+      LOG(error) << "an error occured in send function. (errno: " << errno << ")";
+      return false;
+    }
+    p += size;
+    remaining -= size;
+  }
+
+  return true;
 }
 
 } // namespace sunfish
@@ -8,7 +8,6 @@
 
 #include "common/Def.hpp"
 
-#include <sstream>
 #include <string>
 
 namespace sunfish {
@@ -63,6 +62,10 @@ public:
 
   void disconnect();
 
+  /**
+   * receive a line.
+   * this waits for data with poll and never blocks in recv.
+   */
   bool receiveString(std::string& out);
 
   bool sendString(const std::string& str);
@@ -80,7 +83,8 @@ private:
   SocketType sock_;
   bool opened_;
 
-  std::istringstream receivedStringStream_;
+  /** the received bytes which have not been returned as a line */
+  std::string receivedBuffer_;
 
 };
 
@@ -9,7 +9,16 @@
 #include "search/util/SearchUtil.hpp"
 #include "expt/solve/Solver.hpp"
 #include "expt/mgtest/MoveGenerationTest.hpp"
+#include "expt/perft/Perft.hpp"
+#include "expt/scaling/Scaling.hpp"
+#include "expt/spsa/Spsa.hpp"
+#include "search/Searcher.hpp"
+#include "search/bench/Bench.hpp"
+#include "search/analyze/Analyzer.hpp"
+#include "core/record/SfenParser.hpp"
+#include "common/string/StringUtil.hpp"
 #include "logger/Logger.hpp"
+#include <fstream>
 #include <string>
 
 using namespace sunfish;
@@ -23,9 +32,27 @@ int main(int argc, char** argv, char**) {
   ProgramOptions po;
   po.addOption("solve", "run a solver", true);
   po.addOption("mgtest", "run a cross-check test of move generation");
-  po.addOption("time", "t", "a muximum time of search in seconds (This option will used when the --solve option is specified.)", true);
-  po.addOption("depth", "d", "a muximum depth of search (This option will used when the --solve option is specified.)", true);
-  po.addOption("threads", "r", "a number of search threads (This option will used when the --solve option is specified.)", true);
+  po.addOption("perft", "count leaf nodes from the specified SFEN position (or `startpos')", true);
+  po.addOption("bench", "search the built-in positions to a fixed depth and print nodes, NPS and a signature");
+  po.addOption("analyze", "search each position of the specified file and print the results as JSON lines", true);
+  po.addOption("scaling", "measure NPS and time-to-depth with 1, 2, 4, ... and the specified number of threads", true);
+  po.addOption("format", "an output format of --scaling (csv or json)", true);
+  po.addOption("positions", "a number of positions searched by --scaling", true);
+  po.addOption("spsa", "tune the search parameters by self-play games of the specified USI engine built with TUNING=ON", true);
+  po.addOption("spsa-params", "comma-separated names of the parameters tuned by --spsa (default: all)", true);
+  po.addOption("iterations", "a number of iterations of --spsa", true);
+  po.addOption("pairs", "a number of game pairs of each iteration of --spsa", true);
+  po.addOption("byoyomi", "a time for each move in milliseconds (This option will used when the --spsa option is specified.)", true);
+  po.addOption("learning-rate", "a step size of the first iteration of --spsa", true);
+  po.addOption("time", "t", "a muximum time of search in seconds (This option will used when the --solve or --analyze option is specified.)", true);
+  po.addOption("nodes", "a muximum number of nodes of search (This option will used when the --solve, --analyze or --spsa option is specified.)", true);
+  po.addOption("depth", "d", "a muximum depth of search (This option will used when the --solve, --perft, --bench, --analyze or --scaling option is specified.)", true);
+  po.addOption("threads", "r", "a number of search threads (This option will used when the --solve, --perft, --bench or --analyze option is specified.)", true);
+  po.addOption("jobs", "j", "a number of problems, positions or games searched concurrently by independent searchers (This option will used when the --solve, --analyze or --spsa option is specified.)", true);
+  po.addOption("hash", "a TT size of each searcher in MiB (This option will used when the --solve, --analyze or --spsa option is specified.)", true);
+  po.addOption("trace", "write search events to the specified file as a Chrome trace JSON (This option will used when the --solve option is specified.)", true);
+  po.addOption("stats", "print search statistics at the specified interval in milliseconds (This option will used when the --solve option is specified.)", true);
+  po.addOption("effect-board", "maintain the effect board of positions while searching (This option will used when the --bench option is specified.)", false);
   po.addOption("no-interrupt", "ni", "If this option is specified, it is disabled to interrupt. (This option will used when the --solve option is specified.)", false);
   po.addOption("help", "h", "show this help");
   po.parse(argc, argv);
@@ -64,15 +91,33 @@ int main(int argc, char** argv, char**) {
     if (po.has("time")) {
       config.muximumTimeSeconds = std::stoi(po.getValue("time"));
     }
+    if (po.has("nodes")) {
+      config.maximumNodes = std::stoull(po.getValue("nodes"));
+      if (!po.has("time")) {
+        config.muximumTimeSeconds = SearchConfig::InfinityTime / 1000;
+      }
+    }
     if (po.has("depth")) {
       config.muximumDepth = std::stoi(po.getValue("depth"));
     }
     if (po.has("threads")) {
       config.numberOfThreads = std::stoi(po.getValue("threads"));
     }
+    if (po.has("jobs")) {
+      config.numberOfJobs = std::stoi(po.getValue("jobs"));
+    }
+    if (po.has("hash")) {
+      config.hashMebiBytes = std::stoi(po.getValue("hash"));
+    }
     if (po.has("no-interrupt")) {
       config.noInterrupt = true;
     }
+    if (po.has("stats")) {
+      config.statsIntervalMs = std::stoi(po.getValue("stats"));
+    }
+    if (po.has("trace")) {
+      config.traceFile = po.getValue("trace");
+    }
     solver.setConfig(config);
 
     std::string targetDirectory = po.getValue("solve");
@@ -87,6 +132,165 @@ int main(int argc, char** argv, char**) {
     return ok ? 0 : 1;
   }
 
+  // perft
+  if (po.has("perft")) {
+    std::string sfen = po.getValue("perft");
+    Position position;
+    if (sfen == "startpos") {
+      position.initialize(Position::Handicap::Even);
+    } else if (!SfenParser::parsePosition(sfen, position)) {
+      MSG(error) << "invalid SFEN: " << sfen;
+      return 1;
+    }
+
+    Perft perft;
+
+    auto config = perft.getConfig();
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    }
+    if (po.has("threads")) {
+      config.numberOfThreads = std::stoi(po.getValue("threads"));
+    }
+    perft.setConfig(config);
+
+    bool ok = perft.run(position);
+    return ok ? 0 : 1;
+  }
+
+  // bench
+  if (po.has("bench")) {
+    Searcher searcher;
+    Bench bench;
+
+    auto config = bench.getConfig();
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    }
+    if (po.has("threads")) {
+      config.numberOfThreads = std::stoi(po.getValue("threads"));
+    }
+    if (po.has("effect-board")) {
+      config.effectBoard = true;
+    }
+    bench.setConfig(config);
+
+    bool ok = bench.run(searcher);
+    return ok ? 0 : 1;
+  }
+
+  // batch analysis
+  if (po.has("analyze")) {
+    Analyzer analyzer;
+
+    auto config = analyzer.getConfig();
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    } else if (po.has("time") || po.has("nodes")) {
+      config.depth = Analyzer::MaximumDepth;
+    }
+    if (po.has("time")) {
+      config.maximumTimeMs = std::stoi(po.getValue("time")) * 1000;
+    }
+    if (po.has("nodes")) {
+      config.maximumNodes = std::stoull(po.getValue("nodes"));
+    }
+    if (po.has("threads")) {
+      config.numberOfThreads = std::stoi(po.getValue("threads"));
+    }
+    if (po.has("jobs")) {
+      config.numberOfSearchers = std::stoi(po.getValue("jobs"));
+    }
+    if (po.has("hash")) {
+      config.hashMebiBytes = std::stoi(po.getValue("hash"));
+    }
+    analyzer.setConfig(config);
+
+    auto callback = [](const Analyzer::Result& result) {
+      Analyzer::writeJson(std::cout, result);
+    };
+
+    std::string path = po.getValue("analyze");
+    std::ifstream file(path);
+    if (!file) {
+      MSG(error) << "could not open a file: " << path;
+      return 1;
+    }
+
+    bool ok = analyzer.analyze(file, callback);
+    return ok ? 0 : 1;
+  }
+
+  // thread scaling
+  if (po.has("scaling")) {
+    Scaling scaling;
+
+    auto config = scaling.getConfig();
+    config.maximumThreads = std::stoi(po.getValue("scaling"));
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    }
+    if (po.has("positions")) {
+      config.numberOfPositions = std::stoi(po.getValue("positions"));
+    }
+    if (po.has("format")) {
+      std::string format = po.getValue("format");
+      if (format == "json") {
+        config.format = Scaling::Format::Json;
+      } else if (format == "csv") {
+        config.format = Scaling::Format::Csv;
+      } else {
+        MSG(error) << "unknown format: " << format;
+        return 1;
+      }
+    }
+    scaling.setConfig(config);
+
+    bool ok = scaling.run(std::cout);
+    return ok ? 0 : 1;
+  }
+
+  // SPSA tuning
+  if (po.has("spsa")) {
+    Spsa spsa;
+
+    auto config = spsa.getConfig();
+    config.enginePath = po.getValue("spsa");
+    if (po.has("spsa-params")) {
+      config.parameters = StringUtil::split(po.getValue("spsa-params"), [](char c) {
+        return c == ',';
+      });
+    }
+    if (po.has("iterations")) {
+      config.iterations = std::stoi(po.getValue("iterations"));
+    }
+    if (po.has("pairs")) {
+      config.gamePairs = std::stoi(po.getValue("pairs"));
+    }
+    if (po.has("jobs")) {
+      config.numberOfJobs = std::stoi(po.getValue("jobs"));
+    }
+    if (po.has("nodes")) {
+      config.nodes = std::stoull(po.getValue("nodes"));
+    }
+    if (po.has("byoyomi")) {
+      config.byoyomiMs = std::stoi(po.getValue("byoyomi"));
+      if (!po.has("nodes")) {
+        config.nodes = 0;
+      }
+    }
+    if (po.has("hash")) {
+      config.hashMebiBytes = std::stoi(po.getValue("hash"));
+    }
+    if (po.has("learning-rate")) {
+      config.learningRate = std::stod(po.getValue("learning-rate"));
+    }
+    spsa.setConfig(config);
+
+    bool ok = spsa.run(std::cout);
+    return ok ? 0 : 1;
+  }
+
   MSG(error) << "No action is specified.";
   std::cout << po.help();
 
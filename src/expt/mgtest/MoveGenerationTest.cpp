@@ -106,6 +106,39 @@ MoveGenerationTest::TestStatus MoveGenerationTest::testAndDoMove(Position& posit
     }
   }
 
+  Moves moves3;
+  MoveGenerator::generateLegalMoves(position, moves3);
+  sortMovesForDebug(moves3, position);
+  sortMovesForDebug(moves, position);
+
+  if (moves.size() != moves3.size()) {
+    MSG(error) << "sizes of legal moves are not euqal.";
+    MSG(error) << position.toString();
+    MSG(error) << "moves 1: "
+               << "n=" << moves.size() << ": "
+               << moves.toString(position);
+    MSG(error) << "moves 3: "
+               << "n=" << moves3.size() << ": "
+               << moves3.toString(position);
+    return TestStatus::Error;
+  }
+
+  for (Moves::size_type i = 0; i < moves.size(); i++) {
+    if (moves[i] != moves3[i]) {
+      MSG(error) << "generated different legal moves.";
+      MSG(error) << "moves 1: "
+                 << "n=" << moves.size() << ": "
+                 << moves.toString(position);
+      MSG(error) << "moves 3: "
+                 << "n=" << moves3.size() << ": "
+                 << moves3.toString(position);
+      MSG(error) << moves[i].toString(position)
+                 << " is not equal to "
+                 << moves3[i].toString(position);
+      return TestStatus::Error;
+    }
+  }
+
   if (moves.size() == 0) {
     return TestStatus::Mate;
   }
@@ -0,0 +1,128 @@
+/* Perft.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "expt/perft/Perft.hpp"
+#include "common/time/Timer.hpp"
+#include "core/position/Position.hpp"
+#include "core/move/Moves.hpp"
+#include "core/move/MoveGenerator.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace sunfish {
+
+Perft::Perft() {
+  config_.depth = 5;
+  config_.numberOfThreads = 1;
+  config_.hashMebiBytes = 64;
+}
+
+bool Perft::run(const Position& position) {
+  if (config_.depth < 1) {
+    LOG(error) << "invalid depth: " << config_.depth;
+    return false;
+  }
+
+  hash_.resizeMB(config_.hashMebiBytes);
+  hash_.clear();
+
+  MSG(info) << position.toString();
+
+  Moves moves;
+  MoveGenerator::generateLegalMoves(position, moves);
+
+  std::vector<uint64_t> counts(moves.size(), 0);
+  std::atomic<unsigned> next(0);
+
+  auto worker = [this, &position, &moves, &counts, &next]() {
+    Position pos = position;
+    while (true) {
+      unsigned index = next.fetch_add(1);
+      if (index >= moves.size()) {
+        break;
+      }
+
+      Move move = moves[index];
+      Piece captured;
+      pos.doMove(move, captured);
+      counts[index] = perft(pos, config_.depth - 1);
+      pos.undoMove(move, captured);
+    }
+  };
+
+  Timer timer;
+  timer.start();
+
+  int numberOfThreads = std::max(config_.numberOfThreads, 1);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numberOfThreads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  result_.elapsed = timer.elapsed();
+  result_.nodes = 0;
+
+  std::vector<std::pair<std::string, uint64_t>> divide;
+  for (Moves::size_type i = 0; i < moves.size(); i++) {
+    divide.push_back({ moves[i].toStringSFEN(), counts[i] });
+    result_.nodes += counts[i];
+  }
+  std::sort(divide.begin(), divide.end());
+
+  for (const auto& pair : divide) {
+    MSG(info) << std::setw(8) << std::left << pair.first << pair.second;
+  }
+
+  float elapsed = std::max(result_.elapsed, 1.0e-3f);
+  MSG(info) << "depth   : " << config_.depth;
+  MSG(info) << "threads : " << numberOfThreads;
+  MSG(info) << "moves   : " << moves.size();
+  MSG(info) << "nodes   : " << result_.nodes;
+  MSG(info) << "time    : " << result_.elapsed;
+  MSG(info) << "nps     : " << static_cast<uint64_t>(result_.nodes / elapsed);
+
+  return true;
+}
+
+uint64_t Perft::perft(Position& position, int depth) {
+  if (depth == 0) {
+    return 1;
+  }
+
+  uint64_t count;
+  if (depth >= 2 && hash_.probe(position.getHash(), depth, count)) {
+    return count;
+  }
+
+  Moves moves;
+  MoveGenerator::generateLegalMoves(position, moves);
+
+  // bulk counting
+  if (depth == 1) {
+    return moves.size();
+  }
+
+  count = 0;
+  for (auto& move : moves) {
+    Piece captured;
+    position.doMove(move, captured);
+    count += perft(position, depth - 1);
+    position.undoMove(move, captured);
+  }
+
+  hash_.store(position.getHash(), depth, count);
+
+  return count;
+}
+
+} // namespace sunfish
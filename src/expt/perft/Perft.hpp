@@ -0,0 +1,114 @@
+/* Perft.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_EXPT_PERFT_PERFT_HPP__
+#define SUNFISH_EXPT_PERFT_PERFT_HPP__
+
+#include "search/table/HashTable.hpp"
+#include "core/position/Zobrist.hpp"
+#include <cstdint>
+
+namespace sunfish {
+
+class Position;
+
+class PerftHashElement {
+public:
+
+  PerftHashElement() : check_(0llu), data_(0llu) {
+  }
+
+  void set(Zobrist::Type hash, int depth, uint64_t count) {
+    uint64_t data = (count << 8) | static_cast<uint8_t>(depth);
+    // 'check_' is XORed with 'data_' so that a torn write by
+    // another thread is detected as a miss.
+    check_ = hash ^ data;
+    data_ = data;
+  }
+
+  bool get(Zobrist::Type hash, int depth, uint64_t& count) const {
+    uint64_t data = data_;
+    if ((check_ ^ data) != hash ||
+        static_cast<uint8_t>(data) != static_cast<uint8_t>(depth)) {
+      return false;
+    }
+    count = data >> 8;
+    return true;
+  }
+
+private:
+
+  volatile uint64_t check_;
+  volatile uint64_t data_;
+
+};
+
+class PerftHash : public HashTable<PerftHashElement> {
+public:
+
+  static CONSTEXPR_CONST unsigned DefaultWidth = 20;
+
+  PerftHash() : HashTable<PerftHashElement>(DefaultWidth) {}
+
+  void store(Zobrist::Type hash, int depth, uint64_t count) {
+    getElement(hash).set(hash, depth, count);
+  }
+
+  bool probe(Zobrist::Type hash, int depth, uint64_t& count) const {
+    return getElement(hash).get(hash, depth, count);
+  }
+
+};
+
+/**
+ * Perft counts leaf nodes of the full-width tree.
+ * Moves are enumerated by MoveGenerator, so non-promotion moves of
+ * pawns, bishops and rooks in the promotion zone are not counted.
+ */
+class Perft {
+public:
+
+  struct Config {
+    int depth;
+    int numberOfThreads;
+    unsigned hashMebiBytes;
+  };
+
+  struct Result {
+    uint64_t nodes;
+    float elapsed;
+  };
+
+  Perft();
+
+  bool run(const Position& position);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  const Result& getResult() const {
+    return result_;
+  }
+
+private:
+
+  uint64_t perft(Position& position, int depth);
+
+private:
+
+  Config config_;
+  Result result_;
+  PerftHash hash_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_EXPT_PERFT_PERFT_HPP__
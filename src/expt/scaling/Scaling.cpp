@@ -0,0 +1,218 @@
+/* Scaling.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "expt/scaling/Scaling.hpp"
+#include "search/bench/Bench.hpp"
+#include "core/position/Position.hpp"
+#include "core/record/SfenParser.hpp"
+#include "common/time/Timer.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+using namespace sunfish;
+
+CONSTEXPR_CONST unsigned RandomSeed = 0;
+
+float nps(uint64_t nodes, float elapsed) {
+  return nodes / std::max(elapsed, 1.0e-3f);
+}
+
+/**
+ * time-to-depth speedup against the single-threaded search.
+ */
+float speedup(float elapsed1, float elapsed) {
+  return std::max(elapsed1, 1.0e-3f) / std::max(elapsed, 1.0e-3f);
+}
+
+/**
+ * the ratio of nodes which the single-threaded search did not need.
+ */
+float duplicateNodeRatio(uint64_t nodes1, uint64_t nodes) {
+  if (nodes == 0 || nodes <= nodes1) {
+    return 0.0f;
+  }
+  return static_cast<float>(nodes - nodes1) / nodes;
+}
+
+} // namespace
+
+namespace sunfish {
+
+Scaling::Scaling() {
+  config_.depth = 8;
+  config_.maximumThreads = 4;
+  config_.numberOfPositions = static_cast<int>(Bench::positions().size());
+  config_.hashMebiBytes = 64;
+  config_.format = Format::Csv;
+}
+
+bool Scaling::run(std::ostream& os) {
+  if (config_.depth < 1) {
+    LOG(error) << "invalid depth: " << config_.depth;
+    return false;
+  }
+
+  if (config_.maximumThreads < 1) {
+    LOG(error) << "invalid number of threads: " << config_.maximumThreads;
+    return false;
+  }
+
+  searcher_.ttResizeMB(config_.hashMebiBytes);
+
+  results_.clear();
+  for (int threads = 1; ; threads *= 2) {
+    threads = std::min(threads, config_.maximumThreads);
+    if (!run(threads)) {
+      return false;
+    }
+    if (threads >= config_.maximumThreads) {
+      break;
+    }
+  }
+
+  if (config_.format == Format::Json) {
+    writeJson(os);
+  } else {
+    writeCsv(os);
+  }
+
+  return true;
+}
+
+bool Scaling::run(int numberOfThreads) {
+  auto config = searcher_.getConfig();
+  config.optimumTimeMs = SearchConfig::InfinityTime;
+  config.maximumTimeMs = SearchConfig::InfinityTime;
+  config.maximumNodes = SearchConfig::InfinityNodes;
+  config.nodesPerMs = 0;
+  config.numberOfThreads = numberOfThreads;
+  config.multiPV = 1;
+  searcher_.setConfig(config);
+
+  const auto& sfens = Bench::positions();
+  int numberOfPositions = std::min(config_.numberOfPositions,
+                                   static_cast<int>(sfens.size()));
+
+  Result result;
+  result.numberOfThreads = numberOfThreads;
+  result.nodes = 0;
+  result.elapsed = 0.0f;
+
+  for (int i = 0; i < numberOfPositions; i++) {
+    Position pos;
+    if (!SfenParser::parsePosition(sfens[i], pos)) {
+      LOG(error) << "invalid SFEN: " << sfens[i];
+      return false;
+    }
+
+    searcher_.clean();
+    // every position starts with a cold evaluation cache.
+    searcher_.getEvaluator()->cache().clear();
+    searcher_.seedRandom(RandomSeed);
+
+    Timer timer;
+    timer.start();
+    searcher_.idsearch(pos, config_.depth * Searcher::Depth1Ply);
+
+    const auto& info = searcher_.getInfo();
+
+    PositionResult pr;
+    pr.elapsed = timer.elapsed();
+    pr.nodes = info.nodes + info.quiesNodes;
+    pr.ttUsageRates = searcher_.ttUsageRates();
+    for (int ti = 0; ti < searcher_.getNumberOfTrees(); ti++) {
+      pr.completedDepths.push_back(searcher_.getCompletedDepth(ti) / Searcher::Depth1Ply);
+    }
+
+    result.nodes += pr.nodes;
+    result.elapsed += pr.elapsed;
+    result.positions.push_back(std::move(pr));
+  }
+
+  MSG(info) << "threads=" << std::setw(3) << numberOfThreads
+            << " nodes=" << result.nodes
+            << " elapsed=" << result.elapsed
+            << " nps=" << static_cast<uint64_t>(nps(result.nodes, result.elapsed));
+
+  results_.push_back(std::move(result));
+
+  return true;
+}
+
+void Scaling::writeCsv(std::ostream& os) const {
+  const auto& base = results_[0];
+
+  os << "threads,position,nodes,elapsed,nps,speedup,duplicate_node_ratio,tt_usage,completed_depths\n";
+  for (const auto& result : results_) {
+    for (size_t i = 0; i < result.positions.size(); i++) {
+      const auto& pr = result.positions[i];
+      const auto& pr1 = base.positions[i];
+      os << result.numberOfThreads << ','
+         << i << ','
+         << pr.nodes << ','
+         << pr.elapsed << ','
+         << static_cast<uint64_t>(nps(pr.nodes, pr.elapsed)) << ','
+         << speedup(pr1.elapsed, pr.elapsed) << ','
+         << duplicateNodeRatio(pr1.nodes, pr.nodes) << ','
+         << pr.ttUsageRates << ',';
+      for (size_t ti = 0; ti < pr.completedDepths.size(); ti++) {
+        os << (ti == 0 ? "" : ";") << pr.completedDepths[ti];
+      }
+      os << '\n';
+    }
+    os << result.numberOfThreads << ','
+       << "all" << ','
+       << result.nodes << ','
+       << result.elapsed << ','
+       << static_cast<uint64_t>(nps(result.nodes, result.elapsed)) << ','
+       << speedup(base.elapsed, result.elapsed) << ','
+       << duplicateNodeRatio(base.nodes, result.nodes) << ','
+       << ',' << '\n';
+  }
+}
+
+void Scaling::writeJson(std::ostream& os) const {
+  const auto& base = results_[0];
+
+  os << "{\n";
+  os << "  \"depth\": " << config_.depth << ",\n";
+  os << "  \"results\": [\n";
+  for (size_t ri = 0; ri < results_.size(); ri++) {
+    const auto& result = results_[ri];
+    os << "    {\n";
+    os << "      \"threads\": " << result.numberOfThreads << ",\n";
+    os << "      \"nodes\": " << result.nodes << ",\n";
+    os << "      \"elapsed\": " << result.elapsed << ",\n";
+    os << "      \"nps\": " << static_cast<uint64_t>(nps(result.nodes, result.elapsed)) << ",\n";
+    os << "      \"speedup\": " << speedup(base.elapsed, result.elapsed) << ",\n";
+    os << "      \"duplicateNodeRatio\": " << duplicateNodeRatio(base.nodes, result.nodes) << ",\n";
+    os << "      \"positions\": [\n";
+    for (size_t i = 0; i < result.positions.size(); i++) {
+      const auto& pr = result.positions[i];
+      const auto& pr1 = base.positions[i];
+      os << "        { "
+         << "\"nodes\": " << pr.nodes << ", "
+         << "\"elapsed\": " << pr.elapsed << ", "
+         << "\"nps\": " << static_cast<uint64_t>(nps(pr.nodes, pr.elapsed)) << ", "
+         << "\"speedup\": " << speedup(pr1.elapsed, pr.elapsed) << ", "
+         << "\"duplicateNodeRatio\": " << duplicateNodeRatio(pr1.nodes, pr.nodes) << ", "
+         << "\"ttUsage\": " << pr.ttUsageRates << ", "
+         << "\"completedDepths\": [";
+      for (size_t ti = 0; ti < pr.completedDepths.size(); ti++) {
+        os << (ti == 0 ? "" : ", ") << pr.completedDepths[ti];
+      }
+      os << "] }" << (i + 1 < result.positions.size() ? "," : "") << "\n";
+    }
+    os << "      ]\n";
+    os << "    }" << (ri + 1 < results_.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
+
+} // namespace sunfish
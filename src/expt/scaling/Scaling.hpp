@@ -0,0 +1,84 @@
+/* Scaling.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_EXPT_SCALING_SCALING_HPP__
+#define SUNFISH_EXPT_SCALING_SCALING_HPP__
+
+#include "search/Searcher.hpp"
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * Scaling searches the bench positions to a fixed depth with
+ * 1, 2, 4, ... threads and reports how the search scales.
+ */
+class Scaling {
+public:
+
+  enum class Format {
+    Csv,
+    Json,
+  };
+
+  struct Config {
+    int depth;
+    int maximumThreads;
+    int numberOfPositions;
+    unsigned hashMebiBytes;
+    Format format;
+  };
+
+  struct PositionResult {
+    uint64_t nodes;
+    float elapsed;
+    float ttUsageRates;
+    std::vector<int> completedDepths;
+  };
+
+  struct Result {
+    int numberOfThreads;
+    uint64_t nodes;
+    float elapsed;
+    std::vector<PositionResult> positions;
+  };
+
+  Scaling();
+
+  bool run(std::ostream& os);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  const std::vector<Result>& getResults() const {
+    return results_;
+  }
+
+private:
+
+  bool run(int numberOfThreads);
+
+  void writeCsv(std::ostream& os) const;
+
+  void writeJson(std::ostream& os) const;
+
+private:
+
+  Config config_;
+  std::vector<Result> results_;
+  Searcher searcher_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_EXPT_SCALING_SCALING_HPP__
@@ -12,39 +12,58 @@
 #include "logger/Logger.hpp"
 
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
 #include <cstdlib>
 
+namespace {
+
+using namespace sunfish;
+
+void mergeResult(Solver::Result& dst, const Solver::Result& src) {
+  dst.corrected   += src.corrected;
+  dst.incorrected += src.incorrected;
+  dst.mate        += src.mate;
+  dst.nodes       += src.nodes;
+  dst.elapsed     += src.elapsed;
+  for (int i = 0; i < Solver::MaxDepthOfNodeCount; i++) {
+    dst.nodesEachDepth[i].nodes  += src.nodesEachDepth[i].nodes;
+    dst.nodesEachDepth[i].sample += src.nodesEachDepth[i].sample;
+  }
+}
+
+} // namespace
+
 namespace sunfish {
 
-Solver::Solver() {
+Solver::Solver() : verbose_(true) {
   searcher_.setHandler(this);
   config_.muximumDepth = 18;
   config_.muximumTimeSeconds = 3;
+  config_.maximumNodes = SearchConfig::InfinityNodes;
   config_.numberOfThreads = 1;
+  config_.numberOfJobs = 1;
+  config_.hashMebiBytes = 0;
   config_.noInterrupt = false;
+  config_.statsIntervalMs = 0;
 }
 
 bool Solver::solve(const char* path) {
   memset(&result_, 0, sizeof(Result));
 
-  if (FileUtil::isDirectory(path)) {
+  Directory::Files files;
+  bool isDirectory = FileUtil::isDirectory(path);
+  if (isDirectory) {
     // 'path' points to a directory
     Directory directory(path);
-    auto files = directory.files("*.csa");
-    int n = 0;
-    for (const auto& path : files) {
-      n++;
-      MSG(info) << "------------------------ [" << n << "] ------------------------";
-      if (!solveCsaFile(path.c_str())) {
-        return false;
-      }
-    }
+    files = directory.files("*.csa");
 
   } else if (FileUtil::isFile(path)) {
     // 'path' points to a file
-    if (!solveCsaFile(path)) {
-      return false;
-    }
+    files.push_back(path);
 
   } else {
     // a specified path is not available.
@@ -52,6 +71,46 @@ bool Solver::solve(const char* path) {
     return false;
   }
 
+  if (config_.numberOfJobs <= 1) {
+    if (config_.hashMebiBytes != 0) {
+      searcher_.ttResizeMB(config_.hashMebiBytes);
+    }
+
+    if (!config_.traceFile.empty()) {
+      searcher_.getTracer().enable();
+    }
+
+    int n = 0;
+    for (const auto& file : files) {
+      n++;
+      if (isDirectory) {
+        MSG(info) << "------------------------ [" << n << "] ------------------------";
+      }
+
+      std::vector<Problem> problems;
+      if (!readProblems(file.c_str(), problems) ||
+          !solveSequentially(problems)) {
+        return false;
+      }
+    }
+
+  } else {
+    if (!config_.traceFile.empty()) {
+      LOG(warning) << "the trace is not written when the problems are solved concurrently";
+    }
+
+    std::vector<Problem> problems;
+    for (const auto& file : files) {
+      if (!readProblems(file.c_str(), problems)) {
+        return false;
+      }
+    }
+
+    if (!solveConcurrently(problems)) {
+      return false;
+    }
+  }
+
   MSG(info) << "--------------------- completed ---------------------";
 
   auto percentage = [](float n, float d) {
@@ -73,13 +132,27 @@ bool Solver::solve(const char* path) {
     }
   }
 
-  return true;
+  return writeTrace();
 }
 
-bool Solver::solveCsaFile(const char* path) {
-  MSG(info) << "[" << path << "]";
-  MSG(info) << "";
+bool Solver::writeTrace() {
+  if (config_.traceFile.empty() || !searcher_.getTracer().isEnabled()) {
+    return true;
+  }
+
+  std::ofstream file(config_.traceFile);
+  if (!file) {
+    LOG(error) << "could not open a file: " << config_.traceFile;
+    return false;
+  }
+
+  searcher_.getTracer().writeChromeTrace(file);
+  MSG(info) << "trace: " << config_.traceFile;
+
+  return true;
+}
 
+bool Solver::readProblems(const char* path, std::vector<Problem>& problems) {
   std::ifstream file(path);
   if (!file) {
     LOG(error) << "could not open a file: " << path;
@@ -95,9 +168,7 @@ bool Solver::solveCsaFile(const char* path) {
   Position position = record.initialPosition;
 
   for (const auto& move : record.moveList) {
-    if (!solve(position, move)) {
-      return false;
-    }
+    problems.push_back({ position, move });
 
     Piece captured;
     if (!position.doMove(move, captured)) {
@@ -111,17 +182,91 @@ bool Solver::solveCsaFile(const char* path) {
   return true;
 }
 
+bool Solver::solveSequentially(const std::vector<Problem>& problems) {
+  for (const auto& problem : problems) {
+    if (!solve(problem.position, problem.correct)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Solver::solveConcurrently(const std::vector<Problem>& problems) {
+  if (searcher_.getEvaluator()->dataSourceType() != Evaluator::DataSourceType::EvalBin) {
+    LOG(error) << "eval.bin is required";
+    return false;
+  }
+
+  int numberOfJobs = std::min(config_.numberOfJobs, static_cast<int>(problems.size()));
+  MSG(info) << "problems: " << problems.size();
+  MSG(info) << "jobs    : " << numberOfJobs;
+
+  std::atomic<size_t> next(0);
+  std::mutex mutex;
+
+  // each job has an independent searcher.
+  // the evaluator is shared because it is read-only while searching.
+  auto worker = [this, &problems, &next, &mutex]() {
+    std::unique_ptr<Solver> solver(new Solver());
+    solver->config_ = config_;
+    solver->verbose_ = false;
+    memset(&solver->result_, 0, sizeof(Result));
+    if (config_.hashMebiBytes != 0) {
+      solver->searcher_.ttResizeMB(config_.hashMebiBytes);
+    }
+
+    while (true) {
+      size_t index = next.fetch_add(1);
+      if (index >= problems.size()) {
+        break;
+      }
+
+      const auto& problem = problems[index];
+      unsigned corrected = solver->result_.corrected;
+      solver->solve(problem.position, problem.correct);
+
+      const auto& result = solver->searcher_.getResult();
+      std::lock_guard<std::mutex> lock(mutex);
+      MSG(info) << "[" << (index + 1) << "] "
+                << (solver->result_.corrected != corrected ? "correct  " : "incorrect")
+                << " answer=" << result.move.toString(problem.position)
+                << " correct=" << problem.correct.toString(problem.position)
+                << " score=" << result.score
+                << " elapsed=" << result.elapsed;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    mergeResult(result_, solver->result_);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numberOfJobs; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return true;
+}
+
 bool Solver::solve(const Position& position, Move correct) {
   if (searcher_.getEvaluator()->dataSourceType() != Evaluator::DataSourceType::EvalBin) {
     LOG(error) << "eval.bin is required";
     return false;
   }
 
-  MSG(info) << StringUtil::chomp(position.toString());
+  if (verbose_) {
+    MSG(info) << StringUtil::chomp(position.toString());
+  }
 
   auto config = searcher_.getConfig();
   config.maximumTimeMs = config_.muximumTimeSeconds * 1000;
   config.optimumTimeMs = SearchConfig::InfinityTime;
+  config.maximumNodes = config_.maximumNodes;
+  config.statsIntervalMs = verbose_ ? config_.statsIntervalMs : 0;
   config.numberOfThreads = config_.numberOfThreads;
   searcher_.setConfig(config);
 
@@ -132,7 +277,7 @@ bool Solver::solve(const Position& position, Move correct) {
   searcher_.idsearch(position, depth);
 
   auto& result = searcher_.getResult();
-  auto& info = searcher_.getInfo();
+  const auto& info = searcher_.getInfo();
   bool isCorrect = result.move == correct;
 
   if (isCorrect) {
@@ -148,18 +293,22 @@ bool Solver::solve(const Position& position, Move correct) {
     result_.elapsed += result.elapsed;
   }
 
-  printSearchInfo(MSG(info), info, result.elapsed);
-  MSG(info) << "";
-  MSG(info) << "answer : " << result.move.toString(position);
-  MSG(info) << "correct: " << correct.toString(position);
-  MSG(info) << "result : " << (isCorrect ? "correct" : "incorrect");
-  MSG(info) << "";
+  if (verbose_) {
+    printSearchInfo(MSG(info), info, result.elapsed);
+    MSG(info) << "";
+    MSG(info) << "answer : " << result.move.toString(position);
+    MSG(info) << "correct: " << correct.toString(position);
+    MSG(info) << "result : " << (isCorrect ? "correct" : "incorrect");
+    MSG(info) << "";
+  }
 
   return true;
 }
 
 void Solver::onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, int multiPV) {
-  LoggingSearchHandler::onUpdatePV(searcher, pv, elapsed, depth, score, multiPV);
+  if (verbose_) {
+    LoggingSearchHandler::onUpdatePV(searcher, pv, elapsed, depth, score, multiPV);
+  }
   if (!config_.noInterrupt &&
       multiPV == 1 &&
       depth >= 5 &&
@@ -169,9 +318,26 @@ void Solver::onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, i
   }
 }
 
+void Solver::onFailLow(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) {
+  if (verbose_) {
+    LoggingSearchHandler::onFailLow(searcher, pv, elapsed, depth, score);
+  }
+}
+
+void Solver::onFailHigh(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) {
+  if (verbose_) {
+    LoggingSearchHandler::onFailHigh(searcher, pv, elapsed, depth, score);
+  }
+}
+
+void Solver::onStats(const Searcher& searcher, float elapsed) {
+  if (verbose_) {
+    LoggingSearchHandler::onStats(searcher, elapsed);
+  }
+}
+
 void Solver::onIterateEnd(const Searcher& searcher, float elapsed, int depth) {
-  LoggingSearchHandler::onIterateEnd(searcher, elapsed, depth);
-  auto& info = searcher.getInfo();
+  const auto& info = searcher.getInfo();
   auto realDepth = depth / Searcher::Depth1Ply;
   if (realDepth >= 1 && realDepth <= MaxDepthOfNodeCount) {
     auto i = realDepth - 1;
@@ -10,6 +10,7 @@
 #include "core/move/Move.hpp"
 #include "search/Searcher.hpp"
 #include <string>
+#include <vector>
 #include <cstdint>
 
 namespace sunfish {
@@ -20,8 +21,16 @@ public:
   struct Config {
     int muximumDepth;
     SearchConfig::TimeType muximumTimeSeconds;
+    SearchConfig::NodesType maximumNodes;
     int numberOfThreads;
+    /** the number of problems solved concurrently */
+    int numberOfJobs;
+    /** the TT size of each searcher, or 0 to keep the default size */
+    unsigned hashMebiBytes;
     bool noInterrupt;
+    SearchConfig::TimeType statsIntervalMs;
+    /** the path of a Chrome trace JSON file, or empty */
+    std::string traceFile;
   };
 
   struct Nodes {
@@ -59,19 +68,34 @@ public:
 
   void onIterateEnd(const Searcher& searcher, float elapsed, int depth) override;
   void onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, int multiPV) override;
+  void onFailLow(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
+  void onFailHigh(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
+  void onStats(const Searcher& searcher, float elapsed) override;
 
 private:
 
-  bool solveCsaFile(const char* path);
+  struct Problem {
+    Position position;
+    Move correct;
+  };
+
+  bool readProblems(const char* path, std::vector<Problem>& problems);
+
+  bool solveSequentially(const std::vector<Problem>& problems);
+
+  bool solveConcurrently(const std::vector<Problem>& problems);
 
   bool solve(const Position& position, Move correct);
 
+  bool writeTrace();
+
 private:
 
   Searcher searcher_;
   Config config_;
   Result result_;
   Move correct_;
+  bool verbose_;
 
 };
 
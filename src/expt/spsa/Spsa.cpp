@@ -0,0 +1,258 @@
+/* Spsa.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "expt/spsa/Spsa.hpp"
+#include "match/Game.hpp"
+#include "search/SearchParam.hpp"
+#include "search/bench/Bench.hpp"
+#include "core/record/SfenParser.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+using namespace sunfish;
+
+/** the decay exponents recommended by Spall */
+CONSTEXPR_CONST double Alpha = 0.602;
+CONSTEXPR_CONST double Gamma = 0.101;
+
+int clampValue(int id, double value) {
+  const auto& info = SearchParam::getInfo(id);
+  int v = static_cast<int>(std::lround(value));
+  return std::min(std::max(v, info.minimumValue), info.maximumValue);
+}
+
+int resultOfBlack(Game::Result result) {
+  switch (result) {
+  case Game::Result::BlackWin: return 1;
+  case Game::Result::WhiteWin: return -1;
+  default: return 0;
+  }
+}
+
+} // namespace
+
+namespace sunfish {
+
+Spsa::Spsa() {
+  config_.iterations = 100;
+  config_.gamePairs = 1;
+  config_.numberOfJobs = 1;
+  config_.nodes = 20000;
+  config_.byoyomiMs = 0;
+  config_.maximumPlies = 256;
+  config_.hashMebiBytes = 16;
+  config_.learningRate = 0.02;
+  config_.stability = -1.0;
+}
+
+bool Spsa::run(std::ostream& os) {
+  if (!setup()) {
+    return false;
+  }
+
+  double stability = config_.stability >= 0.0
+                   ? config_.stability
+                   : config_.iterations * 0.1;
+
+  MSG(info) << "engine    : " << config_.enginePath;
+  MSG(info) << "parameters: " << parameters_.size();
+  MSG(info) << "iterations: " << config_.iterations;
+  MSG(info) << "game pairs: " << config_.gamePairs;
+  MSG(info) << "jobs      : " << config_.numberOfJobs;
+
+  std::vector<int> plusValues(parameters_.size());
+  std::vector<int> minusValues(parameters_.size());
+  std::vector<int> deltas(parameters_.size());
+
+  for (int k = 0; k < config_.iterations; k++) {
+    double ck = 1.0 / std::pow(k + 1, Gamma);
+    double rk = config_.learningRate * std::pow((stability + 1.0) / (stability + k + 1.0), Alpha);
+
+    for (size_t i = 0; i < parameters_.size(); i++) {
+      const auto& param = parameters_[i];
+      double c = param.perturbation * ck;
+      deltas[i] = random_.bit() ? 1 : -1;
+      plusValues[i] = clampValue(param.id, param.value + c * deltas[i]);
+      minusValues[i] = clampValue(param.id, param.value - c * deltas[i]);
+    }
+
+    int result = playGames(plusValues, minusValues);
+
+    std::ostringstream oss;
+    for (size_t i = 0; i < parameters_.size(); i++) {
+      auto& param = parameters_[i];
+      const auto& info = SearchParam::getInfo(param.id);
+      double c = param.perturbation * ck;
+      param.value += rk * c * result * deltas[i];
+      param.value = std::min(std::max(param.value, static_cast<double>(info.minimumValue)),
+                             static_cast<double>(info.maximumValue));
+      oss << ' ' << info.name << '=' << param.value;
+    }
+
+    MSG(info) << "iteration " << (k + 1) << '/' << config_.iterations
+              << " result=" << result << oss.str();
+  }
+
+  workers_.clear();
+
+  for (const auto& param : parameters_) {
+    os << "#define " << SearchParam::getInfo(param.id).name
+       << ' ' << clampValue(param.id, param.value) << '\n';
+  }
+
+  return true;
+}
+
+bool Spsa::setup() {
+  if (config_.iterations < 1 || config_.gamePairs < 1 || config_.numberOfJobs < 1) {
+    LOG(error) << "invalid configuration";
+    return false;
+  }
+
+  parameters_.clear();
+  if (config_.parameters.empty()) {
+    for (int id = 0; id < SearchParam::Num; id++) {
+      config_.parameters.push_back(SearchParam::getInfo(id).name);
+    }
+  }
+  for (const auto& name : config_.parameters) {
+    int id = SearchParam::find(name.c_str());
+    if (id == -1) {
+      LOG(error) << "unknown parameter: " << name;
+      return false;
+    }
+    const auto& info = SearchParam::getInfo(id);
+    Parameter param;
+    param.id = id;
+    param.value = info.defaultValue;
+    param.perturbation = std::max((info.maximumValue - info.minimumValue) / 20.0, 1.0);
+    parameters_.push_back(param);
+  }
+
+  openings_.clear();
+  for (const auto& sfen : Bench::positions()) {
+    Position pos;
+    if (!SfenParser::parsePosition(sfen, pos)) {
+      LOG(error) << "invalid SFEN: " << sfen;
+      return false;
+    }
+    openings_.push_back(pos);
+  }
+
+  workers_.clear();
+  for (int i = 0; i < config_.numberOfJobs; i++) {
+    std::unique_ptr<Worker> worker(new Worker());
+    if (!startEngine(worker->plus) || !startEngine(worker->minus)) {
+      return false;
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  return true;
+}
+
+bool Spsa::startEngine(UsiEngine& engine) {
+  if (!engine.start(config_.enginePath)) {
+    return false;
+  }
+
+  for (const auto& param : parameters_) {
+    const char* name = SearchParam::getInfo(param.id).name;
+    if (!engine.hasOption(name)) {
+      LOG(error) << "the engine does not have the option " << name
+                 << ". (the engine must be built with TUNING=ON)";
+      return false;
+    }
+  }
+
+  engine.setOption("USI_Ponder", "false");
+  engine.setOption("USI_Hash", config_.hashMebiBytes);
+  engine.setOption("UseBook", "false");
+  engine.setOption("Threads", 1);
+
+  return true;
+}
+
+int Spsa::playGames(const std::vector<int>& plusValues,
+                    const std::vector<int>& minusValues) {
+  // the openings are selected before the workers start
+  // because the random generator is not thread-safe.
+  std::vector<size_t> openingIndices;
+  for (int i = 0; i < config_.gamePairs; i++) {
+    openingIndices.push_back(random_.int32(static_cast<uint32_t>(openings_.size())));
+  }
+
+  std::atomic<int> next(0);
+  std::atomic<int> total(0);
+
+  auto setOptions = [this](UsiEngine& engine, const std::vector<int>& values) {
+    for (size_t i = 0; i < parameters_.size(); i++) {
+      engine.setOption(SearchParam::getInfo(parameters_[i].id).name, values[i]);
+    }
+  };
+
+  auto work = [&](Worker& worker) {
+    setOptions(worker.plus, plusValues);
+    setOptions(worker.minus, minusValues);
+
+    Game game;
+    auto gameConfig = game.getConfig();
+    gameConfig.nodes = config_.nodes;
+    gameConfig.byoyomiMs = config_.byoyomiMs;
+    gameConfig.maximumPlies = config_.maximumPlies;
+    game.setConfig(gameConfig);
+
+    for (;;) {
+      int index = next.fetch_add(1);
+      if (index >= config_.gamePairs) {
+        break;
+      }
+
+      const auto& opening = openings_[openingIndices[index]];
+      for (int g = 0; g < 2; g++) {
+        bool plusIsBlack = g == 0;
+        auto result = plusIsBlack
+                    ? game.play(worker.plus, worker.minus, opening)
+                    : game.play(worker.minus, worker.plus, opening);
+        int r = resultOfBlack(result);
+        total += plusIsBlack ? r : -r;
+
+        // a crashed engine is restarted for the next game.
+        if (game.getReason() == Game::Reason::EngineError) {
+          LOG(warning) << "engine error: restarting the engines";
+          if (startEngine(worker.plus)) {
+            setOptions(worker.plus, plusValues);
+          }
+          if (startEngine(worker.minus)) {
+            setOptions(worker.minus, minusValues);
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < workers_.size(); i++) {
+    Worker* worker = workers_[i].get();
+    threads.emplace_back([&work, worker]() {
+      work(*worker);
+    });
+  }
+  work(*workers_[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return total.load();
+}
+
+} // namespace sunfish
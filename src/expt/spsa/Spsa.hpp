@@ -0,0 +1,105 @@
+/* Spsa.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_EXPT_SPSA_SPSA_HPP__
+#define SUNFISH_EXPT_SPSA_SPSA_HPP__
+
+#include "match/UsiEngine.hpp"
+#include "common/math/Random.hpp"
+#include "core/position/Position.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * Spsa tunes the parameters of SearchParam by SPSA.
+ * Each iteration plays game pairs between the engines which have
+ * the parameters perturbed in the opposite directions,
+ * and moves the parameters toward the winner.
+ * The engine must be built with TUNING=ON.
+ */
+class Spsa {
+public:
+
+  struct Config {
+    /** the path of the USI engine */
+    std::string enginePath;
+    /** the names of the tuned parameters (empty: all) */
+    std::vector<std::string> parameters;
+    int iterations;
+    /** the number of game pairs of each iteration */
+    int gamePairs;
+    /** the number of games played concurrently */
+    int numberOfJobs;
+    /** the number of nodes for each move (0: unlimited) */
+    uint64_t nodes;
+    /** the time for each move (0: unlimited) */
+    int byoyomiMs;
+    int maximumPlies;
+    unsigned hashMebiBytes;
+    /** the step size of the first iteration in the units of the perturbation */
+    double learningRate;
+    /** the stability constant A (negative: 10% of the iterations) */
+    double stability;
+  };
+
+  struct Parameter {
+    int id;
+    double value;
+    /** the perturbation of the first iteration */
+    double perturbation;
+  };
+
+  Spsa();
+
+  bool run(std::ostream& os);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  const std::vector<Parameter>& getParameters() const {
+    return parameters_;
+  }
+
+private:
+
+  struct Worker {
+    UsiEngine plus;
+    UsiEngine minus;
+  };
+
+  bool setup();
+
+  bool startEngine(UsiEngine& engine);
+
+  /**
+   * Play the game pairs and return the sum of the results of
+   * the plus engine. (win: +1, draw: 0, loss: -1)
+   */
+  int playGames(const std::vector<int>& plusValues,
+                const std::vector<int>& minusValues);
+
+private:
+
+  Config config_;
+  std::vector<Parameter> parameters_;
+  std::vector<Position> openings_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Random random_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_EXPT_SPSA_SPSA_HPP__
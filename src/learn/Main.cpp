@@ -12,6 +12,7 @@
 #include "search/util/SearchUtil.hpp"
 #include "learn/batch/BatchLearning.hpp"
 #include "learn/online/OnlineLearning.hpp"
+#include "learn/selfplay/SelfPlay.hpp"
 #include "learn/training_data/TrainingData.hpp"
 #include "learn/util/LearningUtil.hpp"
 #include "logger/Logger.hpp"
@@ -41,6 +42,13 @@ int main(int argc, char** argv, char**) {
   po.addOption("gen-td-csa", "csa", "generate training data file from CSA files");
   po.addOption("optimize", "o", "convert from expanded FV(eval-ex.bin) to optimized FV(eval.bin)");
   po.addOption("merge", "g", "merge expanded FV files");
+  po.addOption("selfplay", "generate training data by self-play games into the specified directory", true);
+  po.addOption("games", "a number of games of --selfplay", true);
+  po.addOption("threads", "r", "a number of games played concurrently by --selfplay", true);
+  po.addOption("depth", "d", "a depth of search for each move of --selfplay", true);
+  po.addOption("hash", "a TT size of each thread of --selfplay in MiB", true);
+  po.addOption("random-plies", "a number of plies in which --selfplay selects a move randomly from the best moves", true);
+  po.addOption("max-plies", "a maximum number of plies of each game of --selfplay", true);
   po.addOption("help", "h", "show this help");
   po.parse(argc, argv);
 
@@ -163,6 +171,32 @@ int main(int argc, char** argv, char**) {
     Loggers::receive.addStream(fout, true, true);
   }
 
+  if (po.has("selfplay")) {
+    SelfPlay selfPlay;
+    auto config = selfPlay.getConfig();
+    config.outputDirectory = po.getValue("selfplay");
+    if (po.has("games")) {
+      config.numberOfGames = std::stoi(po.getValue("games"));
+    }
+    if (po.has("threads")) {
+      config.numberOfThreads = std::stoi(po.getValue("threads"));
+    }
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    }
+    if (po.has("hash")) {
+      config.hashMebiBytes = std::stoi(po.getValue("hash"));
+    }
+    if (po.has("random-plies")) {
+      config.randomPlies = std::stoi(po.getValue("random-plies"));
+    }
+    if (po.has("max-plies")) {
+      config.maximumPlies = std::stoi(po.getValue("max-plies"));
+    }
+    selfPlay.setConfig(config);
+    return selfPlay.run() ? 0 : 1;
+  }
+
   if (po.getValue("type") == std::string("online")) {
 #if !MATERIAL_LEARNING_ONLY
     OnlineLearning online;
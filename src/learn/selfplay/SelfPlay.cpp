@@ -0,0 +1,272 @@
+/* SelfPlay.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "learn/selfplay/SelfPlay.hpp"
+#include "search/Searcher.hpp"
+#include "search/shek/GameHistory.hpp"
+#include "core/move/Moves.hpp"
+#include "core/move/MoveGenerator.hpp"
+#include "common/time/Timer.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+using namespace sunfish;
+
+CONSTEXPR_CONST int ProgressInterval = 100;
+
+std::string outputPath(const std::string& dir, int index, const char* ext) {
+  std::ostringstream oss;
+  oss << dir << "/selfplay-" << index << ext;
+  return oss.str();
+}
+
+SelfPlay::Result winOf(Turn turn) {
+  return turn == Turn::Black ? SelfPlay::Result::BlackWin : SelfPlay::Result::WhiteWin;
+}
+
+SelfPlay::Result lossOf(Turn turn) {
+  return turn == Turn::Black ? SelfPlay::Result::WhiteWin : SelfPlay::Result::BlackWin;
+}
+
+} // namespace
+
+namespace sunfish {
+
+SelfPlay::SelfPlay() {
+  config_.outputDirectory = "selfplay";
+  config_.numberOfGames = 1000;
+  config_.numberOfThreads = 1;
+  config_.depth = 6;
+  config_.hashMebiBytes = 16;
+  config_.maximumPlies = 256;
+  config_.randomPlies = 16;
+  config_.randomMultiPV = 4;
+  config_.randomMargin = 100;
+  config_.resignScore = 3000;
+}
+
+bool SelfPlay::run() {
+  if (config_.numberOfGames < 1 || config_.numberOfThreads < 1 ||
+      config_.depth < 1 || config_.randomMultiPV < 1) {
+    LOG(error) << "invalid configuration";
+    return false;
+  }
+
+  evaluator_ = Evaluator::sharedEvaluator();
+
+  int numberOfThreads = std::min(config_.numberOfThreads, config_.numberOfGames);
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int i = 0; i < numberOfThreads; i++) {
+    std::unique_ptr<Thread> th(new Thread());
+    if (!openFiles(*th, i)) {
+      return false;
+    }
+    th->searcher.reset(new Searcher(evaluator_));
+    th->searcher->ttResizeMB(config_.hashMebiBytes);
+    th->random.seed(static_cast<unsigned>(time(nullptr)) + i);
+    th->plies = 0;
+    threads.push_back(std::move(th));
+  }
+
+  nextGame_ = 0;
+  finishedGames_ = 0;
+  for (auto& result : results_) {
+    result = 0;
+  }
+
+  MSG(info) << "self-play: games=" << config_.numberOfGames
+            << " threads=" << numberOfThreads
+            << " depth=" << config_.depth;
+
+  Timer timer;
+  timer.start();
+
+  for (auto& th : threads) {
+    Thread* p = th.get();
+    th->thread = std::thread([this, p]() {
+      work(*p);
+    });
+  }
+
+  uint64_t plies = 0;
+  for (auto& th : threads) {
+    th->thread.join();
+    th->writer.close();
+    th->labelFile.close();
+    plies += th->plies;
+  }
+
+  float elapsed = timer.elapsed();
+  MSG(info) << "games: " << finishedGames_.load()
+            << " (black " << results_[static_cast<int>(Result::BlackWin) + 1].load()
+            << ", white " << results_[static_cast<int>(Result::WhiteWin) + 1].load()
+            << ", draw " << results_[static_cast<int>(Result::Draw) + 1].load() << ")";
+  MSG(info) << "positions: " << plies
+            << " (" << static_cast<uint64_t>(plies / std::max(elapsed, 1.0e-3f)) << "/s)";
+  MSG(info) << "elapsed: " << elapsed << "s";
+
+  return true;
+}
+
+bool SelfPlay::openFiles(Thread& th, int index) {
+  if (!th.writer.open(outputPath(config_.outputDirectory, index, ".dat"))) {
+    return false;
+  }
+
+  auto labelPath = outputPath(config_.outputDirectory, index, ".lbl");
+  th.labelFile.open(labelPath, std::ios::out | std::ios::binary);
+  if (!th.labelFile) {
+    LOG(error) << "could not open a file: " << labelPath;
+    return false;
+  }
+
+  return true;
+}
+
+void SelfPlay::work(Thread& th) {
+  Record record;
+  std::vector<int16_t> scores;
+
+  while (nextGame_.fetch_add(1) < config_.numberOfGames) {
+    Result result = play(th, record, scores);
+
+    th.writer.write(record);
+    writeLabels(th, result, scores);
+    th.plies += record.moveList.size();
+
+    results_[static_cast<int>(result) + 1]++;
+    int finished = ++finishedGames_;
+    if (finished % ProgressInterval == 0) {
+      MSG(info) << finished << " games";
+    }
+  }
+}
+
+SelfPlay::Result SelfPlay::play(Thread& th,
+                                Record& record,
+                                std::vector<int16_t>& scores) {
+  record.initialPosition.initialize(Position::Handicap::Even);
+  record.moveList.clear();
+  scores.clear();
+
+  auto& searcher = *th.searcher;
+  searcher.clean();
+
+  auto searchConfig = searcher.getConfig();
+  searchConfig.numberOfThreads = 1;
+  searchConfig.optimumTimeMs = SearchConfig::InfinityTime;
+  searchConfig.maximumTimeMs = SearchConfig::InfinityTime;
+
+  Position pos = record.initialPosition;
+  GameHistory history;
+  history.reset(pos);
+  std::vector<Zobrist::Type> hashes = { pos.getHash() };
+  std::vector<bool> checks = { false };
+
+  for (int ply = 0; ply < config_.maximumPlies; ply++) {
+    Turn turn = pos.getTurn();
+
+    Moves moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
+    if (moves.size() == 0) {
+      return lossOf(turn);
+    }
+
+    bool random = ply < config_.randomPlies;
+    searchConfig.multiPV = random ? std::min(config_.randomMultiPV, static_cast<int>(moves.size())) : 1;
+    searcher.setConfig(searchConfig);
+    searcher.idsearch(pos, config_.depth * Searcher::Depth1Ply, &history);
+
+    const auto& result = searcher.getResult();
+    Move move = result.move;
+    Score score = result.score;
+    if (move.isNone()) {
+      return lossOf(turn);
+    }
+
+    if (random) {
+      // select a move randomly from the moves close to the best move.
+      // the root PVs of the last iteration have one entry for each move.
+      std::vector<const RootPV*> candidates;
+      for (const auto& rootPV : searcher.getRootPVs()) {
+        if (rootPV.pv.size() != 0 && rootPV.score >= score - config_.randomMargin) {
+          candidates.push_back(&rootPV);
+        }
+      }
+      if (!candidates.empty()) {
+        auto index = th.random.int32(static_cast<uint32_t>(candidates.size()));
+        move = candidates[index]->pv.getMove(0);
+        score = candidates[index]->score;
+      }
+    }
+
+    Piece captured;
+    if (!pos.doMove(move, captured)) {
+      LOG(error) << "an illegal move is detected: " << move.toString(pos) << "\n"
+                 << pos.toString();
+      return Result::Draw;
+    }
+    history.append(move);
+
+    int raw = score.raw();
+    record.moveList.push_back(move);
+    scores.push_back(static_cast<int16_t>(turn == Turn::Black ? raw : -raw));
+
+    if (score >= Score::mate() || score >= config_.resignScore) {
+      return winOf(turn);
+    }
+    if (score <= -Score::mate() || score <= -config_.resignScore) {
+      return lossOf(turn);
+    }
+
+    // repetition: the same position appears 4 times.
+    hashes.push_back(pos.getHash());
+    checks.push_back(pos.inCheck());
+    int n = static_cast<int>(hashes.size()) - 1;
+    int count = 0;
+    int last = -1;
+    for (int i = n - 4; i >= 0; i -= 2) {
+      if (hashes[i] == hashes[n]) {
+        count++;
+        if (last == -1) {
+          last = i;
+        }
+      }
+    }
+
+    if (count >= 3) {
+      // perpetual check: every move of one side after the last occurrence gives a check.
+      bool perpetual[2] = { true, true };
+      for (int i = last + 1; i <= n; i++) {
+        perpetual[(n - i) % 2] = perpetual[(n - i) % 2] && checks[i];
+      }
+      if (perpetual[0]) {
+        return lossOf(turn);
+      }
+      if (perpetual[1]) {
+        return winOf(turn);
+      }
+      return Result::Draw;
+    }
+  }
+
+  return Result::Draw;
+}
+
+void SelfPlay::writeLabels(Thread& th,
+                           Result result,
+                           const std::vector<int16_t>& scores) {
+  int8_t r = static_cast<int8_t>(result);
+  uint16_t plies = static_cast<uint16_t>(scores.size());
+  th.labelFile.write(reinterpret_cast<const char*>(&r), sizeof(r));
+  th.labelFile.write(reinterpret_cast<const char*>(&plies), sizeof(plies));
+  th.labelFile.write(reinterpret_cast<const char*>(scores.data()),
+                     sizeof(int16_t) * scores.size());
+}
+
+} // namespace sunfish
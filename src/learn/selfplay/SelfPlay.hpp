@@ -0,0 +1,105 @@
+/* SelfPlay.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_LEARN_SELFPLAY_SELFPLAY_HPP__
+#define SUNFISH_LEARN_SELFPLAY_SELFPLAY_HPP__
+
+#include "common/math/Random.hpp"
+#include "core/record/Record.hpp"
+#include "search/eval/Evaluator.hpp"
+#include "learn/training_data/TrainingData.hpp"
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+class Searcher;
+
+/**
+ * SelfPlay plays games between shallow searchers on many threads
+ * and writes them as training data.
+ * Each thread owns its output files, so no locks are taken on writing:
+ *   <outputDirectory>/selfplay-<N>.dat: the moves (TrainingDataReader format)
+ *   <outputDirectory>/selfplay-<N>.lbl: the labels of each game
+ *     int8_t  result (1: black win, 0: draw, -1: white win)
+ *     uint16_t the number of plies
+ *     int16_t  the score of each ply from black's point of view
+ */
+class SelfPlay {
+public:
+
+  struct Config {
+    std::string outputDirectory;
+    int numberOfGames;
+    int numberOfThreads;
+    /** the depth for each move */
+    int depth;
+    /** the size of TT of each thread */
+    unsigned hashMebiBytes;
+    int maximumPlies;
+    /** the number of plies in which a move is selected randomly from the best moves */
+    int randomPlies;
+    int randomMultiPV;
+    /** the maximum score difference between a random move and the best move */
+    int randomMargin;
+    /** the game is adjudicated when the absolute score reaches this value */
+    int resignScore;
+  };
+
+  enum class Result : int8_t {
+    WhiteWin = -1,
+    Draw = 0,
+    BlackWin = 1,
+  };
+
+  SelfPlay();
+
+  bool run();
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+private:
+
+  struct Thread {
+    std::thread thread;
+    std::unique_ptr<Searcher> searcher;
+    Random random;
+    TrainingDataWriter writer;
+    std::ofstream labelFile;
+    uint64_t plies;
+  };
+
+  bool openFiles(Thread& th, int index);
+
+  void work(Thread& th);
+
+  Result play(Thread& th, Record& record, std::vector<int16_t>& scores);
+
+  void writeLabels(Thread& th, Result result, const std::vector<int16_t>& scores);
+
+private:
+
+  Config config_;
+  std::shared_ptr<Evaluator> evaluator_;
+  std::atomic<int> nextGame_;
+  std::atomic<int> finishedGames_;
+  std::atomic<int> results_[3];
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_LEARN_SELFPLAY_SELFPLAY_HPP__
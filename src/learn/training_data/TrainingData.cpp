@@ -7,14 +7,14 @@
 #include "core/record/Record.hpp"
 #include "core/record/CsaReader.hpp"
 #include "common/file_system/Directory.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace sunfish {
 
 bool TrainingDataGenerator::writeToFile(const char* path) const {
-  std::ofstream datFile(path, std::ios::out | std::ios::binary);
-  if (!datFile) {
-    LOG(error) << "could not open a file: " << path;
+  TrainingDataWriter writer;
+  if (!writer.open(path)) {
     return false;
   }
 
@@ -43,25 +43,9 @@ bool TrainingDataGenerator::writeToFile(const char* path) const {
       continue;
     }
 
-    Position pos = record.initialPosition;
-    for (const auto& move : record.moveList) {
-      Piece captured;
-      if (!pos.doMove(move, captured)) {
-        LOG(error) << "an illegal move is detected: " << move.toString(pos) << "\n"
-                   << pos.toString();
-        break;
-      }
-
-      // write move
-      uint16_t m16 = move.serialize16();
-      datFile.write(reinterpret_cast<char*>(&m16), sizeof(m16));
-    }
-
-    // write end-of-moves marker
-    uint16_t n16 = Move::none().serialize16();
-    datFile.write(reinterpret_cast<char*>(&n16), sizeof(n16));
+    writer.write(record);
   }
-  datFile.close();
+  writer.close();
 
   if (error != 0) {
     LOG(warning) << "errors are occured from " << error << " files";
@@ -89,6 +73,47 @@ bool TrainingDataGenerator::appendCsaFiles(const char* dir) {
   return true;
 }
 
+TrainingDataWriter::~TrainingDataWriter() {
+  close();
+}
+
+bool TrainingDataWriter::open(const char* path) {
+  file_.open(path, std::ios::out | std::ios::binary);
+  if (!file_) {
+    LOG(error) << "could not open a file: " << path;
+    return false;
+  }
+  return true;
+}
+
+bool TrainingDataWriter::write(const Record& record) {
+  Position pos = record.initialPosition;
+  for (const auto& move : record.moveList) {
+    Piece captured;
+    if (!pos.doMove(move, captured)) {
+      LOG(error) << "an illegal move is detected: " << move.toString(pos) << "\n"
+                 << pos.toString();
+      break;
+    }
+
+    // write move
+    uint16_t m16 = move.serialize16();
+    file_.write(reinterpret_cast<char*>(&m16), sizeof(m16));
+  }
+
+  // write end-of-moves marker
+  uint16_t n16 = Move::none().serialize16();
+  file_.write(reinterpret_cast<char*>(&n16), sizeof(n16));
+
+  return !file_.fail();
+}
+
+void TrainingDataWriter::close() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+}
+
 TrainingDataReader::~TrainingDataReader() {
   if (file_.is_open()) {
     file_.close();
@@ -96,10 +121,46 @@ TrainingDataReader::~TrainingDataReader() {
 }
 
 bool TrainingDataReader::open(const char* path) {
-  file_.open(path, std::ios::in | std::ios::binary);
-  return !file_.fail();
+  paths_.clear();
+  nextPath_ = 0;
+
+  std::string p = path;
+  auto slash = p.find_last_of('/');
+  std::string name = slash != std::string::npos ? p.substr(slash + 1) : p;
+  if (name.find_first_of("*?") == std::string::npos) {
+    paths_.push_back(p);
+  } else {
+    Directory directory(slash != std::string::npos ? p.substr(0, slash) : ".");
+    auto files = directory.files(name.c_str());
+    paths_.assign(files.begin(), files.end());
+    std::sort(paths_.begin(), paths_.end());
+    if (paths_.empty()) {
+      LOG(error) << "no files match: " << path;
+      return false;
+    }
+  }
+
+  return openNextFile();
 }
 
+bool TrainingDataReader::openNextFile() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+
+  if (nextPath_ >= paths_.size()) {
+    return false;
+  }
+
+  const auto& path = paths_[nextPath_++];
+  file_.clear();
+  file_.open(path, std::ios::in | std::ios::binary);
+  if (file_.fail()) {
+    LOG(error) << "could not open a file: " << path;
+    return false;
+  }
+  return true;
+}
 
 bool TrainingDataReader::read(Record& record) {
   record.initialPosition.initialize(Position::Handicap::Even);
@@ -109,6 +170,10 @@ bool TrainingDataReader::read(Record& record) {
     uint16_t m16;
     file_.read(reinterpret_cast<char*>(&m16), sizeof(m16));
     if (file_.eof()) {
+      // continue with the next file.
+      if (record.moveList.empty() && openNextFile()) {
+        continue;
+      }
       return false;
     } else if (!file_) {
       LOG(error) << "failed to read training data file";
@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <cstdint>
 
 namespace sunfish {
 
@@ -36,9 +37,42 @@ private:
 
 };
 
+/**
+ * TrainingDataWriter writes the moves of records from the initial position.
+ * Each record is terminated by Move::none().
+ */
+class TrainingDataWriter {
+public:
+
+  ~TrainingDataWriter();
+
+  bool open(const char* path);
+
+  bool open(const std::string& path) {
+    return open(path.c_str());
+  }
+
+  bool write(const Record& record);
+
+  void close();
+
+private:
+
+  std::ofstream file_;
+
+};
+
+/**
+ * TrainingDataReader reads the records written by TrainingDataWriter.
+ * If the file name of the path has wildcards (e.g. `selfplay/*.dat'),
+ * all matched files are read in the order of their names.
+ */
 class TrainingDataReader {
 public:
 
+  TrainingDataReader() : nextPath_(0) {
+  }
+
   ~TrainingDataReader();
 
   bool open(const char* path);
@@ -51,7 +85,11 @@ public:
 
 private:
 
+  bool openNextFile();
+
   std::ifstream file_;
+  std::vector<std::string> paths_;
+  size_t nextPath_;
 
 };
 
@@ -0,0 +1,231 @@
+/* Game.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "match/Game.hpp"
+#include "core/move/Moves.hpp"
+#include "core/move/MoveGenerator.hpp"
+#include "core/record/SfenParser.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+using namespace sunfish;
+
+CONSTEXPR_CONST int MateScore = 32000;
+
+/**
+ * the timeout of a go command which is limited only by nodes or depth.
+ */
+CONSTEXPR_CONST int NoTimeLimitTimeoutMs = 10 * 60 * 1000;
+
+Game::Result winOf(Turn turn) {
+  return turn == Turn::Black ? Game::Result::BlackWin : Game::Result::WhiteWin;
+}
+
+Game::Result lossOf(Turn turn) {
+  return turn == Turn::Black ? Game::Result::WhiteWin : Game::Result::BlackWin;
+}
+
+} // namespace
+
+namespace sunfish {
+
+Game::Game() {
+  config_.maximumPlies = 256;
+  config_.nodes = 0;
+  config_.depth = 0;
+  config_.byoyomiMs = 1000;
+  config_.timeoutMarginMs = 5000;
+}
+
+Game::Result Game::play(UsiEngine& black,
+                        UsiEngine& white,
+                        const Position& initialPosition) {
+  record_.initialPosition = initialPosition;
+  record_.moveList.clear();
+  record_.specialMove = "";
+  scores_.clear();
+  for (auto& stats : stats_) {
+    stats.moves = 0;
+    stats.nodes = 0;
+    stats.timeMs = 0;
+    stats.maximumTimeMs = 0;
+  }
+
+  if (!black.newGame()) {
+    record_.specialMove = "%CHUDAN";
+    return finish(black, white, Result::WhiteWin, Reason::EngineError);
+  }
+  if (!white.newGame()) {
+    record_.specialMove = "%CHUDAN";
+    return finish(black, white, Result::BlackWin, Reason::EngineError);
+  }
+
+  std::ostringstream goCommand;
+  goCommand << "btime 0 wtime 0 byoyomi " << config_.byoyomiMs;
+  if (config_.nodes != 0) {
+    goCommand << " nodes " << config_.nodes;
+  }
+  if (config_.depth != 0) {
+    goCommand << " depth " << config_.depth;
+  }
+  int timeoutMs = config_.byoyomiMs != 0
+                ? config_.byoyomiMs + config_.timeoutMarginMs
+                : NoTimeLimitTimeoutMs;
+
+  std::ostringstream positionCommand;
+  positionCommand << "sfen " << initialPosition.toStringSFEN() << " moves";
+
+  Position pos = initialPosition;
+  std::vector<Zobrist::Type> hashes = { pos.getHash() };
+  std::vector<bool> checks = { false };
+
+  for (int ply = 0; ; ply++) {
+    Turn turn = pos.getTurn();
+
+    if (ply >= config_.maximumPlies) {
+      record_.specialMove = "%CHUDAN";
+      return finish(black, white, Result::Draw, Reason::MaximumPlies);
+    }
+
+    Moves moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
+    if (moves.size() == 0) {
+      record_.specialMove = "%TORYO";
+      return finish(black, white, lossOf(turn), Reason::Mate);
+    }
+
+    UsiEngine& engine = turn == Turn::Black ? black : white;
+    UsiEngine::GoResult goResult;
+    if (!engine.go(positionCommand.str(), goCommand.str(), timeoutMs, goResult)) {
+      record_.specialMove = "%CHUDAN";
+      return finish(black, white, lossOf(turn), Reason::EngineError);
+    }
+
+    if (goResult.bestMove == "resign") {
+      record_.specialMove = "%TORYO";
+      return finish(black, white, lossOf(turn), Reason::Resign);
+    }
+
+    // the declaration is not verified.
+    if (goResult.bestMove == "win") {
+      record_.specialMove = "%KACHI";
+      return finish(black, white, winOf(turn), Reason::Declaration);
+    }
+
+    Move move;
+    bool legal = false;
+    if (SfenParser::parseMove(goResult.bestMove, move)) {
+      for (auto legalMove : moves) {
+        if (legalMove == move) {
+          legal = true;
+          break;
+        }
+      }
+    }
+
+    Piece captured;
+    if (!legal || !pos.doMove(move, captured)) {
+      LOG(warning) << engine.getName() << " played an illegal move: " << goResult.bestMove;
+      record_.specialMove = "%ILLEGAL_MOVE";
+      return finish(black, white, lossOf(turn), Reason::IllegalMove);
+    }
+
+    auto& stats = stats_[turn == Turn::Black ? 0 : 1];
+    stats.moves++;
+    stats.nodes += goResult.nodes;
+    stats.timeMs += goResult.elapsedMs;
+    stats.maximumTimeMs = std::max(stats.maximumTimeMs, goResult.elapsedMs);
+
+    int score = 0;
+    if (goResult.hasScore) {
+      score = goResult.isMateScore
+            ? (goResult.score >= 0 ? MateScore : -MateScore)
+            : goResult.score;
+      score = turn == Turn::Black ? score : -score;
+    }
+
+    record_.moveList.push_back(move);
+    scores_.push_back(score);
+    positionCommand << ' ' << goResult.bestMove;
+    hashes.push_back(pos.getHash());
+    checks.push_back(pos.inCheck());
+
+    // repetition: the same position appears 4 times.
+    int n = static_cast<int>(hashes.size()) - 1;
+    int count = 0;
+    int last = -1;
+    for (int i = n - 4; i >= 0; i -= 2) {
+      if (hashes[i] == hashes[n]) {
+        count++;
+        if (last == -1) {
+          last = i;
+        }
+      }
+    }
+
+    if (count >= 3) {
+      record_.specialMove = "%SENNICHITE";
+
+      // perpetual check: every move of one side after the last
+      // occurrence gives a check. checks[i] is true if the i-th move checks.
+      bool perpetual[2] = { true, true };
+      for (int i = last + 1; i <= n; i++) {
+        perpetual[(n - i) % 2] = perpetual[(n - i) % 2] && checks[i];
+      }
+
+      // perpetual[0]: the side which made the last move
+      if (perpetual[0]) {
+        return finish(black, white, lossOf(turn), Reason::PerpetualCheck);
+      }
+      if (perpetual[1]) {
+        return finish(black, white, winOf(turn), Reason::PerpetualCheck);
+      }
+      return finish(black, white, Result::Draw, Reason::Repetition);
+    }
+  }
+}
+
+Game::Result Game::finish(UsiEngine& black,
+                          UsiEngine& white,
+                          Result result,
+                          Reason reason) {
+  reason_ = reason;
+
+  switch (result) {
+  case Result::BlackWin:
+    black.gameOver("win");
+    white.gameOver("lose");
+    break;
+  case Result::WhiteWin:
+    black.gameOver("lose");
+    white.gameOver("win");
+    break;
+  case Result::Draw:
+    black.gameOver("draw");
+    white.gameOver("draw");
+    break;
+  }
+
+  return result;
+}
+
+const char* Game::toString(Reason reason) {
+  switch (reason) {
+  case Reason::Resign: return "resign";
+  case Reason::Mate: return "mate";
+  case Reason::Declaration: return "declaration";
+  case Reason::IllegalMove: return "illegal move";
+  case Reason::EngineError: return "engine error";
+  case Reason::Repetition: return "repetition";
+  case Reason::PerpetualCheck: return "perpetual check";
+  case Reason::MaximumPlies: return "maximum plies";
+  }
+  return "";
+}
+
+} // namespace sunfish
@@ -0,0 +1,121 @@
+/* Game.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_MATCH_GAME_HPP__
+#define SUNFISH_MATCH_GAME_HPP__
+
+#include "match/UsiEngine.hpp"
+#include "core/position/Position.hpp"
+#include "core/record/Record.hpp"
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * Game plays a game between two USI engines and adjudicates it.
+ */
+class Game {
+public:
+
+  enum class Result : uint8_t {
+    BlackWin,
+    WhiteWin,
+    Draw,
+  };
+
+  enum class Reason : uint8_t {
+    Resign,
+    Mate,
+    Declaration,
+    IllegalMove,
+    EngineError,
+    Repetition,
+    PerpetualCheck,
+    MaximumPlies,
+  };
+
+  struct Config {
+    /** the game is a draw when it reaches this number of plies */
+    int maximumPlies;
+    /** the number of nodes for each move (0: unlimited) */
+    uint64_t nodes;
+    /** the depth for each move (0: unlimited) */
+    int depth;
+    /** the time for each move (0: unlimited) */
+    int byoyomiMs;
+    /** the time allowed for each move in addition to byoyomiMs */
+    int timeoutMarginMs;
+  };
+
+  /**
+   * the statistics of the moves made by a player in a game.
+   */
+  struct PlayerStats {
+    int moves;
+    uint64_t nodes;
+    int64_t timeMs;
+    int maximumTimeMs;
+  };
+
+  Game();
+
+  Result play(UsiEngine& black,
+              UsiEngine& white,
+              const Position& initialPosition);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  Reason getReason() const {
+    return reason_;
+  }
+
+  /**
+   * the moves of the last game.
+   * The specialMove is `%TORYO', `%SENNICHITE', ... in CSA format.
+   */
+  const Record& getRecord() const {
+    return record_;
+  }
+
+  /**
+   * the score reported by the engine which made each move.
+   * (from the black's point of view; 0 if the engine did not report it)
+   */
+  const std::vector<int>& getScores() const {
+    return scores_;
+  }
+
+  const PlayerStats& getStats(Turn turn) const {
+    return stats_[turn == Turn::Black ? 0 : 1];
+  }
+
+  static const char* toString(Reason reason);
+
+private:
+
+  Result finish(UsiEngine& black,
+                UsiEngine& white,
+                Result result,
+                Reason reason);
+
+private:
+
+  Config config_;
+  Record record_;
+  std::vector<int> scores_;
+  PlayerStats stats_[2];
+  Reason reason_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_MATCH_GAME_HPP__
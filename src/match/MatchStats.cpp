@@ -0,0 +1,107 @@
+/* MatchStats.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "match/MatchStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/** the 97.5 percentile of the standard normal distribution */
+CONSTEXPR_CONST double Z975 = 1.959963984540054;
+
+/** the scores are kept away from 0 and 1 so that Elo is finite. */
+CONSTEXPR_CONST double ScoreEpsilon = 1.0e-6;
+
+} // namespace
+
+namespace sunfish {
+
+double MatchStats::score() const {
+  int games = getGames();
+  if (games == 0) {
+    return 0.5;
+  }
+  return (wins_ + draws_ * 0.5) / games;
+}
+
+double MatchStats::elo() const {
+  return scoreToElo(score());
+}
+
+double MatchStats::eloError() const {
+  int games = getGames();
+  if (games == 0) {
+    return 0.0;
+  }
+
+  double s = score();
+  double stderror = std::sqrt(variance() / games);
+  double upper = scoreToElo(s + Z975 * stderror);
+  double lower = scoreToElo(s - Z975 * stderror);
+  return (upper - lower) * 0.5;
+}
+
+double MatchStats::los() const {
+  if (wins_ + losses_ == 0) {
+    return 0.5;
+  }
+  return 0.5 * (1.0 + std::erf((wins_ - losses_) / std::sqrt(2.0 * (wins_ + losses_))));
+}
+
+double MatchStats::llr(const SprtConfig& config) const {
+  int games = getGames();
+  double var = variance();
+  if (games == 0 || var <= 0.0) {
+    return 0.0;
+  }
+
+  // the normal approximation of the generalized SPRT
+  double s0 = eloToScore(config.elo0);
+  double s1 = eloToScore(config.elo1);
+  return games * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * var);
+}
+
+MatchStats::SprtResult MatchStats::sprt(const SprtConfig& config) const {
+  double value = llr(config);
+  if (value >= upperBound(config)) {
+    return SprtResult::AcceptH1;
+  }
+  if (value <= lowerBound(config)) {
+    return SprtResult::AcceptH0;
+  }
+  return SprtResult::Continue;
+}
+
+double MatchStats::lowerBound(const SprtConfig& config) {
+  return std::log(config.beta / (1.0 - config.alpha));
+}
+
+double MatchStats::upperBound(const SprtConfig& config) {
+  return std::log((1.0 - config.beta) / config.alpha);
+}
+
+double MatchStats::scoreToElo(double score) {
+  score = std::min(std::max(score, ScoreEpsilon), 1.0 - ScoreEpsilon);
+  return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double MatchStats::eloToScore(double elo) {
+  return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double MatchStats::variance() const {
+  int games = getGames();
+  if (games == 0) {
+    return 0.0;
+  }
+
+  double s = score();
+  return (wins_ * (1.0 - s) * (1.0 - s)
+        + draws_ * (0.5 - s) * (0.5 - s)
+        + losses_ * s * s) / games;
+}
+
+} // namespace sunfish
@@ -0,0 +1,119 @@
+/* MatchStats.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_MATCH_MATCHSTATS_HPP__
+#define SUNFISH_MATCH_MATCHSTATS_HPP__
+
+#include "common/Def.hpp"
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * MatchStats estimates the Elo difference from the results of games,
+ * and runs SPRT (sequential probability ratio test) on it.
+ * All values are from the first player's point of view.
+ */
+class MatchStats {
+public:
+
+  struct SprtConfig {
+    /** the Elo difference of the null hypothesis */
+    double elo0;
+    /** the Elo difference of the alternative hypothesis */
+    double elo1;
+    /** the probability of type I error */
+    double alpha;
+    /** the probability of type II error */
+    double beta;
+  };
+
+  enum class SprtResult : uint8_t {
+    Continue,
+    AcceptH0,
+    AcceptH1,
+  };
+
+  MatchStats() : wins_(0), draws_(0), losses_(0) {
+  }
+
+  void addWin() {
+    wins_++;
+  }
+
+  void addDraw() {
+    draws_++;
+  }
+
+  void addLoss() {
+    losses_++;
+  }
+
+  int getWins() const {
+    return wins_;
+  }
+
+  int getDraws() const {
+    return draws_;
+  }
+
+  int getLosses() const {
+    return losses_;
+  }
+
+  int getGames() const {
+    return wins_ + draws_ + losses_;
+  }
+
+  /**
+   * the average score per game. (win: 1, draw: 0.5, loss: 0)
+   */
+  double score() const;
+
+  double elo() const;
+
+  /**
+   * the half width of the 95% confidence interval of elo().
+   */
+  double eloError() const;
+
+  /**
+   * the likelihood of superiority.
+   */
+  double los() const;
+
+  /**
+   * the log-likelihood ratio of H1 to H0.
+   */
+  double llr(const SprtConfig& config) const;
+
+  SprtResult sprt(const SprtConfig& config) const;
+
+  static double lowerBound(const SprtConfig& config);
+
+  static double upperBound(const SprtConfig& config);
+
+  static double scoreToElo(double score);
+
+  static double eloToScore(double elo);
+
+private:
+
+  /**
+   * the variance of the score of a game.
+   */
+  double variance() const;
+
+private:
+
+  int wins_;
+  int draws_;
+  int losses_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_MATCH_MATCHSTATS_HPP__
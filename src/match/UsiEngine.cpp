@@ -0,0 +1,177 @@
+/* UsiEngine.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "match/UsiEngine.hpp"
+#include "common/string/StringUtil.hpp"
+#include "logger/Logger.hpp"
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+using namespace sunfish;
+
+std::vector<std::string> splitCommand(const std::string& line) {
+  return StringUtil::split(line, [](char c) {
+    return isspace(c);
+  });
+}
+
+} // namespace
+
+namespace sunfish {
+
+bool UsiEngine::start(const std::string& path) {
+  quit();
+
+  path_ = path;
+  name_ = path;
+  options_.clear();
+
+  if (!process_.start(path)) {
+    LOG(error) << "could not start the engine: " << path;
+    return false;
+  }
+
+  if (!send("usi")) {
+    return false;
+  }
+
+  for (;;) {
+    std::string line;
+    if (!process_.readLine(line, CommandTimeoutMs)) {
+      LOG(error) << "no response to usi: " << path_;
+      quit();
+      return false;
+    }
+
+    if (line == "usiok") {
+      return true;
+    }
+
+    if (line.compare(0, 8, "id name ") == 0) {
+      name_ = line.substr(8);
+      continue;
+    }
+
+    auto args = splitCommand(line);
+    if (args.size() >= 3 && args[0] == "option" && args[1] == "name") {
+      options_.insert(args[2]);
+    }
+  }
+}
+
+bool UsiEngine::setOption(const std::string& name, const std::string& value) {
+  return send("setoption name " + name + " value " + value);
+}
+
+bool UsiEngine::newGame() {
+  if (!send("isready") || !waitFor("readyok", CommandTimeoutMs)) {
+    LOG(error) << "no response to isready: " << path_;
+    return false;
+  }
+  return send("usinewgame");
+}
+
+bool UsiEngine::go(const std::string& position,
+                   const std::string& go,
+                   int timeoutMs,
+                   GoResult& result) {
+  result.bestMove.clear();
+  result.score = 0;
+  result.hasScore = false;
+  result.isMateScore = false;
+  result.nodes = 0;
+  result.elapsedMs = 0;
+
+  if (!send("position " + position) || !send("go " + go)) {
+    return false;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::milliseconds(timeoutMs);
+
+  for (;;) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    std::string line;
+    if (remaining <= 0 || !process_.readLine(line, static_cast<int>(remaining))) {
+      LOG(error) << "no response to go: " << path_;
+      return false;
+    }
+
+    auto args = splitCommand(line);
+    if (args.empty()) {
+      continue;
+    }
+
+    if (args[0] == "info") {
+      for (size_t i = 1; i + 1 < args.size(); i++) {
+        if (args[i] == "string" || args[i] == "pv") {
+          break;
+        } else if (args[i] == "score" && i + 2 < args.size()) {
+          result.hasScore = true;
+          result.isMateScore = args[i+1] == "mate";
+          result.score = static_cast<int>(strtol(args[i+2].c_str(), nullptr, 10));
+          i += 2;
+        } else if (args[i] == "nodes") {
+          result.nodes = strtoull(args[i+1].c_str(), nullptr, 10);
+          i++;
+        }
+      }
+      continue;
+    }
+
+    if (args[0] == "bestmove") {
+      if (args.size() < 2) {
+        LOG(error) << "invalid response: " << line;
+        return false;
+      }
+      result.bestMove = args[1];
+      result.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start).count());
+      return true;
+    }
+  }
+}
+
+void UsiEngine::gameOver(const char* result) {
+  send(std::string("gameover ") + result);
+}
+
+void UsiEngine::quit() {
+  if (process_.isRunning()) {
+    send("quit");
+    process_.stop();
+  }
+}
+
+bool UsiEngine::send(const std::string& command) {
+  if (!process_.writeLine(command)) {
+    LOG(error) << "could not send a command to the engine: " << path_;
+    return false;
+  }
+  return true;
+}
+
+bool UsiEngine::waitFor(const char* response, int timeoutMs) {
+  auto deadline = std::chrono::steady_clock::now()
+                + std::chrono::milliseconds(timeoutMs);
+
+  for (;;) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    std::string line;
+    if (remaining <= 0 || !process_.readLine(line, static_cast<int>(remaining))) {
+      return false;
+    }
+    if (line == response) {
+      return true;
+    }
+  }
+}
+
+} // namespace sunfish
@@ -0,0 +1,111 @@
+/* UsiEngine.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_MATCH_USIENGINE_HPP__
+#define SUNFISH_MATCH_USIENGINE_HPP__
+
+#include "common/process/ChildProcess.hpp"
+#include <set>
+#include <string>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * UsiEngine runs a USI engine as a child process.
+ */
+class UsiEngine {
+public:
+
+  /** the time limit of the commands except go */
+  static CONSTEXPR_CONST int CommandTimeoutMs = 30 * 1000;
+
+  struct GoResult {
+    /** the move in SFEN, `resign' or `win' */
+    std::string bestMove;
+    /** the last score of `info' from the engine's point of view */
+    int score;
+    bool hasScore;
+    bool isMateScore;
+    /** the last number of nodes of `info' */
+    uint64_t nodes;
+    /** the time from `go' to `bestmove' measured by this process */
+    int elapsedMs;
+  };
+
+  UsiEngine() = default;
+  UsiEngine(const UsiEngine&) = delete;
+  UsiEngine(UsiEngine&&) = delete;
+
+  ~UsiEngine() {
+    quit();
+  }
+
+  /**
+   * Start the program and wait for `usiok'.
+   */
+  bool start(const std::string& path);
+
+  bool isRunning() const {
+    return process_.isRunning();
+  }
+
+  const std::string& getName() const {
+    return name_;
+  }
+
+  /**
+   * Check whether the engine declared the option at `usi'.
+   */
+  bool hasOption(const std::string& name) const {
+    return options_.find(name) != options_.end();
+  }
+
+  bool setOption(const std::string& name, const std::string& value);
+
+  bool setOption(const std::string& name, int value) {
+    return setOption(name, std::to_string(value));
+  }
+
+  /**
+   * Send `isready' and `usinewgame'.
+   */
+  bool newGame();
+
+  /**
+   * Send `position' and `go', and wait for `bestmove'.
+   * @param position the arguments of `position' command
+   * @param go the arguments of `go' command
+   */
+  bool go(const std::string& position,
+          const std::string& go,
+          int timeoutMs,
+          GoResult& result);
+
+  /**
+   * @param result `win', `lose' or `draw'
+   */
+  void gameOver(const char* result);
+
+  void quit();
+
+private:
+
+  bool send(const std::string& command);
+
+  bool waitFor(const char* response, int timeoutMs);
+
+private:
+
+  std::string path_;
+  std::string name_;
+  std::set<std::string> options_;
+  ChildProcess process_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_MATCH_USIENGINE_HPP__
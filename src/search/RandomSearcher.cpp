@@ -17,23 +17,7 @@ RandomSearcher::RandomSearcher() {
 bool RandomSearcher::search(const Position& pos, Move& move) {
   Moves moves;
 
-  auto cs = pos.getCheckState();
-
-  if (!isCheck(cs)) {
-    MoveGenerator::generateCaptures(pos, moves);
-    MoveGenerator::generateQuiets(pos, moves);
-  } else {
-    MoveGenerator::generateEvasions(pos, cs, moves);
-  }
-
-  for (auto ite = moves.begin(); ite != moves.end(); ) {
-    Piece captured;
-    if (Position(pos).doMove(*ite, captured)) {
-      ite++;
-    } else {
-      ite = moves.remove(ite);
-    }
-  }
+  MoveGenerator::generateLegalMoves(pos, moves);
 
   if (moves.size() == 0) {
     return false;
@@ -13,8 +13,10 @@ namespace sunfish {
 
 struct SearchConfig {
   using TimeType = uint32_t;
+  using NodesType = uint64_t;
 
   static CONSTEXPR_CONST TimeType InfinityTime = ~static_cast<TimeType>(0);
+  static CONSTEXPR_CONST NodesType InfinityNodes = ~static_cast<NodesType>(0);
   static CONSTEXPR_CONST TimeType DefaultOptimumTimeMs = 3 * 1000;
   static CONSTEXPR_CONST TimeType DefaultMaximumTimeMs = 3 * 1000;
   static CONSTEXPR_CONST int DefaultNumberOfThreads = 1;
@@ -24,6 +26,25 @@ struct SearchConfig {
   TimeType maximumTimeMs;
   int numberOfThreads;
   int multiPV;
+
+  /** the search is stopped when the number of nodes exceeds this value. */
+  NodesType maximumNodes;
+
+  /**
+   * nodes-as-time mode:
+   * if this value is not zero, the elapsed time is measured as
+   * (the number of searched nodes) / nodesPerMs instead of the clock.
+   */
+  uint32_t nodesPerMs;
+
+  /** SearchHandler::onStats is called at this interval. (zero: disabled) */
+  TimeType statsIntervalMs;
+
+  /**
+   * maintain the effect board of Position in each tree.
+   * the check and mate detection and SEE read it instead of scanning the board.
+   */
+  bool effectBoard;
 };
 
 inline CONSTEXPR SearchConfig getDefaultSearchConfig() {
@@ -32,6 +53,10 @@ inline CONSTEXPR SearchConfig getDefaultSearchConfig() {
     SearchConfig::DefaultMaximumTimeMs,
     SearchConfig::DefaultNumberOfThreads,
     SearchConfig::DefaultMultiPV,
+    SearchConfig::InfinityNodes,
+    0,
+    0,
+    false,
   };
 }
 
@@ -7,6 +7,7 @@
 #include "search/Searcher.hpp"
 #include "logger/Logger.hpp"
 
+#include <algorithm>
 #include <iomanip>
 
 namespace sunfish {
@@ -15,7 +16,7 @@ void LoggingSearchHandler::onStart(const Searcher&) {
 }
 
 void LoggingSearchHandler::onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, int multiPV) {
-  auto& info = searcher.getInfo();
+  const auto& info = searcher.getInfo();
 
   auto timeMs = static_cast<uint32_t>(elapsed * 1e3);
   auto realDepth = depth / Searcher::Depth1Ply;
@@ -36,5 +37,20 @@ void LoggingSearchHandler::onFailHigh(const Searcher& searcher, const PV& pv, fl
   onUpdatePV(searcher, pv, elapsed, depth, score, 1);
   MSG(info) << "fail-high";
 }
+
+void LoggingSearchHandler::onStats(const Searcher& searcher, float elapsed) {
+  const auto& info = searcher.getInfo();
+
+  auto totalNodes = info.nodes + info.quiesNodes;
+  auto nps = static_cast<uint64_t>(totalNodes / std::max(elapsed, 1.0e-3f));
+
+  MSG(info) << "stats: "
+            << "time=" << static_cast<uint32_t>(elapsed * 1e3) << " "
+            << "nodes=" << totalNodes << " "
+            << "nps=" << nps << " "
+            << "tt-hit=" << percentage(info.ttHit, info.ttProbe) << "% "
+            << "eval-cache-hit=" << percentage(info.evalCacheHit, info.evalCacheProbe) << "% "
+            << "hashfull=" << static_cast<int>(searcher.ttUsageRates() * 1000);
+}
  
 } // namespace sunfish
@@ -20,6 +20,7 @@ public:
   virtual void onFailLow(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) = 0;
   virtual void onFailHigh(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) = 0;
   virtual void onIterateEnd(const Searcher& searcher, float elapsed, int depth) = 0;
+  virtual void onStats(const Searcher& searcher, float elapsed) = 0;
 };
 
 class LoggingSearchHandler : public SearchHandler {
@@ -29,6 +30,7 @@ public:
   void onFailLow(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
   void onFailHigh(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
   void onIterateEnd(const Searcher&, float, int) override {}
+  void onStats(const Searcher& searcher, float elapsed) override;
 };
 
 } // namespace sunfish
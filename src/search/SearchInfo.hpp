@@ -6,40 +6,148 @@
 #ifndef SUNFISH_SEARCH_SEARCHINFO_HPP__
 #define SUNFISH_SEARCH_SEARCHINFO_HPP__
 
+#include "common/Def.hpp"
+#include <atomic>
 #include <iomanip>
+#include <sstream>
 #include <cstdint>
-#include <cstring>
 
 namespace sunfish {
 
-struct SearchInfo {
-  uint64_t nodes;
-  uint64_t quiesNodes;
-  uint64_t hashCut;
-  uint64_t nullMovePruning;
-  uint64_t futilityPruning;
-  uint64_t razoring;
-  uint64_t probCut;
-  uint64_t failHigh;
-  uint64_t failHighFirst;
-  uint64_t singularExtension;
+/**
+ * StatCounter is written by only one thread and can be read by
+ * other threads at any time without locks.
+ * The increment is a relaxed load and store, not a read-modify-write.
+ */
+class StatCounter {
+public:
+
+  StatCounter() : value_(0) {
+  }
+  StatCounter(const StatCounter&) = delete;
+  StatCounter(StatCounter&&) = delete;
+
+  void operator++(int) {
+    value_.store(value_.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+  }
+
+  StatCounter& operator=(uint64_t value) {
+    value_.store(value, std::memory_order_relaxed);
+    return *this;
+  }
+
+  operator uint64_t() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+private:
+
+  std::atomic<uint64_t> value_;
+
+};
+
+template <class T>
+struct BasicSearchInfo {
+  static CONSTEXPR_CONST int DepthSize = 32;
+
+  T nodes;
+  T quiesNodes;
+  T hashCut;
+  T nullMoveSearch;
+  T nullMovePruning;
+  T futilityPruning;
+  T razoring;
+  T probCutSearch;
+  T probCut;
+  T lmrReduction;
+  T lmrResearch;
+  T failHigh;
+  T failHighFirst;
+  T singularExtension;
+  T ttProbe;
+  T ttHit;
+  T ttStore;
+  T ttReplace;
+  T evalCacheProbe;
+  T evalCacheHit;
+  T rootResultProbe;
+  T rootResultHit;
+
+  /** the number of nodes for each remaining depth in plies */
+  T nodesEachDepth[DepthSize];
 };
 
-inline void initializeSearchInfo(SearchInfo& info) {
-  memset(&info, 0, sizeof(info));
+/**
+ * a snapshot of the counters.
+ */
+using SearchInfo = BasicSearchInfo<uint64_t>;
+
+/**
+ * the counters owned by a search thread.
+ */
+using SearchCounters = BasicSearchInfo<StatCounter>;
+
+template <class T>
+inline void initializeSearchInfo(BasicSearchInfo<T>& info) {
+  info.nodes             = 0;
+  info.quiesNodes        = 0;
+  info.hashCut           = 0;
+  info.nullMoveSearch    = 0;
+  info.nullMovePruning   = 0;
+  info.futilityPruning   = 0;
+  info.razoring          = 0;
+  info.probCutSearch     = 0;
+  info.probCut           = 0;
+  info.lmrReduction      = 0;
+  info.lmrResearch       = 0;
+  info.failHigh          = 0;
+  info.failHighFirst     = 0;
+  info.singularExtension = 0;
+  info.ttProbe           = 0;
+  info.ttHit             = 0;
+  info.ttStore           = 0;
+  info.ttReplace         = 0;
+  info.evalCacheProbe    = 0;
+  info.evalCacheHit      = 0;
+  info.rootResultProbe   = 0;
+  info.rootResultHit     = 0;
+  for (int i = 0; i < SearchInfo::DepthSize; i++) {
+    info.nodesEachDepth[i] = 0;
+  }
 }
 
-inline void mergeSearchInfo(SearchInfo& dst, const SearchInfo& src) {
+template <class T>
+inline void mergeSearchInfo(SearchInfo& dst, const BasicSearchInfo<T>& src) {
   dst.nodes             += src.nodes;
   dst.quiesNodes        += src.quiesNodes;
   dst.hashCut           += src.hashCut;
+  dst.nullMoveSearch    += src.nullMoveSearch;
   dst.nullMovePruning   += src.nullMovePruning;
   dst.futilityPruning   += src.futilityPruning;
   dst.razoring          += src.razoring;
+  dst.probCutSearch     += src.probCutSearch;
   dst.probCut           += src.probCut;
+  dst.lmrReduction      += src.lmrReduction;
+  dst.lmrResearch       += src.lmrResearch;
   dst.failHigh          += src.failHigh;
   dst.failHighFirst     += src.failHighFirst;
   dst.singularExtension += src.singularExtension;
+  dst.ttProbe           += src.ttProbe;
+  dst.ttHit             += src.ttHit;
+  dst.ttStore           += src.ttStore;
+  dst.ttReplace         += src.ttReplace;
+  dst.evalCacheProbe    += src.evalCacheProbe;
+  dst.evalCacheHit      += src.evalCacheHit;
+  dst.rootResultProbe   += src.rootResultProbe;
+  dst.rootResultHit     += src.rootResultHit;
+  for (int i = 0; i < SearchInfo::DepthSize; i++) {
+    dst.nodesEachDepth[i] += src.nodesEachDepth[i];
+  }
+}
+
+inline uint64_t percentage(uint64_t numerator, uint64_t denominator) {
+  return denominator != 0 ? numerator * 100 / denominator : 0;
 }
 
 template <class T>
@@ -54,12 +162,33 @@ inline void printSearchInfo(T& os, const SearchInfo& info, float elapsed) {
   os << "quies nodes        : " << info.quiesNodes;
   os << "total nodes        : " << totalNodes;
   os << "hash-cut           : " << info.hashCut;
-  os << "null move pruning  : " << info.nullMovePruning;
+  os << "null move pruning  : " << info.nullMovePruning
+                                  << " (" << percentage(info.nullMovePruning, info.nullMoveSearch) << "%)";
   os << "futility pruning   : " << info.futilityPruning;
   os << "razoring           : " << info.razoring;
-  os << "probCut            : " << info.probCut;
+  os << "probCut            : " << info.probCut
+                                  << " (" << percentage(info.probCut, info.probCutSearch) << "%)";
+  os << "LMR re-search      : " << info.lmrResearch
+                                  << " (" << percentage(info.lmrResearch, info.lmrReduction) << "%)";
   os << "fail high first    : " << failHighFirst << "%";
   os << "singular extension : " << info.singularExtension;
+  os << "TT hit             : " << percentage(info.ttHit, info.ttProbe) << "%";
+  os << "TT replace         : " << percentage(info.ttReplace, info.ttStore) << "%";
+  os << "eval cache hit     : " << percentage(info.evalCacheHit, info.evalCacheProbe) << "%";
+  if (info.rootResultProbe != 0) {
+    os << "root result hit    : " << percentage(info.rootResultHit, info.rootResultProbe) << "%";
+  }
+
+  // the share of the nodes for each remaining depth. (depth:percentage)
+  int maxDepth = SearchInfo::DepthSize - 1;
+  while (maxDepth > 0 && info.nodesEachDepth[maxDepth] == 0) {
+    maxDepth--;
+  }
+  std::ostringstream depths;
+  for (int i = 0; i <= maxDepth; i++) {
+    depths << (i != 0 ? " " : "") << i << ':' << percentage(info.nodesEachDepth[i], info.nodes);
+  }
+  os << "nodes each depth   : " << depths.str();
 }
 
 } // namespace sunfish
@@ -0,0 +1,62 @@
+/* SearchParam.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/SearchParam.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+using namespace sunfish;
+
+const SearchParam::Info Infos[] = {
+#define SUNFISH_SEARCH_PARAM_INFO(name, minValue, maxValue) \
+  { #name, SearchParam::name ## Default, minValue, maxValue },
+  SEARCH_PARAM_LIST(SUNFISH_SEARCH_PARAM_INFO)
+#undef SUNFISH_SEARCH_PARAM_INFO
+};
+
+static_assert(sizeof(Infos) / sizeof(Infos[0]) == SearchParam::Num, "invalid size");
+
+} // namespace
+
+namespace sunfish {
+
+int SearchParam::values_[Num] = {
+#define SUNFISH_SEARCH_PARAM_VALUE(name, minValue, maxValue) name ## Default,
+  SEARCH_PARAM_LIST(SUNFISH_SEARCH_PARAM_VALUE)
+#undef SUNFISH_SEARCH_PARAM_VALUE
+};
+
+const SearchParam::Info& SearchParam::getInfo(int id) {
+  return Infos[id];
+}
+
+int SearchParam::find(const char* name) {
+  for (int id = 0; id < Num; id++) {
+    if (strcmp(Infos[id].name, name) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+bool SearchParam::set(int id, int value) {
+  if (!TUNING) {
+    return false;
+  }
+
+  const auto& info = Infos[id];
+  values_[id] = std::min(std::max(value, info.minimumValue), info.maximumValue);
+  return true;
+}
+
+void SearchParam::reset() {
+  for (int id = 0; id < Num; id++) {
+    values_[id] = Infos[id].defaultValue;
+  }
+}
+
+} // namespace sunfish
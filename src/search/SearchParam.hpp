@@ -0,0 +1,155 @@
+/* SearchParam.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_SEARCHPARAM_HPP__
+#define SUNFISH_SEARCH_SEARCHPARAM_HPP__
+
+#include "common/Def.hpp"
+#include "search/Param.hpp"
+
+#ifndef TUNING
+# define TUNING 0
+#endif
+
+/**
+ * the list of the parameters defined in Param.hpp.
+ * X(name, minimum value, maximum value)
+ */
+#define SEARCH_PARAM_LIST(X) \
+  X(EXT_SINGULAR,          0,    8) \
+  X(EXT_DEPTH_CHECK,       0,    8) \
+  X(EXT_DEPTH_ONE_REPLY,   0,    8) \
+  X(EXT_DEPTH_RECAP,       0,    8) \
+  X(NULL_DEPTH_RATE,       4,   16) \
+  X(NULL_DEPTH_REDUCE,     0,   32) \
+  X(NULL_DEPTH_VRATE,    100, 2000) \
+  X(REDUCTION_RATE1,       0,   40) \
+  X(REDUCTION_RATE2,       0,   40) \
+  X(RAZOR_MARGIN1,         0, 2000) \
+  X(RAZOR_MARGIN2,         0, 2000) \
+  X(RAZOR_MARGIN3,         0, 2000) \
+  X(RAZOR_MARGIN4,         0, 2000) \
+  X(FUT_PRUN_MAX_DEPTH,    0,   64) \
+  X(FUT_PRUN_MARGIN_RATE,  0,  200) \
+  X(FUT_PRUN_MARGIN,       0,  500) \
+  X(PROBCUT_MARGIN,        0, 1000) \
+  X(PROBCUT_REDUCTION,     4,   32) \
+  X(ASP_MIN_DEPTH,         1,   16) \
+  X(ASP_1ST_DELTA,        10,  500) \
+  X(ASP_DELTA_RATE,        0,  200) \
+  X(SINGULAR_DEPTH,        8,   64) \
+  X(SINGULAR_MARGIN,       0,  100)
+
+namespace sunfish {
+
+/**
+ * SearchParam is the table of the parameters defined in Param.hpp.
+ * If TUNING is enabled, the macros of Param.hpp refer to this table,
+ * so that the parameters can be changed without rebuilding.
+ * Otherwise, the macros are constants and set() always fails.
+ */
+class SearchParam {
+public:
+
+  enum Id : int {
+#define SUNFISH_SEARCH_PARAM_ID(name, minValue, maxValue) name ## Id,
+    SEARCH_PARAM_LIST(SUNFISH_SEARCH_PARAM_ID)
+#undef SUNFISH_SEARCH_PARAM_ID
+    Num,
+  };
+
+  /** the values of Param.hpp */
+  enum Default : int {
+#define SUNFISH_SEARCH_PARAM_DEFAULT(name, minValue, maxValue) name ## Default = name,
+    SEARCH_PARAM_LIST(SUNFISH_SEARCH_PARAM_DEFAULT)
+#undef SUNFISH_SEARCH_PARAM_DEFAULT
+  };
+
+  struct Info {
+    const char* name;
+    int defaultValue;
+    int minimumValue;
+    int maximumValue;
+  };
+
+  static const Info& getInfo(int id);
+
+  /**
+   * Returns the ID of the parameter which has the specified name.
+   * If there is no such parameter, returns -1.
+   */
+  static int find(const char* name);
+
+  static int get(int id) {
+    return values_[id];
+  }
+
+  /**
+   * Set the value clamped into the range of the parameter.
+   * Searcher::initialize() must be called after changing the parameters.
+   */
+  static bool set(int id, int value);
+
+  static void reset();
+
+private:
+
+  static int values_[Num];
+
+};
+
+} // namespace sunfish
+
+#if TUNING
+# define SUNFISH_SEARCH_PARAM(name) (::sunfish::SearchParam::get(::sunfish::SearchParam::name ## Id))
+# undef EXT_SINGULAR
+# undef EXT_DEPTH_CHECK
+# undef EXT_DEPTH_ONE_REPLY
+# undef EXT_DEPTH_RECAP
+# undef NULL_DEPTH_RATE
+# undef NULL_DEPTH_REDUCE
+# undef NULL_DEPTH_VRATE
+# undef REDUCTION_RATE1
+# undef REDUCTION_RATE2
+# undef RAZOR_MARGIN1
+# undef RAZOR_MARGIN2
+# undef RAZOR_MARGIN3
+# undef RAZOR_MARGIN4
+# undef FUT_PRUN_MAX_DEPTH
+# undef FUT_PRUN_MARGIN_RATE
+# undef FUT_PRUN_MARGIN
+# undef PROBCUT_MARGIN
+# undef PROBCUT_REDUCTION
+# undef ASP_MIN_DEPTH
+# undef ASP_1ST_DELTA
+# undef ASP_DELTA_RATE
+# undef SINGULAR_DEPTH
+# undef SINGULAR_MARGIN
+# define EXT_SINGULAR          SUNFISH_SEARCH_PARAM(EXT_SINGULAR)
+# define EXT_DEPTH_CHECK       SUNFISH_SEARCH_PARAM(EXT_DEPTH_CHECK)
+# define EXT_DEPTH_ONE_REPLY   SUNFISH_SEARCH_PARAM(EXT_DEPTH_ONE_REPLY)
+# define EXT_DEPTH_RECAP       SUNFISH_SEARCH_PARAM(EXT_DEPTH_RECAP)
+# define NULL_DEPTH_RATE       SUNFISH_SEARCH_PARAM(NULL_DEPTH_RATE)
+# define NULL_DEPTH_REDUCE     SUNFISH_SEARCH_PARAM(NULL_DEPTH_REDUCE)
+# define NULL_DEPTH_VRATE      SUNFISH_SEARCH_PARAM(NULL_DEPTH_VRATE)
+# define REDUCTION_RATE1       SUNFISH_SEARCH_PARAM(REDUCTION_RATE1)
+# define REDUCTION_RATE2       SUNFISH_SEARCH_PARAM(REDUCTION_RATE2)
+# define RAZOR_MARGIN1         SUNFISH_SEARCH_PARAM(RAZOR_MARGIN1)
+# define RAZOR_MARGIN2         SUNFISH_SEARCH_PARAM(RAZOR_MARGIN2)
+# define RAZOR_MARGIN3         SUNFISH_SEARCH_PARAM(RAZOR_MARGIN3)
+# define RAZOR_MARGIN4         SUNFISH_SEARCH_PARAM(RAZOR_MARGIN4)
+# define FUT_PRUN_MAX_DEPTH    SUNFISH_SEARCH_PARAM(FUT_PRUN_MAX_DEPTH)
+# define FUT_PRUN_MARGIN_RATE  SUNFISH_SEARCH_PARAM(FUT_PRUN_MARGIN_RATE)
+# define FUT_PRUN_MARGIN       SUNFISH_SEARCH_PARAM(FUT_PRUN_MARGIN)
+# define PROBCUT_MARGIN        SUNFISH_SEARCH_PARAM(PROBCUT_MARGIN)
+# define PROBCUT_REDUCTION     SUNFISH_SEARCH_PARAM(PROBCUT_REDUCTION)
+# define ASP_MIN_DEPTH         SUNFISH_SEARCH_PARAM(ASP_MIN_DEPTH)
+# define ASP_1ST_DELTA         SUNFISH_SEARCH_PARAM(ASP_1ST_DELTA)
+# define ASP_DELTA_RATE        SUNFISH_SEARCH_PARAM(ASP_DELTA_RATE)
+# define SINGULAR_DEPTH        SUNFISH_SEARCH_PARAM(SINGULAR_DEPTH)
+# define SINGULAR_MARGIN       SUNFISH_SEARCH_PARAM(SINGULAR_MARGIN)
+#endif // TUNING
+
+#endif // SUNFISH_SEARCH_SEARCHPARAM_HPP__
@@ -16,6 +16,12 @@ struct SearchResult {
   Move move;
   Score score;
   PV pv;
+  /**
+   * the depth of the last completed iteration.
+   * 0 means no iteration is completed: the move is the first root move
+   * in the order with a zero score, or none with -infinity if there is
+   * no legal move, and the PV is empty.
+   */
   int depth;
   float elapsed;
 };
@@ -3,8 +3,9 @@
  * Kubo Ryosuke
  */
 
-#include "search/Param.hpp"
+#include "search/SearchParam.hpp"
 #include "search/Searcher.hpp"
+#include "search/cluster/TTShare.hpp"
 #include "search/see/SEE.hpp"
 #include "search/mate/Mate.hpp"
 #include "search/eval/Evaluator.hpp"
@@ -19,13 +20,23 @@ namespace {
 
 using namespace sunfish;
 
-CONSTEXPR_CONST int AspirationSearchMinDepth = ASP_MIN_DEPTH * Searcher::Depth1Ply;
+/**
+ * the minimum depth of aspiration search.
+ */
+inline int aspirationSearchMinDepth() {
+  return ASP_MIN_DEPTH * Searcher::Depth1Ply;
+}
+
+// the quiescence search deeper than this depth generates only the valuable captures.
+CONSTEXPR_CONST int Quies2Depth = -6 * Searcher::Depth1Ply;
 
-// extensions
-CONSTEXPR_CONST int ExtensionSingular          = EXT_SINGULAR;
-CONSTEXPR_CONST int ExtensionDepthForCheck     = EXT_DEPTH_CHECK;
-CONSTEXPR_CONST int ExtensionDepthForOneReply  = EXT_DEPTH_ONE_REPLY;
-CONSTEXPR_CONST int ExtensionDepthForRecapture = EXT_DEPTH_RECAP;
+/**
+ * Convert a depth of the quiescence search into the depth of TT entries.
+ * 1: all captures are searched, 0: only the valuable captures are searched.
+ */
+inline int quiesTTDepth(int depth) {
+  return depth > Quies2Depth ? 1 : 0;
+}
 
 /**
  * Check whether the recursive-iterative deepening should be run.
@@ -62,6 +73,8 @@ void initializeReductionDepth() {
       double r = 0.05 * REDUCTION_RATE1 * log(d)
                + 0.08 * REDUCTION_RATE2 * log(mc + 1);
       if (r < 0.8) {
+        ReductionDepth[0][d][mc] = 0;
+        ReductionDepth[1][d][mc] = 0;
         continue;
       }
 
@@ -83,20 +96,22 @@ int reductionDepth(int depth,
                        [std::min(mc, 63)];
 }
 
-uint16_t RazorMargin[4] = { RAZOR_MARGIN1, RAZOR_MARGIN2, RAZOR_MARGIN3, RAZOR_MARGIN4 };
-
 /**
  * Returnes the margin of razoring
  */
 inline
 Score razorMargin(int depth) {
+  const int RazorMargin[4] = { RAZOR_MARGIN1, RAZOR_MARGIN2, RAZOR_MARGIN3, RAZOR_MARGIN4 };
   return RazorMargin[depth / Searcher::Depth1Ply];
 }
 
 /**
  * the maximum depth of futility pruning.
  */
-CONSTEXPR_CONST int FutilityPruningMaxDepth = FUT_PRUN_MAX_DEPTH;
+inline
+int futilityPruningMaxDepth() {
+  return FUT_PRUN_MAX_DEPTH;
+}
 
 /**
  * Returns the margin of futility pruning.
@@ -131,6 +146,34 @@ const int HalfDensity[][9] = {
 
 CONSTEXPR_CONST int HalfDensitySize = std::extent<decltype(HalfDensity)>::value;
 
+/**
+ * The number of moves picked by selection in each stage.
+ * The rest of the stage is sorted at once.
+ */
+CONSTEXPR_CONST int SelectionPickLimit = 4;
+
+/**
+ * Move the best move in the range [node.moveIterator, end)
+ * to the position of node.moveIterator.
+ */
+inline
+void pickMove(Node& node, MoveSlice::iterator end) {
+  if (node.pickCount < SelectionPickLimit) {
+    auto best = node.moveIterator;
+    for (auto ite = best + 1; ite < end; ite++) {
+      if (int16_t(ite->extData()) > int16_t(best->extData())) {
+        best = ite;
+      }
+    }
+    std::swap(*node.moveIterator, *best);
+  } else if (node.pickCount == SelectionPickLimit) {
+    std::sort(node.moveIterator, end, [](const Move& lhs, const Move& rhs) {
+      return int16_t(lhs.extData()) > int16_t(rhs.extData());
+    });
+  }
+  node.pickCount++;
+}
+
 inline
 Zobrist::Type excludeHash(const Move& move) {
   // lowest bit must be 0
@@ -161,28 +204,153 @@ Searcher::Searcher() :
   config_ (getDefaultSearchConfig()),
   evaluator_(Evaluator::sharedEvaluator()),
   treeSize_(0),
-  handler_(nullptr) {
+  evalCacheMebiBytes_(0),
+  evalCachePerThread_(false),
+  handler_(nullptr),
+  ttShare_(nullptr),
+  clusterIndex_(0),
+  rootSplit_(false) {
 }
 
 Searcher::Searcher(std::shared_ptr<Evaluator> evaluator) :
   config_ (getDefaultSearchConfig()),
   evaluator_(evaluator),
   treeSize_(0),
-  handler_(nullptr) {
+  evalCacheMebiBytes_(0),
+  evalCachePerThread_(false),
+  handler_(nullptr),
+  ttShare_(nullptr),
+  clusterIndex_(0),
+  rootSplit_(false) {
+}
+
+void Searcher::evalCacheResizeMB(unsigned mebiBytes, bool perThread) {
+  evalCacheMebiBytes_ = mebiBytes;
+  evalCachePerThread_ = perThread;
+
+  if (perThread) {
+    for (auto& evalCache : evalCaches_) {
+      evalCache->resizeMB(mebiBytes);
+    }
+  } else {
+    evalCaches_.clear();
+    evaluator_->resizeCacheMB(mebiBytes);
+  }
 }
 
 void Searcher::clean() {
   tt_.clear();
+  tracer_.instant(0, "tt clear");
   fromToHistory_.clear();
   pieceToHistory_.clear();
+  for (auto& evalCache : evalCaches_) {
+    evalCache->clear();
+  }
+  for (int ti = 0; ti < treeSize_; ti++) {
+    trees_[ti].counterMoves.clear();
+    if (trees_[ti].contHistory) {
+      trees_[ti].contHistory->clear();
+    }
+  }
   timeManager_.clearGame();
 }
 
+void Searcher::shareTT(Zobrist::Type hash, int depth) {
+  if (depth < ttShare_->getDepth()) {
+    return;
+  }
+
+  TTElement tte;
+  if (tt_.get(hash, tte)) {
+    ttShare_->push(hash, tte);
+  }
+}
+
+/**
+ * Use the result of the root move searched by a helper thread
+ * instead of searching it on the main thread.
+ */
+bool Searcher::loadRootResult(Tree& tree,
+                              Move move,
+                              int depth,
+                              Score alpha,
+                              Score beta,
+                              Score& score) {
+  tree.info.rootResultProbe++;
+
+  SharedRootResults::Result result;
+  if (!rootResults_.load(move, result) || result.depth < depth) {
+    return false;
+  }
+
+  if ((result.bound == SharedRootResults::Bound::Upper && result.score > alpha) ||
+      (result.bound == SharedRootResults::Bound::Lower && result.score < beta)) {
+    return false;
+  }
+
+  auto& childNode = tree.nodes[tree.ply+1];
+  auto& childColdNode = tree.coldNodes[tree.ply+1];
+  childColdNode.pv = result.pv;
+  childNode.isHistorical = false;
+  score = result.score;
+  tree.info.rootResultHit++;
+  return true;
+}
+
+void Searcher::storeRootResult(Tree& tree,
+                               Move move,
+                               int depth,
+                               Score alpha,
+                               Score beta,
+                               Score score) {
+  auto bound = score <= alpha ? SharedRootResults::Bound::Upper
+             : score >= beta  ? SharedRootResults::Bound::Lower
+             :                  SharedRootResults::Bound::Exact;
+  rootResults_.store(move, depth, score, bound, tree.coldNodes[tree.ply+1].pv);
+}
+
+void Searcher::checkLimits(Tree& tree) {
+  uint64_t nodes = nodes_.fetch_add(tree.checkCount, std::memory_order_relaxed)
+                 + tree.checkCount;
+  tree.checkCount = 0;
+
+  if (nodes >= config_.maximumNodes) {
+    tracer_.instant(tree.index, "node limit", "nodes", nodes);
+    interrupt();
+    return;
+  }
+
+  auto elapsed = elapsedMs();
+  if (elapsed >= config_.maximumTimeMs) {
+    tracer_.instant(tree.index, "time limit", "ms", elapsed);
+    interrupt();
+  }
+
+  if (tree.index == 0 &&
+      config_.statsIntervalMs != 0 &&
+      elapsed >= nextStatsMs_ &&
+      handler_ != nullptr) {
+    nextStatsMs_ = elapsed + config_.statsIntervalMs;
+    handler_->onStats(*this, timer_.elapsed());
+  }
+}
+
+SearchConfig::TimeType Searcher::elapsedMs() const {
+  if (config_.nodesPerMs != 0) {
+    uint64_t ms = nodes_.load(std::memory_order_relaxed) / config_.nodesPerMs;
+    return static_cast<SearchConfig::TimeType>(std::min<uint64_t>(ms, SearchConfig::InfinityTime));
+  }
+  return timer_.elapsedMs();
+}
+
 void Searcher::onSearchStarted(const Position& pos,
-                               Record* record) {
+                               const GameHistory* history) {
   timer_.start();
 
   interrupted_ = false;
+  nodes_ = 0;
+  rootSplit_ = false;
+  nextStatsMs_ = config_.statsIntervalMs;
 
   result_.move = Move::none();
   result_.score = -Score::infinity();
@@ -201,15 +369,33 @@ void Searcher::onSearchStarted(const Position& pos,
     trees_.reset(new Tree[treeSize_]);
   }
 
-  initializeSearchInfo(info_);
+  tracer_.prepare(treeSize_);
+
   for (int ti = 0; ti < treeSize_; ti++) {
     trees_[ti].index = ti;
     trees_[ti].completedDepth = 0;
     initializeTree(trees_[ti],
                    pos,
                    *evaluator_,
-                   record);
-    initializeSearchInfo(trees_[ti].info);
+                   history);
+    if (config_.effectBoard) {
+      trees_[ti].position.enableEffectBoard();
+    }
+    if (trees_[ti].contHistory) {
+      trees_[ti].contHistory->reduce();
+    } else {
+      trees_[ti].contHistory.reset(new ContinuationHistory());
+    }
+  }
+
+  if (evalCachePerThread_) {
+    while (evalCaches_.size() < static_cast<size_t>(treeSize_)) {
+      evalCaches_.emplace_back(new EvalCache());
+      evalCaches_.back()->resizeMB(evalCacheMebiBytes_);
+    }
+  }
+  for (int ti = 0; ti < treeSize_; ti++) {
+    trees_[ti].evalCache = evalCachePerThread_ ? evalCaches_[ti].get() : nullptr;
   }
 
   if (handler_ != nullptr) {
@@ -217,10 +403,13 @@ void Searcher::onSearchStarted(const Position& pos,
   }
 }
 
-void Searcher::mergeInfo(Tree& tree) {
-  std::lock_guard<std::mutex> lock(infoMutex_);
-  mergeSearchInfo(info_, tree.info);
-  initializeSearchInfo(tree.info);
+SearchInfo Searcher::getInfo() const {
+  SearchInfo info;
+  initializeSearchInfo(info);
+  for (int ti = 0; ti < treeSize_; ti++) {
+    mergeSearchInfo(info, trees_[ti].info);
+  }
+  return info;
 }
 
 /**
@@ -230,8 +419,8 @@ void Searcher::search(const Position& pos,
                       int depth,
                       Score alpha,
                       Score beta,
-                      Record* record /*= nullptr*/) {
-  onSearchStarted(pos, record);
+                      const GameHistory* history /*= nullptr*/) {
+  onSearchStarted(pos, history);
 
   auto& tree = trees_[0];
   Score score = search<false>(tree,
@@ -240,15 +429,15 @@ void Searcher::search(const Position& pos,
                               beta,
                               NodeStat::normal());
 
-  auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
 
-  if (node.pv.size() >= 1) {
-    result_.move = node.pv.getMove(0);
+  if (coldNode.pv.size() >= 1) {
+    result_.move = coldNode.pv.getMove(0);
   } else {
     result_.move = Move::none();
   }
   result_.score = score;
-  result_.pv = node.pv;
+  result_.pv = coldNode.pv;
   result_.depth = depth;
   result_.elapsed = timer_.elapsed();
 }
@@ -258,15 +447,24 @@ void Searcher::search(const Position& pos,
  */
 void Searcher::idsearch(const Position& pos,
                         int maxDepth,
-                        Record* record /*= nullptr*/) {
-  onSearchStarted(pos, record);
+                        const GameHistory* history /*= nullptr*/) {
+  onSearchStarted(pos, history);
 
   if (!prepareIDSearch(trees_[0], trees_[0])) {
     return;
   }
 
+  // multi-PV: the main thread searches all root moves
+  // using the results of the helper threads searching their own parts.
+  rootSplit_ = config_.multiPV > 1 && treeSize_ > 1;
+  if (rootSplit_) {
+    rootResults_.prepare(trees_[0].nodes[trees_[0].ply].moves);
+  }
+
   for (int ti = 1; ti < treeSize_; ti++) {
-    prepareIDSearch(trees_[ti], trees_[0]);
+    if (!prepareIDSearch(trees_[ti], trees_[0])) {
+      continue;
+    }
     trees_[ti].thread = std::thread([this, ti, maxDepth]() {
       idsearch(trees_[ti], maxDepth);
     });
@@ -282,14 +480,17 @@ void Searcher::idsearch(const Position& pos,
     }
   }
 
-  for (int ti = 0; ti < treeSize_; ti++) {
+  // the helper threads which searched a part of the root moves are ignored.
+  int resultTreeSize = rootSplit_ ? 1 : treeSize_;
+  for (int ti = 0; ti < resultTreeSize; ti++) {
     auto& tree = trees_[ti];
     auto& node = tree.nodes[tree.ply];
+    auto& coldNode = tree.coldNodes[tree.ply];
     if (tree.completedDepth > result_.depth) {
       result_.move = node.moves[0].excludeExtData();
       result_.score = moveToScore(node.moves[0]);
-      if (node.pv.size() != 0 && node.pv.getMove(0) == result_.move) {
-        result_.pv = node.pv;
+      if (coldNode.pv.size() != 0 && coldNode.pv.getMove(0) == result_.move) {
+        result_.pv = coldNode.pv;
       }
       result_.depth = tree.completedDepth;
       result_.elapsed = timer_.elapsed();
@@ -298,32 +499,48 @@ void Searcher::idsearch(const Position& pos,
       }
     }
   }
+
+  // when no iteration is completed in time,
+  // the first root move in the order is better than resigning.
+  if (result_.move.isNone()) {
+    auto& node = trees_[0].nodes[trees_[0].ply];
+    result_.move = node.moves[0].excludeExtData();
+    result_.score = Score::zero();
+    result_.pv.clear();
+    result_.elapsed = timer_.elapsed();
+  }
 }
 
 bool Searcher::prepareIDSearch(Tree& tree,
                                Tree& tree0) {
   bool isMainThread = tree.index == 0;
   auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
   node.checkState = tree.position.getCheckState();
-  node.pv.clear();
+  coldNode.pv.clear();
 
   if (isMainThread) {
     // generate moves
     node.moves.clear();
     if (!isCheck(node.checkState)) {
-      MoveGenerator::generateCaptures(tree.position, node.moves);
-      MoveGenerator::generateQuiets(tree.position, node.moves);
+      MoveGenerator::generateLegalCaptures(tree.position, node.moves);
+      MoveGenerator::generateLegalQuiets(tree.position, node.moves);
     } else {
-      MoveGenerator::generateEvasions(tree.position, node.checkState, node.moves);
+      MoveGenerator::generateLegalEvasions(tree.position, node.checkState, node.moves);
     }
 
     sortRootMoves(tree);
   } else {
     // copy from main thread tree
+    // (multi-PV: every (treeSize_-1)th move in the order of the main thread)
     node.moves.clear();
     auto& node0 = tree0.nodes[tree0.ply];
-    for (auto ite = node0.moves.cbegin(); ite != node0.moves.cend(); ite++) {
-      node.moves.add(*ite);
+    int helperSize = treeSize_ - 1;
+    int moveIndex = 0;
+    for (auto ite = node0.moves.cbegin(); ite != node0.moves.cend(); ite++, moveIndex++) {
+      if (!rootSplit_ || moveIndex % helperSize == tree.index - 1) {
+        node.moves.add(*ite);
+      }
     }
   }
 
@@ -333,17 +550,25 @@ bool Searcher::prepareIDSearch(Tree& tree,
 void Searcher::idsearch(Tree& tree,
                         int maxDepth) {
   auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
   bool isMainThread = tree.index == 0;
 
+  tracer_.begin(tree.index, "search");
+
+  // the threads of the other processes in a cluster are numbered after this process.
+  int helperIndex = tree.index + clusterIndex_ * treeSize_;
+
   for (int depth = Depth1Ply * 3 / 2; ; depth += Depth1Ply) {
-    if (!isMainThread) {
-      const int* row = HalfDensity[(tree.index - 1) % HalfDensitySize];
+    if (helperIndex != 0 && !rootSplit_) {
+      const int* row = HalfDensity[(helperIndex - 1) % HalfDensitySize];
       if (row[(depth / Depth1Ply) % row[0] + 1]) {
         continue;
       }
     }
 
+    tracer_.begin(tree.index, "iteration", "depth", depth / Depth1Ply);
     aspsearch(tree, depth);
+    tracer_.end(tree.index, "iteration");
 
     if (isInterrupted()) {
       break;
@@ -357,18 +582,19 @@ void Searcher::idsearch(Tree& tree,
     }
 
     if (isMainThread) {
-      timeManager_.update(timer_.elapsedMs(),
+      timeManager_.update(elapsedMs(),
                           depth,
                           score,
-                          node.pv);
+                          coldNode.pv);
       if (timeManager_.shouldInterrupt()) {
+        tracer_.instant(tree.index, "time manager stop", "ms", elapsedMs());
         interrupt();
         break;
       }
     }
   }
 
-  return;
+  tracer_.end(tree.index, "search");
 }
 
 /**
@@ -377,20 +603,22 @@ void Searcher::idsearch(Tree& tree,
 void Searcher::aspsearch(Tree& tree,
                          int depth) {
   auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
   bool isMainThread = tree.index == 0;
 
-  bool doAsp = depth >= AspirationSearchMinDepth;
+  bool doAsp = depth >= aspirationSearchMinDepth();
 
   int delta       = ASP_1ST_DELTA;
   Score alpha     = doAsp ? moveToScore(node.moves[0]) - delta : -Score::infinity();
   Score beta      = doAsp ? moveToScore(node.moves[0]) + delta : +Score::infinity();
+  Move bestMove   = node.moves[0].excludeExtData();
 
   for (;;) {
-    for (Moves::size_type i = 1; i < node.moves.size(); i++) {
+    for (MoveSlice::size_type i = 1; i < node.moves.size(); i++) {
       setScoreToMove(node.moves[i], -Score::infinity());
     }
 
-    tree.rootPVs.clear();
+    tree.rootPVs.clear(config_.multiPV);
 
     Score score = search<true>(tree,
                                depth,
@@ -401,39 +629,45 @@ void Searcher::aspsearch(Tree& tree,
                                                  .unsetRecursiveIDSearch()
                                                  .unsetRecaptureExtension());
 
-    mergeInfo(tree);
-
     if (score > alpha) {
       std::stable_sort(node.moves.begin(), node.moves.end(), [](Move lhs, Move rhs) {
         return moveToScore(lhs) > moveToScore(rhs);
       });
+
+      if (tracer_.isEnabled() && node.moves[0].excludeExtData() != bestMove) {
+        bestMove = node.moves[0].excludeExtData();
+        tracer_.instant(tree.index, "best move", "score", score.raw(),
+                        bestMove.toStringSFEN().c_str());
+      }
     }
 
     if (isInterrupted()) {
       if (score > alpha && isMainThread && handler_ != nullptr) {
-        handler_->onUpdatePV(*this, node.pv, timer_.elapsed(), depth, score, 1);
+        handler_->onUpdatePV(*this, coldNode.pv, timer_.elapsed(), depth, score, 1);
       }
       break;
     }
 
     Score minScore = score;
     if (!tree.rootPVs.empty()) {
-      minScore = (--tree.rootPVs.end())->score;
+      minScore = tree.rootPVs.back().score;
     }
 
     auto elapsed = timer_.elapsed();
     if (score <= alpha && alpha > -Score::infinity()) {
       // fail-low
       alpha = score > -Score::infinity() + delta ? score - delta : -Score::infinity();
+      tracer_.instant(tree.index, "fail-low", "score", score.raw());
       if (isMainThread && handler_ != nullptr && config_.multiPV <= 1) {
-        handler_->onFailLow(*this, node.pv, elapsed, depth, score);
+        handler_->onFailLow(*this, coldNode.pv, elapsed, depth, score);
       }
 
     } else if (score >= beta && beta < Score::infinity()) {
       // fail-high
       beta = score < Score::infinity() - delta ? score + delta : Score::infinity();
+      tracer_.instant(tree.index, "fail-high", "score", score.raw());
       if (isMainThread && handler_ != nullptr && config_.multiPV <= 1) {
-        handler_->onFailHigh(*this, node.pv, elapsed, depth, score);
+        handler_->onFailHigh(*this, coldNode.pv, elapsed, depth, score);
       }
 
     } else if (minScore <= alpha && alpha > -Score::infinity()) {
@@ -444,7 +678,7 @@ void Searcher::aspsearch(Tree& tree,
       // completed
       if (isMainThread && handler_ != nullptr) {
         if (config_.multiPV <= 1) {
-          handler_->onUpdatePV(*this, node.pv, elapsed, depth, score, 1);
+          handler_->onUpdatePV(*this, coldNode.pv, elapsed, depth, score, 1);
         } else {
           int multiPVIdx = 1;
           for (auto ite = tree.rootPVs.begin(); ite != tree.rootPVs.end(); ite++, multiPVIdx++) {
@@ -455,7 +689,7 @@ void Searcher::aspsearch(Tree& tree,
 
       if (score != -Score::infinity()) {
         storePV(tree.position,
-                node.pv,
+                coldNode.pv,
                 0,
                 alpha,
                 beta,
@@ -467,7 +701,7 @@ void Searcher::aspsearch(Tree& tree,
     delta += delta * ASP_DELTA_RATE / 100;
   }
 
-  if (isMainThread) {
+  if (isMainThread && handler_ != nullptr) {
     handler_->onIterateEnd(*this, timer_.elapsed(), depth);
   }
 }
@@ -495,10 +729,11 @@ Score Searcher::search(Tree& tree,
   visit<root>(tree);
 
   auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
 
   if (!root) {
     // SHEK(strong horizontal effect killer)
-    switch (tree.shekTable.check(tree.position)) {
+    switch (checkShek(tree)) {
     case ShekState::EqualS:
       switch (tree.scr.detectShort(tree)) {
       case SCRState::Draw:
@@ -550,7 +785,7 @@ Score Searcher::search(Tree& tree,
                  beta);
   }
 
-  if (tree.ply == Tree::StackSize - 2) {
+  if (tree.ply == Tree::StackSize - 2 || !hasMoveStackSpace(tree)) {
     node.isHistorical = true;
     return calculateStandPat(tree, *evaluator_);
   }
@@ -565,6 +800,8 @@ Score Searcher::search(Tree& tree,
   }
 
   tree.info.nodes++;
+  tree.info.nodesEachDepth[std::min(std::max(depth / Depth1Ply, 0), SearchInfo::DepthSize - 1)]++;
+  countNode(tree);
 
   bool isNullWindow = alpha + 1 == beta;
 
@@ -581,7 +818,7 @@ Score Searcher::search(Tree& tree,
   int ttDepth;
   {
     TTElement tte;
-    if (tt_.get(hash, tte)) {
+    if (probeTT(tree, hash, tte)) {
       ttScoreType = tte.scoreType();
       ttScore = tte.score(tree.ply);
       ttDepth = tte.depth();
@@ -639,7 +876,7 @@ Score Searcher::search(Tree& tree,
   // futility pruning
   if (!root &&
       !isCheck(node.checkState) &&
-      depth < FutilityPruningMaxDepth &&
+      depth < futilityPruningMaxDepth() &&
       standPat - futilityPruningMargin(depth) >= beta) {
     tree.info.futilityPruning++;
     return standPat - futilityPruningMargin(depth);
@@ -674,6 +911,7 @@ Score Searcher::search(Tree& tree,
     NodeStat newNodeStat = NodeStat::normal().unsetNullMoveSearch();
 
     doNullMove(tree, tt_);
+    tree.info.nullMoveSearch++;
 
     Score score = newDepth < Depth1Ply
         ? -quies(tree,
@@ -692,14 +930,14 @@ Score Searcher::search(Tree& tree,
       auto& childNode = tree.nodes[tree.ply+1];
       node.isHistorical = childNode.isHistorical;
       tree.info.nullMovePruning++;
-      tt_.store(hash,
-                alpha,
-                beta,
-                score,
-                depth,
-                tree.ply,
-                Move::none(),
-                false);
+      storeTT(tree,
+              hash,
+              alpha,
+              beta,
+              score,
+              depth,
+              Move::none(),
+              false);
       return score;
     }
 
@@ -733,6 +971,7 @@ Score Searcher::search(Tree& tree,
         continue;
       }
 
+      tree.info.probCutSearch++;
       Score score = -search<false>(tree,
                                    newDepth,
                                    -pbeta,
@@ -775,7 +1014,7 @@ Score Searcher::search(Tree& tree,
     revisit<root>(tree);
 
     TTElement tte;
-    if (tt_.get(hash, tte)) {
+    if (probeTT(tree, hash, tte)) {
       Move ttMove = tte.move();
       if (!ttMove.isNone() && tree.position.validateMove(ttMove, node.checkState)) {
         node.ttMove = ttMove;
@@ -846,21 +1085,21 @@ Score Searcher::search(Tree& tree,
 
     // extensions
     if (doSingularExtension && move == node.ttMove) {
-      newDepth += ExtensionSingular;
+      newDepth += EXT_SINGULAR;
       tree.info.singularExtension++;
 
     } else if (currentMoveIsCheck) {
-      newDepth += ExtensionDepthForCheck;
+      newDepth += EXT_DEPTH_CHECK;
 
     } else if (isFirst &&
                isCheck(node.checkState) &&
                node.moveIterator == node.moves.end()) {
-      newDepth += ExtensionDepthForOneReply;
+      newDepth += EXT_DEPTH_ONE_REPLY;
 
     } else if (!isCheck(node.checkState) &&
                nodeStat.isRecaptureExtension() &&
                isRecapture(tree, move)) {
-      newDepth += ExtensionDepthForRecapture;
+      newDepth += EXT_DEPTH_RECAP;
       nodeStat.unsetRecaptureExtension();
       newNodeStat.unsetRecaptureExtension();
     }
@@ -883,10 +1122,10 @@ Score Searcher::search(Tree& tree,
 
     if (root) {
       // multi-PV
-      if (tree.rootPVs.size() < config_.multiPV) {
+      if (!tree.rootPVs.full()) {
         newAlpha = alpha;
-      } else if (!tree.rootPVs.empty()) {
-        newAlpha = std::max(alpha, (--tree.rootPVs.end())->score);
+      } else {
+        newAlpha = std::max(alpha, tree.rootPVs.back().score);
       }
     }
 
@@ -894,7 +1133,7 @@ Score Searcher::search(Tree& tree,
     if (!root &&
         !currentMoveIsCheck &&
         !isCheck(node.checkState) &&
-        newDepth < FutilityPruningMaxDepth &&
+        newDepth < futilityPruningMaxDepth() &&
         newAlpha > -Score::mate() &&
         !isPriorMove(tree, move)) {
       Score futScore = estimateScore(tree, move, *evaluator_)
@@ -910,47 +1149,58 @@ Score Searcher::search(Tree& tree,
       }
     }
 
-    bool moveOk = doMove<true>(tree, move, *evaluator_, tt_);
-    if (!moveOk) {
-      node.moveIterator = node.moves.remove(node.moveIterator-1);
-      moveCount--;
-      continue;
-    }
-
     Score score;
-    if (isFirst) {
-      score = -search<false>(tree,
-                             newDepth,
-                             -beta,
-                             -newAlpha,
-                             newNodeStat);
-    } else {
-      // nega-scout
-      score = -search<false>(tree,
-                             newDepth,
-                             -(newAlpha + 1),
-                             -newAlpha,
-                             newNodeStat);
-
-      if (!isInterrupted() &&
-          score > newAlpha &&
-          (reduced != 0 || score < beta)) {
-        newDepth = newDepth + reduced;
+    if (!root || !rootSplit_ || tree.index != 0 ||
+        !loadRootResult(tree, move, depth, newAlpha, beta, score)) {
+      bool moveOk = doMove<true>(tree, move, *evaluator_, tt_);
+      if (!moveOk) {
+        // The move is left in the list,
+        // because the picker relies on the boundaries of each stage.
+        moveCount--;
+        continue;
+      }
+
+      if (isFirst) {
         score = -search<false>(tree,
                                newDepth,
                                -beta,
                                -newAlpha,
                                newNodeStat);
+      } else {
+        // nega-scout
+        if (reduced != 0) {
+          tree.info.lmrReduction++;
+        }
+        score = -search<false>(tree,
+                               newDepth,
+                               -(newAlpha + 1),
+                               -newAlpha,
+                               newNodeStat);
+
+        if (!isInterrupted() &&
+            score > newAlpha &&
+            (reduced != 0 || score < beta)) {
+          if (reduced != 0) {
+            tree.info.lmrResearch++;
+          }
+          newDepth = newDepth + reduced;
+          score = -search<false>(tree,
+                                 newDepth,
+                                 -beta,
+                                 -newAlpha,
+                                 newNodeStat);
+        }
       }
-    }
 
-    undoMove<true>(tree);
+      undoMove<true>(tree);
+    }
 
     if (isInterrupted()) {
       return bestScore;
     }
 
     auto& childNode = tree.nodes[tree.ply+1];
+    auto& childColdNode = tree.coldNodes[tree.ply+1];
 
     if (root) {
       Score order = score;
@@ -961,7 +1211,10 @@ Score Searcher::search(Tree& tree,
         order = order >= wind - Score::infinity() ? order - wind : -Score::infinity();
       }
       setScoreToMove(*(node.moveIterator-1), order); // ordering for iterative deepening
-      insertRootPV(tree.rootPVs, move, depth, childNode.pv, score, config_.multiPV); // multi-PV
+      tree.rootPVs.insert(move, depth, childColdNode.pv, score); // multi-PV
+      if (rootSplit_ && tree.index != 0) {
+        storeRootResult(tree, move, depth, newAlpha, beta, score);
+      }
     }
 
     if (score > bestScore) {
@@ -978,12 +1231,12 @@ Score Searcher::search(Tree& tree,
         break;
       }
 
-      node.pv.set(move, depth, childNode.pv);
+      coldNode.pv.set(move, depth, childColdNode.pv);
     }
 
-    if (node.quietsSearched.size() < node.quietsSearched.capacity() &&
-        tree.position.isCapture(move)) {
-      node.quietsSearched.add(move);
+    if (coldNode.quietsSearched.size() < coldNode.quietsSearched.capacity() &&
+        !tree.position.isCapture(move)) {
+      coldNode.quietsSearched.add(move);
     }
 
     node.isHistorical |= childNode.isHistorical;
@@ -1004,14 +1257,14 @@ Score Searcher::search(Tree& tree,
   }
 
   if (!node.isHistorical) {
-    tt_.store(hash,
-              alpha,
-              beta,
-              bestScore,
-              depth,
-              tree.ply,
-              bestMove,
-              nodeStat.isMateThreat());
+    storeTT(tree,
+            hash,
+            alpha,
+            beta,
+            bestScore,
+            depth,
+            bestMove,
+            nodeStat.isMateThreat());
   }
 
   return bestScore;
@@ -1023,8 +1276,15 @@ void Searcher::updateHistory(Tree& tree,
   HistoryValue value = depth / Depth1Ply;
   updateHistoryWithValue(tree, bestMove, value);
 
-  auto& node = tree.nodes[tree.ply];
-  for (Move move: node.quietsSearched) {
+  // counter move
+  PieceType prevPieceType;
+  Square prevTo;
+  if (getPrevMove(tree, 1, prevPieceType, prevTo)) {
+    tree.counterMoves.set(tree.position.getTurn(), prevPieceType, prevTo, bestMove);
+  }
+
+  auto& coldNode = tree.coldNodes[tree.ply];
+  for (Move move: coldNode.quietsSearched) {
     if (move != bestMove) {
       updateHistoryWithValue(tree, move, -value);
     }
@@ -1035,16 +1295,26 @@ void Searcher::updateHistoryWithValue(Tree& tree,
                                       Move move,
                                       HistoryValue value) {
   Turn turn = tree.position.getTurn();
+  PieceType pieceType;
   if (move.isDrop()) {
-    auto pieceType = move.droppingPieceType();
-    pieceToHistory_.update(turn, pieceType, move.to(), value);
+    pieceType = move.droppingPieceType();
   } else {
-    auto pieceType = tree.position.getPieceOnBoard(move.from()).type();
+    pieceType = tree.position.getPieceOnBoard(move.from()).type();
     if (move.isPromotion()) {
       pieceType = pieceType.promote();
     }
     fromToHistory_.update(turn, move.from(), move.to(), value);
-    pieceToHistory_.update(turn, pieceType, move.to(), value);
+  }
+  pieceToHistory_.update(turn, pieceType, move.to(), value);
+
+  // continuation history
+  for (int n = 1; n <= 2; n++) {
+    PieceType prevPieceType;
+    Square prevTo;
+    if (getPrevMove(tree, n, prevPieceType, prevTo)) {
+      tree.contHistory->update(turn, prevPieceType, prevTo,
+                               pieceType, move.to(), value);
+    }
   }
 }
 
@@ -1058,51 +1328,75 @@ Score Searcher::quies(Tree& tree,
   visit<false>(tree);
 
   auto& node = tree.nodes[tree.ply];
+  auto& coldNode = tree.coldNodes[tree.ply];
 
   tree.info.quiesNodes++;
+  countNode(tree);
 
   node.checkState = tree.position.getCheckState();
 
-  Score bestScore = alpha;
-
-  if (!isCheck(node.checkState)) {
-    Score standPat = calculateStandPat(tree, *evaluator_);
-    if (standPat > bestScore) {
-      bestScore = standPat;
-      if (bestScore >= beta) {
-        return bestScore;
-      }
-    }
-  } else {
-    bestScore = std::max(bestScore, -Score::infinity() + tree.ply);
-  }
-
-  if (tree.ply == Tree::StackSize - 2) {
-    node.isHistorical = true;
-    return calculateStandPat(tree, *evaluator_);
-  }
-
   bool isNullWindow = alpha + 1 == beta;
 
   // transposition table
+  // The static evaluation stored in the entry is reused by calculateStandPat.
   TTElement tte;
-  if (tt_.get(tree.position.getHash(), tte)) {
+  if (probeTT(tree, tree.position.getHash(), tte)) {
     auto ttScoreType = tte.scoreType();
     Score ttScore = tte.score(tree.ply);
-    int ttDepth = tte.depth();
 
     bool isMate = (ttScore <= -Score::mate() && ttScoreType & TTScoreType::Upper) ||
                   (ttScore >=  Score::mate() && ttScoreType & TTScoreType::Lower);
 
     // cut
-    if (isNullWindow && (ttDepth >= depth || isMate)) {
+    if (isNullWindow &&
+        (!tte.isQuies() || tte.depth() >= quiesTTDepth(depth) || isMate)) {
       if (ttScoreType == TTScoreType::Exact ||
-         (ttScoreType == TTScoreType::Upper && ttScore <= bestScore) ||
+         (ttScoreType == TTScoreType::Upper && ttScore <= alpha) ||
          (ttScoreType == TTScoreType::Lower && ttScore >= beta)) {
         tree.info.hashCut++;
         return ttScore;
       }
     }
+
+    // previous best move
+    // It must be validated because the razoring of the main search
+    // keeps the move of this node after the quiescence search.
+    Move ttMove = tte.move();
+    if (tte.isQuies() &&
+        !ttMove.isNone() &&
+        !isCheck(node.checkState) &&
+        tree.position.validateMove(ttMove, node.checkState)) {
+      node.ttMove = ttMove;
+    }
+  }
+
+  Score bestScore = alpha;
+
+  if (!isCheck(node.checkState)) {
+    Score standPat = calculateStandPat(tree, *evaluator_);
+    if (standPat > bestScore) {
+      bestScore = standPat;
+      if (bestScore >= beta) {
+        // the lower bound given by the stand-pat is valid at any depth.
+        storeTT(tree,
+                tree.position.getHash(),
+                alpha,
+                beta,
+                bestScore,
+                quiesTTDepth(0),
+                Move::none(),
+                false,
+                true);
+        return bestScore;
+      }
+    }
+  } else {
+    bestScore = std::max(bestScore, -Score::infinity() + tree.ply);
+  }
+
+  if (tree.ply == Tree::StackSize - 2 || !hasMoveStackSpace(tree)) {
+    node.isHistorical = true;
+    return calculateStandPat(tree, *evaluator_);
   }
 
   if (!isCheck(node.checkState) &&
@@ -1113,6 +1407,8 @@ Score Searcher::quies(Tree& tree,
 
   generateMovesOnQuies(tree, depth);
 
+  Move best = Move::none();
+
   // expand branches
   for (;;) {
     Move move = nextMove(tree);
@@ -1152,9 +1448,10 @@ Score Searcher::quies(Tree& tree,
 
     if (score > bestScore) {
       bestScore = score;
+      best = move;
 
-      auto& childNode = tree.nodes[tree.ply+1];
-      node.pv.set(move, 0, childNode.pv);
+      auto& childColdNode = tree.coldNodes[tree.ply+1];
+      coldNode.pv.set(move, 0, childColdNode.pv);
 
       // beta cut
       if (score >= beta) {
@@ -1163,14 +1460,15 @@ Score Searcher::quies(Tree& tree,
     }
   }
 
-  tt_.store(tree.position.getHash(),
-            alpha,
-            beta,
-            bestScore,
-            depth,
-            tree.ply,
-            Move::none(),
-            false);
+  storeTT(tree,
+          tree.position.getHash(),
+          alpha,
+          beta,
+          bestScore,
+          quiesTTDepth(depth),
+          best,
+          false,
+          true);
 
   return bestScore;
 }
@@ -1183,11 +1481,24 @@ void Searcher::generateMoves(Tree& tree) {
   node.moves.clear();
   node.moveIterator = node.moves.begin();
   node.badCaptureEnd = node.moves.begin();
+  node.seeCache.clear();
 
   if (!node.ttMove.isNone()) {
     node.moves.add(node.ttMove);
   }
 
+  // counter move
+  node.counterMove = Move::none();
+  PieceType prevPieceType;
+  Square prevTo;
+  if (!isCheck(node.checkState) &&
+      getPrevMove(tree, 1, prevPieceType, prevTo)) {
+    Move counterMove = tree.counterMoves.get(tree.position.getTurn(), prevPieceType, prevTo);
+    if (!isPriorMove(tree, counterMove)) {
+      node.counterMove = counterMove;
+    }
+  }
+
   if (!isCheck(node.checkState)) {
     node.genPhase = GenPhase::Init;
   } else {
@@ -1202,9 +1513,10 @@ void Searcher::generateMovesOnQuies(Tree& tree, int depth) {
   auto& node = tree.nodes[tree.ply];
   node.moves.clear();
   node.moveIterator = node.moves.begin();
+  node.seeCache.clear();
 
   if (!isCheck(node.checkState)) {
-    if (depth > -6 * Depth1Ply) {
+    if (depth > Quies2Depth) {
       node.genPhase = GenPhase::InitQuies;
     } else {
       node.genPhase = GenPhase::InitQuies2;
@@ -1222,6 +1534,7 @@ void Searcher::generateMovesOnProbCut(Tree& tree, Score threshold) {
   node.moves.clear();
   node.moveIterator = node.moves.begin();
   node.probThreshold = threshold;
+  node.seeCache.clear();
 
   if (!node.ttMove.isNone()) {
     node.moves.add(node.ttMove);
@@ -1243,13 +1556,15 @@ Move Searcher::nextMove(Tree& tree) {
     remove(node.moves, node.moveIterator, [&node](const Move& move) {
       return move == node.ttMove;
     });
-    sortMoves<true>(tree);
+    scoreMoves<true>(tree);
     node.genPhase++;
+    // fall through
 
   case GenPhase::Captures:
     while (node.moveIterator != node.moves.end()) {
+      pickMove(node, node.moves.end());
       Move move = *node.moveIterator;
-      if (SEE::calculate(tree.position, move) >= Score::zero()) {
+      if (node.seeCache.isGreaterOrEqual(tree.position, move, Score::zero())) {
         return *(node.moveIterator++);
       }
       *(node.badCaptureEnd++) = move;
@@ -1270,8 +1585,18 @@ Move Searcher::nextMove(Tree& tree) {
           !tree.position.isCapture(node.killerMove2)) {
         node.moves.add(node.killerMove2);
       }
+
+      if (!node.counterMove.isNone()) {
+        if (!tree.position.isCapture(node.counterMove) &&
+            tree.position.validateMove(node.counterMove, node.checkState)) {
+          node.moves.add(node.counterMove);
+        } else {
+          node.counterMove = Move::none();
+        }
+      }
     }
     node.genPhase++;
+    // fall through
 
   case GenPhase::Killers:
     if (node.moveIterator != node.moves.end()) {
@@ -1283,16 +1608,31 @@ Move Searcher::nextMove(Tree& tree) {
     remove(node.moves, node.moveIterator, [&tree](const Move& move) {
       return isPriorMove(tree, move);
     });
-    sortMoves<false>(tree);
+    scoreMoves<false>(tree);
+    node.goodQuietEnd = std::partition(node.moveIterator, node.moves.end(), [](const Move& move) {
+      return int16_t(move.extData()) >= 0;
+    });
     node.genPhase++;
+    // fall through
 
   case GenPhase::Quiets:
+    if (node.moveIterator != node.goodQuietEnd) {
+      pickMove(node, node.goodQuietEnd);
+      return *(node.moveIterator++);
+    }
+    node.genPhase++;
+    node.pickCount = 0;
+    // fall through
+
+  case GenPhase::BadQuiets:
     if (node.moveIterator != node.moves.end()) {
+      pickMove(node, node.moves.end());
       return *(node.moveIterator++);
     }
     node.moveIterator = node.moves.begin();
     node.moves.removeAfter(node.badCaptureEnd);
     node.genPhase++;
+    // fall through
 
   case GenPhase::BadCaptures:
     if (node.moveIterator != node.moves.end()) {
@@ -1307,11 +1647,13 @@ Move Searcher::nextMove(Tree& tree) {
     }
 
     MoveGenerator::generateEvasions(tree.position, node.checkState, node.moves);
-    sortMoves<true>(tree);
+    scoreMoves<true>(tree);
     node.genPhase++;
+    // fall through
 
   case GenPhase::Evasions:
     if (node.moveIterator != node.moves.end()) {
+      pickMove(node, node.moves.end());
       return *(node.moveIterator++);
     }
     node.genPhase = GenPhase::End;
@@ -1319,11 +1661,21 @@ Move Searcher::nextMove(Tree& tree) {
 
   case GenPhase::InitQuies: case GenPhase::InitQuies2:
     MoveGenerator::generateCaptures(tree.position, node.moves);
-    sortMoves<true>(tree);
+    scoreMoves<true>(tree);
+    if (!node.ttMove.isNone()) {
+      for (auto ite = node.moveIterator; ite != node.moves.end(); ite++) {
+        if (*ite == node.ttMove) {
+          ite->setExtData(static_cast<Move::RawType16>(INT16_MAX));
+          break;
+        }
+      }
+    }
     node.genPhase++;
+    // fall through
 
   case GenPhase::Quies: case GenPhase::Quies2:
     for (; node.moveIterator != node.moves.end(); node.moveIterator++) {
+      pickMove(node, node.moves.end());
       Move move = *node.moveIterator;
 
       if (node.genPhase == GenPhase::Quies2) {
@@ -1335,7 +1687,9 @@ Move Searcher::nextMove(Tree& tree) {
         }
       }
 
-      if (SEE::calculate(tree.position, move) < Score::zero()) {
+      // the best move of the previous visit has already passed SEE.
+      if (move != node.ttMove &&
+          !node.seeCache.isGreaterOrEqual(tree.position, move, Score::zero())) {
         continue;
       }
 
@@ -1353,14 +1707,16 @@ Move Searcher::nextMove(Tree& tree) {
     remove(node.moves, node.moveIterator, [&node](const Move& move) {
       return move == node.ttMove;
     });
-    sortMoves<true>(tree);
+    scoreMoves<true>(tree);
     node.genPhase++;
+    // fall through
 
   case GenPhase::ProbCaptures:
     for (; node.moveIterator != node.moves.end(); node.moveIterator++) {
+      pickMove(node, node.moves.end());
       Move move = *node.moveIterator;
 
-      if (SEE::calculate(tree.position, move) < node.probThreshold) {
+      if (!node.seeCache.isGreaterOrEqual(tree.position, move, node.probThreshold)) {
         continue;
       }
 
@@ -1383,11 +1739,22 @@ Move Searcher::nextMove(Tree& tree) {
   return Move::none();
 }
 
+/**
+ * Score the moves in the range [node.moveIterator, moves.end()).
+ * The moves are picked in order of the score by pickMove().
+ */
 template <bool Capture>
-void Searcher::sortMoves(Tree& tree) {
+void Searcher::scoreMoves(Tree& tree) {
   auto& node = tree.nodes[tree.ply];
   auto turn = tree.position.getTurn();
 
+  PieceType prevPieceType[2];
+  Square prevTo[2];
+  bool hasPrev[2];
+  for (int n = 1; n <= 2; n++) {
+    hasPrev[n-1] = getPrevMove(tree, n, prevPieceType[n-1], prevTo[n-1]);
+  }
+
   for (auto ite = node.moveIterator; ite != node.moves.end(); ite++) {
     auto& move = *ite;
     if (Capture && tree.position.isCapture(move)) {
@@ -1398,25 +1765,37 @@ void Searcher::sortMoves(Tree& tree) {
                   + HistoryMax * 2;
       move.setExtData(static_cast<Move::RawType16>(score.raw()));
     } else {
+      PieceType pieceType;
       HistoryValue value;
       if (move.isDrop()) {
-        auto pieceType = move.droppingPieceType();
+        pieceType = move.droppingPieceType();
         value = pieceToHistory_.get(turn, pieceType, move.to());
       } else {
-        auto pieceType = tree.position.getPieceOnBoard(move.from()).type();
+        pieceType = tree.position.getPieceOnBoard(move.from()).type();
         if (move.isPromotion()) {
           pieceType = pieceType.promote();
         }
         value = std::max(fromToHistory_.get(turn, move.from(), move.to()),
                          pieceToHistory_.get(turn, pieceType, move.to()));
       }
+
+      // continuation history
+      // The total is scaled into the range of HistoryMax,
+      // so that the quiet moves are ordered below the captures.
+      int32_t contValue = 0;
+      for (int i = 0; i < 2; i++) {
+        if (hasPrev[i]) {
+          contValue += tree.contHistory->get(turn, prevPieceType[i], prevTo[i],
+                                             pieceType, move.to());
+        }
+      }
+      value = static_cast<HistoryValue>((int32_t(value) * 2 + contValue) / 4);
+
       move.setExtData(static_cast<Move::RawType16>(value));
     }
   }
 
-  std::sort(node.moveIterator, node.moves.end(), [](const Move& lhs, const Move& rhs) {
-    return int16_t(lhs.extData()) > int16_t(rhs.extData());
-  });
+  node.pickCount = 0;
 }
 
 void Searcher::sortRootMoves(Tree& tree) {
@@ -1432,31 +1811,19 @@ void Searcher::sortRootMoves(Tree& tree) {
     ttMove = tte.move();
   }
 
-  for (Moves::size_type moveCount = 0; moveCount < node.moves.size();) {
-    Move move = node.moves[moveCount];
-
-    Piece captured;
-    bool moveOk = tree.position.doMove(move, captured);
-    if (!moveOk) {
-      node.moves.remove(moveCount);
-      continue;
-    }
-    tree.position.undoMove(move, captured);
-
+  node.seeCache.clear();
+  for (auto& move : node.moves) {
     if (move == ttMove) {
-      setScoreToMove(node.moves[moveCount], Score::infinity());
-      moveCount++;
+      setScoreToMove(move, Score::infinity());
       continue;
     }
 
-    Score score = SEE::calculate(tree.position, move);
+    Score score = node.seeCache.calculate(tree.position, move);
     if (move.isPromotion()) {
       score += 1;
     }
 
-    setScoreToMove(node.moves[moveCount], score);
-
-    moveCount++;
+    setScoreToMove(move, score);
   }
 
   std::sort(node.moves.begin(), node.moves.end(), [](Move lhs, Move rhs) {
@@ -13,13 +13,16 @@
 #include "search/SearchHandler.hpp"
 #include "search/time/TimeManager.hpp"
 #include "search/tree/Tree.hpp"
+#include "search/tree/SharedRootResults.hpp"
 #include "search/tree/NodeStat.hpp"
 #include "search/tt/TT.hpp"
+#include "search/eval/EvalCache.hpp"
+#include "search/trace/Tracer.hpp"
 #include "search/history/History.hpp"
 #include "common/math/Random.hpp"
 #include "common/time/Timer.hpp"
 #include <memory>
-#include <mutex>
+#include <vector>
 #include <atomic>
 #include <array>
 #include <climits>
@@ -28,14 +31,16 @@ namespace sunfish {
 
 class Position;
 class Move;
-struct Record;
+class GameHistory;
 class Evaluator;
+class TTShare;
 
 class Searcher {
 public:
 
   static CONSTEXPR_CONST int Depth1Ply = 4;
   static CONSTEXPR_CONST int DepthInfinity = INT_MAX;
+  static CONSTEXPR_CONST uint32_t CheckInterval = 256;
 
   static void initialize();
 
@@ -43,30 +48,39 @@ public:
 
   Searcher(std::shared_ptr<Evaluator> evaluator);
 
+  /**
+   * clear TT, the history tables and the evaluation caches of the threads.
+   * the shared cache of the evaluator is not cleared,
+   * because it may be used by other searchers.
+   */
   void clean();
 
+  /**
+   * 'history' is the game history before 'pos' used to detect repetitions.
+   * it is shared by all search threads and must not be changed while searching.
+   */
   void search(const Position& pos,
               int depth,
-              Record* record = nullptr) {
+              const GameHistory* history = nullptr) {
     search(pos,
            depth,
            -Score::infinity(),
            Score::infinity(),
-           record);
+           history);
   }
 
   void search(const Position& pos,
               int depth,
               Score alpha,
               Score beta,
-              Record* record = nullptr);
+              const GameHistory* history = nullptr);
 
   /**
    * iterative deepening search.
    */
   void idsearch(const Position& pos,
                 int maxDepth,
-                Record* record = nullptr);
+                const GameHistory* history = nullptr);
 
   const SearchConfig& getConfig() const {
     return config_;
@@ -80,10 +94,21 @@ public:
     return result_;
   }
 
-  const SearchInfo& getInfo() const {
-    return info_;
+  /**
+   * the PVs of the root moves in the last iteration of the main thread.
+   * (multi-PV)
+   * they are incomplete if the iteration was interrupted.
+   */
+  const RootPVs& getRootPVs() const {
+    return trees_[0].rootPVs;
   }
 
+  /**
+   * get a snapshot of the counters of all threads.
+   * this can be called while searching.
+   */
+  SearchInfo getInfo() const;
+
   void interrupt() {
     interrupted_ = true;
   }
@@ -96,24 +121,89 @@ public:
     return evaluator_;
   }
 
+  SearchHandler* getHandler() const {
+    return handler_;
+  }
+
   void setHandler(SearchHandler* handler) {
     handler_ = handler;
   }
 
+  /**
+   * set the seed of the random generator used to shuffle root moves.
+   * it makes a single-threaded search reproducible.
+   */
+  void seedRandom(unsigned seed) {
+    random_.seed(seed);
+  }
+
+  /**
+   * the number of trees used by the last search.
+   */
+  int getNumberOfTrees() const {
+    return treeSize_;
+  }
+
+  /**
+   * the depth which the specified thread completed in the last search.
+   */
+  int getCompletedDepth(int index) const {
+    return trees_[index].completedDepth;
+  }
+
   float ttUsageRates() const {
     return tt_.usageRates();
   }
 
+  TT& getTT() {
+    return tt_;
+  }
+
+  /**
+   * the deep entries stored into TT are sent to the other processes
+   * through the specified object. (nullptr: disabled)
+   */
+  void setTTShare(TTShare* ttShare) {
+    ttShare_ = ttShare;
+  }
+
+  /**
+   * the index of this process in a cluster.
+   * the processes except the first one skip some iterations
+   * like the helper threads so that they search different depths.
+   */
+  void setClusterIndex(int index) {
+    clusterIndex_ = index;
+  }
+
   void ttResizeMB(unsigned mebiBytes) {
     tt_.resizeMB(mebiBytes);
+    tracer_.instant(0, "tt resize", "MiB", mebiBytes);
+  }
+
+  /**
+   * resize the evaluation cache.
+   * if perThread is true, each search thread has its own cache of this size
+   * instead of the cache shared by the searchers using the same Evaluator.
+   */
+  void evalCacheResizeMB(unsigned mebiBytes, bool perThread = false);
+
+  /**
+   * the tracer is disabled by default.
+   * call getTracer().enable() before searching to record events.
+   */
+  Tracer& getTracer() {
+    return tracer_;
+  }
+
+  const Tracer& getTracer() const {
+    return tracer_;
   }
 
 private:
 
   void onSearchStarted(const Position& pos,
-                       Record* record);
-
-  void mergeInfo(Tree& tree);
+                       const GameHistory* history);
 
   bool prepareIDSearch(Tree& tree,
                        Tree& tree0);
@@ -153,7 +243,7 @@ private:
   Move nextMove(Tree& tree);
 
   template <bool Capture>
-  void sortMoves(Tree& tree);
+  void scoreMoves(Tree& tree);
 
   void sortRootMoves(Tree& tree);
 
@@ -165,24 +255,82 @@ private:
                Score score);
 
   bool isInterrupted() const {
-    if (interrupted_.load(std::memory_order_relaxed)) {
-      return true;
+    return interrupted_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * count a node and check the node and time limits
+   * once every CheckInterval nodes.
+   */
+  void countNode(Tree& tree) {
+    if (++tree.checkCount >= CheckInterval) {
+      checkLimits(tree);
     }
+  }
 
-    if (timer_.elapsedMs() >= config_.maximumTimeMs) {
+  void checkLimits(Tree& tree);
+
+  SearchConfig::TimeType elapsedMs() const;
+
+  bool probeTT(Tree& tree,
+               Zobrist::Type hash,
+               TTElement& tte) {
+    tree.info.ttProbe++;
+    if (tt_.get(hash, tte)) {
+      tree.info.ttHit++;
+      // reuse the static evaluation instead of calculating it again.
+      auto& node = tree.nodes[tree.ply];
+      if (node.score == Score::invalid()) {
+        node.score = tte.eval();
+      }
       return true;
     }
-
     return false;
   }
 
+  void storeTT(Tree& tree,
+               Zobrist::Type hash,
+               Score alpha,
+               Score beta,
+               Score score,
+               int depth,
+               const Move& move,
+               bool mateThreat,
+               bool quies = false) {
+    tree.info.ttStore++;
+    auto status = tt_.store(hash, alpha, beta, score, depth, tree.ply, move, mateThreat,
+                            tree.nodes[tree.ply].score, quies);
+    if (status == TTStatus::Replace) {
+      tree.info.ttReplace++;
+    }
+    if (ttShare_ != nullptr && !quies && status != TTStatus::Reject) {
+      shareTT(hash, depth);
+    }
+  }
+
+  void shareTT(Zobrist::Type hash, int depth);
+
+  bool loadRootResult(Tree& tree,
+                      Move move,
+                      int depth,
+                      Score alpha,
+                      Score beta,
+                      Score& score);
+
+  void storeRootResult(Tree& tree,
+                       Move move,
+                       int depth,
+                       Score alpha,
+                       Score beta,
+                       Score score);
+
   SearchConfig config_;
   SearchResult result_;
-  SearchInfo info_;
-  std::mutex infoMutex_;
 
   std::atomic_bool interrupted_;
+  std::atomic<uint64_t> nodes_;
   Timer timer_;
+  SearchConfig::TimeType nextStatsMs_;
 
   std::shared_ptr<Evaluator> evaluator_;
 
@@ -194,12 +342,25 @@ private:
   std::unique_ptr<Tree[]> trees_;
   int treeSize_;
 
+  std::vector<std::unique_ptr<EvalCache>> evalCaches_;
+  unsigned evalCacheMebiBytes_;
+  bool evalCachePerThread_;
+
   Random random_;
 
   TimeManager timeManager_;
 
+  Tracer tracer_;
+
   SearchHandler* handler_;
 
+  TTShare* ttShare_;
+  int clusterIndex_;
+
+  /** the helper threads search their own parts of the root moves. (multi-PV) */
+  bool rootSplit_;
+  SharedRootResults rootResults_;
+
 };
 
 } // namespace sunfish
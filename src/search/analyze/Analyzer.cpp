@@ -0,0 +1,233 @@
+/* Analyzer.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/analyze/Analyzer.hpp"
+#include "search/Searcher.hpp"
+#include "search/shek/GameHistory.hpp"
+#include "search/eval/Material.hpp"
+#include "core/position/Position.hpp"
+#include "core/record/Record.hpp"
+#include "core/record/SfenParser.hpp"
+#include "common/string/StringUtil.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <cctype>
+
+namespace {
+
+using namespace sunfish;
+
+bool parseLine(const std::string& line, Record& record) {
+  auto args = StringUtil::split(line, [](char c) {
+    return isspace(c);
+  });
+
+  if (args.empty()) {
+    return false;
+  }
+
+  if (args[0] != "position") {
+    if (args[0] != "sfen" && args[0] != "startpos") {
+      args.insert(args.begin(), "sfen");
+    }
+    args.insert(args.begin(), "position");
+  }
+
+  return SfenParser::parseUsiCommand(args.begin(), args.end(), record);
+}
+
+void writeString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\';
+    }
+    os << c;
+  }
+  os << '"';
+}
+
+} // namespace
+
+namespace sunfish {
+
+Analyzer::Analyzer() {
+  config_.depth = 8;
+  config_.maximumTimeMs = SearchConfig::InfinityTime;
+  config_.maximumNodes = SearchConfig::InfinityNodes;
+  config_.numberOfSearchers = 1;
+  config_.numberOfThreads = 1;
+  config_.hashMebiBytes = 16;
+}
+
+Analyzer::~Analyzer() {
+}
+
+bool Analyzer::analyze(std::istream& is, const Callback& callback) {
+  return analyze([&is](std::string& line) {
+    return static_cast<bool>(std::getline(is, line));
+  }, callback);
+}
+
+bool Analyzer::analyze(const std::vector<std::string>& positions,
+                       std::vector<Result>& results) {
+  size_t next = 0;
+  results.clear();
+  return analyze([&positions, &next](std::string& line) {
+    if (next >= positions.size()) {
+      return false;
+    }
+    line = positions[next++];
+    return true;
+  }, [&results](const Result& result) {
+    results.push_back(result);
+  });
+}
+
+bool Analyzer::analyze(const Source& source, const Callback& callback) {
+  if (config_.depth < 1) {
+    LOG(error) << "invalid depth: " << config_.depth;
+    return false;
+  }
+
+  prepareSearchers();
+
+  std::mutex mutex;
+  uint64_t nextInput = 0;
+  uint64_t nextOutput = 0;
+  bool eof = false;
+
+  // the results finished out of order wait here.
+  std::map<uint64_t, Result> pending;
+
+  auto worker = [this, &source, &callback, &mutex, &nextInput, &nextOutput, &eof, &pending](size_t index) {
+    while (true) {
+      Result result;
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string line;
+        while (true) {
+          if (eof || !source(line)) {
+            eof = true;
+            return;
+          }
+          line = StringUtil::trim(line);
+          if (!line.empty() && line[0] != '#') {
+            break;
+          }
+        }
+        result.index = nextInput++;
+        result.position = line;
+      }
+
+      analyze(*searchers_[index], *histories_[index], result);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.insert(std::make_pair(result.index, std::move(result)));
+      while (!pending.empty() && pending.begin()->first == nextOutput) {
+        callback(pending.begin()->second);
+        pending.erase(pending.begin());
+        nextOutput++;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < searchers_.size(); i++) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return true;
+}
+
+void Analyzer::prepareSearchers() {
+  size_t size = std::max(config_.numberOfSearchers, 1);
+  while (searchers_.size() < size) {
+    searchers_.emplace_back(new Searcher());
+    histories_.emplace_back(new GameHistory());
+  }
+  searchers_.resize(size);
+  histories_.resize(size);
+
+  for (auto& searcher : searchers_) {
+    auto config = searcher->getConfig();
+    config.optimumTimeMs = SearchConfig::InfinityTime;
+    config.maximumTimeMs = config_.maximumTimeMs;
+    config.maximumNodes = config_.maximumNodes;
+    config.nodesPerMs = 0;
+    config.statsIntervalMs = 0;
+    config.numberOfThreads = config_.numberOfThreads;
+    config.multiPV = 1;
+    searcher->setConfig(config);
+    searcher->setHandler(nullptr);
+    searcher->ttResizeMB(config_.hashMebiBytes);
+  }
+}
+
+void Analyzer::analyze(Searcher& searcher, GameHistory& history, Result& result) {
+  Record record;
+  result.valid = parseLine(result.position, record) && history.sync(record);
+  result.move = Move::none();
+  result.score = Score::zero();
+  result.pv.clear();
+  result.depth = 0;
+  result.nodes = 0;
+  result.elapsed = 0.0f;
+
+  if (!result.valid) {
+    return;
+  }
+
+  searcher.clean();
+  searcher.idsearch(history.getPosition(), config_.depth * Searcher::Depth1Ply, &history);
+
+  const auto& searchResult = searcher.getResult();
+  auto info = searcher.getInfo();
+  result.move = searchResult.move;
+  result.score = searchResult.score;
+  result.pv = searchResult.pv;
+  result.depth = searchResult.depth / Searcher::Depth1Ply;
+  result.nodes = info.nodes + info.quiesNodes;
+  result.elapsed = searchResult.elapsed;
+}
+
+void Analyzer::writeJson(std::ostream& os, const Result& result) {
+  os << "{\"index\":" << result.index << ",\"position\":";
+  writeString(os, result.position);
+
+  if (!result.valid) {
+    os << ",\"error\":\"invalid position\"}\n";
+    return;
+  }
+
+  os << ",\"move\":\"" << (result.move.isNone() ? "resign" : result.move.toStringSFEN()) << "\"";
+
+  Score score = result.score;
+  if (score > -Score::mate() && score < Score::mate()) {
+    os << ",\"cp\":" << static_cast<int>(score.raw() * 100.0 / material::pawn().raw());
+  } else if (score >= 0) {
+    os << ",\"mate\":" << (Score::infinity() - score).raw();
+  } else {
+    os << ",\"mate\":" << -(Score::infinity() + score).raw();
+  }
+
+  os << ",\"score\":" << score.raw()
+     << ",\"pv\":\"" << result.pv.toStringSFEN() << "\""
+     << ",\"depth\":" << result.depth
+     << ",\"nodes\":" << result.nodes
+     << ",\"elapsed\":" << result.elapsed
+     << "}\n";
+}
+
+} // namespace sunfish
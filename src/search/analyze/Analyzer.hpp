@@ -0,0 +1,109 @@
+/* Analyzer.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_ANALYZE_ANALYZER_HPP__
+#define SUNFISH_SEARCH_ANALYZE_ANALYZER_HPP__
+
+#include "search/SearchConfig.hpp"
+#include "search/eval/Score.hpp"
+#include "search/tree/PV.hpp"
+#include "core/move/Move.hpp"
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+class Searcher;
+class GameHistory;
+
+/**
+ * Analyzer searches a list of positions on a pool of searchers.
+ * Each line of the input is one of the following:
+ *   <sfen>
+ *   sfen <sfen> [moves ...]
+ *   startpos [moves ...]
+ *   position (sfen <sfen>|startpos) [moves ...]
+ * Empty lines and lines beginning with '#' are skipped.
+ */
+class Analyzer {
+public:
+
+  /** the depth used when only the time or the nodes are limited */
+  static CONSTEXPR_CONST int MaximumDepth = 64;
+
+  struct Config {
+    int depth;
+    SearchConfig::TimeType maximumTimeMs;
+    SearchConfig::NodesType maximumNodes;
+    /** the number of positions searched concurrently */
+    int numberOfSearchers;
+    /** the number of threads of each searcher */
+    int numberOfThreads;
+    unsigned hashMebiBytes;
+  };
+
+  struct Result {
+    /** 0-origin index of the position in the input */
+    uint64_t index;
+    std::string position;
+    bool valid;
+    Move move;
+    Score score;
+    PV pv;
+    int depth;
+    uint64_t nodes;
+    float elapsed;
+  };
+
+  /**
+   * the results are called back in the input order.
+   */
+  using Callback = std::function<void(const Result& result)>;
+
+  Analyzer();
+
+  ~Analyzer();
+
+  bool analyze(std::istream& is, const Callback& callback);
+
+  bool analyze(const std::vector<std::string>& positions,
+               std::vector<Result>& results);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  /**
+   * write a result as a single line JSON.
+   */
+  static void writeJson(std::ostream& os, const Result& result);
+
+private:
+
+  using Source = std::function<bool(std::string& line)>;
+
+  bool analyze(const Source& source, const Callback& callback);
+
+  void prepareSearchers();
+
+  void analyze(Searcher& searcher, GameHistory& history, Result& result);
+
+  Config config_;
+  std::vector<std::unique_ptr<Searcher>> searchers_;
+  std::vector<std::unique_ptr<GameHistory>> histories_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_ANALYZE_ANALYZER_HPP__
@@ -0,0 +1,176 @@
+/* Bench.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/bench/Bench.hpp"
+#include "search/Searcher.hpp"
+#include "core/position/Position.hpp"
+#include "core/record/SfenParser.hpp"
+#include "logger/Logger.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+using namespace sunfish;
+
+/**
+ * positions picked from professional games at various stages.
+ */
+const std::vector<std::string> Positions = {
+  "lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b - 1",
+  "ln1g1k1nl/1r1s1sgb1/p1pp1p1pp/1p2p1p2/9/2P1P4/PPSP1PPPP/1BG1GS1R1/LN1K3NL w - 1",
+  "l4k1nl/1r4gb1/p1ns1gspp/2ppppp2/1p7/P1PS1PPP1/1P1P1SN1P/1BG1G2R1/LN1K4L b P 1",
+  "l5knl/1r4g2/2ns1gsp1/p1pbppp1p/3pP4/P1P1S1PPP/1P1PSGN2/1BG1K2R1/LN6L w Pp 1",
+  "l6n1/6gk1/2ns1gspl/2p1Ppp2/p2pS2Np/P5rP1/1P1PG4/1BG4R1/LN1K4L b PB5ps 1",
+  "l4k3/7g1/2ns1+P1p+P/2p2Bp2/p2p4p/P5rP1/1P1PG4/2G4+s1/LN2K3L w NSGR6plnsb 1",
+  "ln1gk1snl/1r1s2gb1/pppp1p1pp/6p2/4p4/2P6/PP1PPPP1P/1B1S1S1R1/LN1GKG1NL w P 1",
+  "ln1g1k1nl/1r3sgb1/p2p1p1pp/2ps2p2/9/2PSSP3/PP1P2P1P/1BG4R1/LN1K1G1NL b 2P2p 1",
+  "ln3k1nl/1r4gb1/3psg1p1/p1ps4p/4PP3/P1PSS1R2/1P1P4P/2G1G4/LNBK3NL w 2P4p 1",
+  "ln3k1nl/1r4gb1/3p1g3/p1p2sPpp/4pN1P1/P1PS2R2/1P1P4P/2G1G4/LNBK4L b PS4ps 1",
+  "ln3k2l/1r3p1p1/3p1gG2/p1p2snPp/4p1p2/P1PS2s2/BP1P4P/2G1G1s2/LN1K3RL w 2PNB2p 1",
+  "ln1gkg1nl/1r1s3b1/p1pp1pspp/4p1p2/1p5P1/2PP5/PPS1PPP1P/3B3R1/LN1GKGSNL w - 1",
+  "ln4knl/1r4g2/p1bpsgspp/2p1ppp2/1p5P1/2PPP2S1/PPSG1PP1P/1KGB3R1/LN5NL b - 1",
+  "1n4knl/1r4gs1/l1bp1g1pp/p1p2sp2/1p3p2P/P1PPP2S1/1PSG1PP2/1KGB1R3/LN5NL w Pp 1",
+  "1n2l1kn1/1r4gs1/l2p2g2/p1p3pp1/1p2bps1S/P1PP2P2/1PSG1P1L1/1KGB3R1/LN5N1 b 5p 1",
+  "1n2l1k1+P/1r4gg1/l2p2s2/p1p2sppp/1p2bp3/P1PPP1P2/1PSG1P1L1/1KGB4+R/LN5N1 w N2ps 1",
+  "lnsg1k1nl/1r4gs1/p1pppp1pp/6p2/1p5P1/2P5P/PPSPPPP2/2G4R1/LN2KGSNL w Bb 1",
+  "ln5nl/1r2g1gk1/2pps1sp1/p4p2p/1p2p1SP1/P1PP4P/1PSBPPP2/2G4R1/LN2KG1NL b Pb 1",
+  "ln5nS/1r2g1g1k/2pp3+Pl/p3s4/1p2pp2p/P1PP5/1PSBPPP2/2G4R1/LN2KG1NL w P2psb 1",
+  "ln5nS/1r7/2pp1g3/p3sk1L1/1p2ppnGL/P1PP5/1PSBPPPR1/2G6/LN2KG3 b 2P3psb 1",
+  "ln6S/1r2s4/2ppk+P3/p5+L2/1p2pp2L/P1PP2N2/1PSBP+nP2/2G6/LN2KG1+r1 w G5psgb 1",
+  "ln1g1ksnl/1r1s2gb1/p1ppppppp/9/1p7/P5R2/1PPPPPP1P/1BG6/LNS1KGSNL w P 1",
+  "ln5nl/1rg3gk1/p1ppssbp1/4ppp1p/PpP6/2R5P/1P1PPPP2/1BG3S2/LN2SGKNL b P 1",
+  "ln5nl/1r3bgk1/4ss1p1/1gG1ppp1p/9/pR6P/1PN1PPP2/1B4S2/L3SGKNL w 4P3p 1",
+  "lr5nl/5bgk1/2pP1s1p1/3sppp1p/5+b3/pP5RP/2N1PPP2/1g4S2/L3SGKNL b 3PNG2p 1",
+  "l1+P4nl/3+P1bgk1/2p2s1p1/3r1pp1P/1P2s4/p5PR1/2+l+bPPN2/6S2/g3SGK1L w 4PNG2pn 1",
+  "lnsg1g1nl/1k3rsb1/ppppp2pp/5pp2/9/P1P1P2P1/1P1P1PP1P/1BK1GS1R1/LNSG3NL w - 1",
+  "ln1g3nl/1ks3r2/1p1g1sbp1/p1ppppp1p/7P1/PPPPP3P/1SBGSPP2/1K5R1/LN1G3NL b - 1",
+  "l6n1/1kg1r4/1sng2bpl/ppp2ps1p/3pB1pP1/PPP1PP2P/1S1G2P2/L1G4R1/KNS4NL w 2p 1",
+  "l6n1/1kg4r1/1sng2bp1/ppp2ps2/3p2pPl/PPP1PP1Rp/1SBG2P2/LSG5P/KN5NL b 2p 1",
+  "l6n1/1kg2b3/1sng1+P1r1/ppp3P2/3p2s1l/PPP1Ppp1p/1SBGR2+p1/LSG5P/KN5NL w 2Pp 1",
+  "lnsg1g1n1/2k2s2r/ppppp1bpp/5p3/6pPP/2P6/PP1PPPP2/1BK4R1/LNSG1GSNL b - 1",
+  "ln1g3n1/1ks1gbr2/1ppp1s1p1/p3pp2L/6PP1/P1P1PPR2/1P1P5/1BK1GS3/LNSG3N1 w P2p 1",
+  "ln1g5/1ks1g4/1ppp1s1+Pp/p3p2p1/5pb2/P1lBP4/1P1P5/2K1GS3/LNSG3N1 b NR5pr 1",
+  "ln1g5/1ksg1+PR2/1ppp1B2p/p4s1p1/4Pp3/P1l1p4/1PNPs4/2KBGP3/LNSG3+r1 w P3pn 1",
+  "ln1g5/1ksg2+P2/1ppp4p/p4s1p1/4Pp3/P1+BB5/1PNP5/1K3P3/LNS+s3+r1 b 2PLNR3p2g 1",
+  "lnsgkg1nl/1r5b1/p1ppps1pp/5p3/1pP3p2/P2P5/1PBSPPPPP/2R6/LN1GKGSNL w - 1",
+  "ln5nl/1r1sg1gb1/p1p4k1/3Rppspp/1pP3p2/P3SP2P/1PB1P1PP1/6S2/LN1G1GKNL b Pp 1",
+  "ln5nl/1r4g2/p1pp1gbk1/3sp1spp/2P3p2/PP3PP1P/2B1PG1P1/6S2/LN1R1GKNL w 2PSp 1",
+  "ln3S1nl/6g2/p1pp1gk2/3sps2p/B1P6/P4PP1P/1+r+b1PG3/3R2S2/L4GKNL b 3P4pn 1",
+  "ln2B2nl/9/p1ppsk3/4p3p/2P2s3/P5P1P/2+r1P1GS1/3P5/L4GKNL w 2PN2G5psbr 1",
+  "lnsg1g1nl/3k1r1b1/ppppps1p1/5pp1p/9/P1PP5/1P1SPPPPP/1BR3K2/LN1G1GSNL w - 1",
+  "ln5nl/1skggr1b1/ppppp4/4s1p1p/1P5p1/P1RP1p3/B1NSPPPPP/4G1KS1/L4G1NL b P 1",
+  "ln6l/1skgg2b1/ppppp1n2/4s1r1p/1P1P2p2/P1R6/B1NSPPPPP/4G1KS1/L4G1NL w P2p 1",
+  "ln6l/1skgg4/ppp1p3b/3p3rp/1P4Ps1/P1RS3S1/B1N1PP1PP/4GGK2/L7L b 3PN2pn 1",
+  "ln6l/1sk6/ppp1pn1r1/3B4p/1P4bS1/P5RP1/2N1PP2P/4GGK2/L7L w 5P2G2pn2s 1",
+  "ln1gkg1nl/2s2r1b1/1pppps1pp/p4pp2/9/2P1P2P1/PPBPSPP1P/2K4R1/LNSG1G1NL w - 1",
+  "l1kg3nl/2s4r1/1png1sbpp/p1p1ppp2/3p3P1/1PP1P4/PKSP1PP1P/1SGB3R1/LN1G3NL b - 1",
+  "l2g3nl/1k5r1/1sng1s1p1/1pp1ppp1p/p2p3R1/1PP1P1P1P/PSSP1P2L/KGGB5/LN5N+b w P 1",
+  "l6nl/1kg4r1/1sng3p1/1pp2+bP1p/p4p1R1/1PPPs3P/PSS2PN1L/KGGB5/LN7 b 4Pp 1",
+  "l8/1kg6/1sng1+B1p1/1pp5p/p4p1r1/1PPPsP1PP/PSS5L/KGG6/LN4+r2 w 4PLNpnb 1",
+};
+
+CONSTEXPR_CONST unsigned RandomSeed = 0;
+
+uint64_t mix(uint64_t signature, uint64_t value) {
+  // FNV-1a
+  for (int i = 0; i < 8; i++) {
+    signature ^= (value >> (i * 8)) & 0xff;
+    signature *= 0x100000001b3llu;
+  }
+  return signature;
+}
+
+} // namespace
+
+namespace sunfish {
+
+const std::vector<std::string>& Bench::positions() {
+  return Positions;
+}
+
+Bench::Bench() {
+  config_.depth = 8;
+  config_.numberOfThreads = 1;
+  config_.hashMebiBytes = 16;
+  config_.effectBoard = false;
+}
+
+bool Bench::run(Searcher& searcher) {
+  if (config_.depth < 1) {
+    LOG(error) << "invalid depth: " << config_.depth;
+    return false;
+  }
+
+  auto savedConfig = searcher.getConfig();
+  auto savedHandler = searcher.getHandler();
+
+  auto config = savedConfig;
+  config.optimumTimeMs = SearchConfig::InfinityTime;
+  config.maximumTimeMs = SearchConfig::InfinityTime;
+  config.maximumNodes = SearchConfig::InfinityNodes;
+  config.nodesPerMs = 0;
+  config.numberOfThreads = config_.numberOfThreads;
+  config.effectBoard = config_.effectBoard;
+  config.multiPV = 1;
+  searcher.setConfig(config);
+  searcher.setHandler(nullptr);
+  searcher.ttResizeMB(config_.hashMebiBytes);
+
+  result_.positions = 0;
+  result_.nodes = 0;
+  result_.elapsed = 0.0f;
+  result_.signature = 0xcbf29ce484222325llu;
+
+  bool ok = true;
+  for (const auto& sfen : Positions) {
+    Position pos;
+    if (!SfenParser::parsePosition(sfen, pos)) {
+      LOG(error) << "invalid SFEN: " << sfen;
+      ok = false;
+      break;
+    }
+
+    searcher.clean();
+    // every position starts with a cold evaluation cache.
+    searcher.getEvaluator()->cache().clear();
+    searcher.seedRandom(RandomSeed);
+    searcher.idsearch(pos, config_.depth * Searcher::Depth1Ply);
+
+    const auto& info = searcher.getInfo();
+    const auto& result = searcher.getResult();
+    uint64_t nodes = info.nodes + info.quiesNodes;
+
+    result_.positions++;
+    result_.nodes += nodes;
+    result_.elapsed += result.elapsed;
+    result_.signature = mix(result_.signature, nodes);
+
+    MSG(info) << "position " << std::setw(2) << result_.positions
+              << ": nodes=" << std::setw(10) << nodes
+              << " best=" << result.move.toStringSFEN();
+  }
+
+  searcher.setConfig(savedConfig);
+  searcher.setHandler(savedHandler);
+
+  if (ok) {
+    MSG(info) << "positions : " << result_.positions;
+    MSG(info) << "nodes     : " << result_.nodes;
+    MSG(info) << "elapsed   : " << result_.elapsed;
+    MSG(info) << "nps       : " << nps();
+    MSG(info) << "signature : " << signatureString();
+  }
+
+  return ok;
+}
+
+std::string Bench::signatureString() const {
+  std::ostringstream oss;
+  oss << std::hex << std::setw(16) << std::setfill('0') << result_.signature;
+  return oss.str();
+}
+
+} // namespace sunfish
@@ -0,0 +1,77 @@
+/* Bench.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_BENCH_BENCH_HPP__
+#define SUNFISH_SEARCH_BENCH_BENCH_HPP__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+class Searcher;
+
+/**
+ * Bench searches the built-in positions to a fixed depth.
+ * With a single thread, the signature only changes when the
+ * shape of the search tree changes.
+ */
+class Bench {
+public:
+
+  struct Config {
+    int depth;
+    int numberOfThreads;
+    unsigned hashMebiBytes;
+    /** the signature must not change with the effect board. */
+    bool effectBoard;
+  };
+
+  struct Result {
+    int positions;
+    uint64_t nodes;
+    float elapsed;
+    uint64_t signature;
+  };
+
+  /**
+   * the built-in positions in SFEN.
+   */
+  static const std::vector<std::string>& positions();
+
+  Bench();
+
+  bool run(Searcher& searcher);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  const Result& getResult() const {
+    return result_;
+  }
+
+  uint64_t nps() const {
+    float elapsed = result_.elapsed > 1.0e-3f ? result_.elapsed : 1.0e-3f;
+    return static_cast<uint64_t>(result_.nodes / elapsed);
+  }
+
+  std::string signatureString() const;
+
+private:
+
+  Config config_;
+  Result result_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_BENCH_BENCH_HPP__
@@ -0,0 +1,202 @@
+/* TTShare.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/cluster/TTShare.hpp"
+#include "search/tt/TT.hpp"
+#include "search/Searcher.hpp"
+#include "common/string/StringUtil.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+using namespace sunfish;
+
+CONSTEXPR_CONST uint32_t Magic = 0x53465454; // "SFTT"
+
+CONSTEXPR_CONST size_t HeaderSize = 8;
+CONSTEXPR_CONST size_t EntrySize = sizeof(Zobrist::Type) + sizeof(TTElement);
+
+/** the datagrams are kept smaller than the typical MTU. */
+CONSTEXPR_CONST size_t MaximumEntries = 64;
+CONSTEXPR_CONST size_t MaximumDatagramSize = HeaderSize + EntrySize * MaximumEntries;
+
+/** the entries are sent at this interval. */
+CONSTEXPR_CONST int SendIntervalMs = 5;
+
+/** the entries which could not be sent in time are dropped. */
+CONSTEXPR_CONST size_t MaximumQueuedEntries = MaximumEntries * 64;
+
+} // namespace
+
+namespace sunfish {
+
+TTShare::TTShare(TT& tt) :
+    tt_(tt),
+    depth_(DefaultDepth * Searcher::Depth1Ply),
+    running_(false),
+    sent_(0),
+    received_(0),
+    imported_(0) {
+}
+
+TTShare::~TTShare() {
+  stop();
+}
+
+bool TTShare::open(int port) {
+  return socket_.open(port);
+}
+
+bool TTShare::addPeer(const std::string& host, int port) {
+  UdpSocket::Address address;
+  if (!UdpSocket::resolve(host, port, address)) {
+    return false;
+  }
+  peers_.push_back(address);
+  return true;
+}
+
+bool TTShare::addPeers(const std::string& peers) {
+  for (const auto& peer : StringUtil::split(peers, ',')) {
+    auto hostPort = StringUtil::splitOnce(StringUtil::trim(peer), ':');
+    int port = StringUtil::toInt(hostPort.second, 0);
+    if (hostPort.first.empty() || port <= 0) {
+      LOG(error) << "invalid peer: " << peer;
+      return false;
+    }
+    if (!addPeer(hostPort.first, port)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TTShare::setDepth(int depth) {
+  depth_ = depth * Searcher::Depth1Ply;
+}
+
+void TTShare::start() {
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread([this]() {
+    run();
+  });
+}
+
+void TTShare::stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  thread_.join();
+}
+
+void TTShare::push(Zobrist::Type hash, const TTElement& element) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.size() < MaximumQueuedEntries) {
+    entries_.push_back({ hash, element });
+  }
+}
+
+TTShare::Stats TTShare::getStats() const {
+  return { sent_.load(), received_.load(), imported_.load() };
+}
+
+void TTShare::run() {
+  auto nextSend = std::chrono::steady_clock::now();
+
+  while (running_) {
+    receive();
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= nextSend) {
+      send();
+      nextSend = now + std::chrono::milliseconds(SendIntervalMs);
+    }
+  }
+}
+
+void TTShare::send() {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+  }
+
+  if (entries.empty() || peers_.empty()) {
+    return;
+  }
+
+  uint8_t datagram[MaximumDatagramSize];
+  for (size_t begin = 0; begin < entries.size(); begin += MaximumEntries) {
+    uint16_t count = static_cast<uint16_t>(std::min(entries.size() - begin, MaximumEntries));
+    uint16_t reserved = 0;
+    memcpy(datagram, &Magic, sizeof(Magic));
+    memcpy(datagram + 4, &count, sizeof(count));
+    memcpy(datagram + 6, &reserved, sizeof(reserved));
+
+    uint8_t* p = datagram + HeaderSize;
+    for (size_t i = begin; i < begin + count; i++) {
+      memcpy(p, &entries[i].hash, sizeof(Zobrist::Type));
+      memcpy(p + sizeof(Zobrist::Type), &entries[i].element, sizeof(TTElement));
+      p += EntrySize;
+    }
+
+    size_t size = HeaderSize + EntrySize * count;
+    for (const auto& peer : peers_) {
+      socket_.sendTo(peer, datagram, size);
+    }
+    sent_ += count;
+  }
+}
+
+void TTShare::receive() {
+  uint8_t datagram[MaximumDatagramSize];
+  UdpSocket::Address source;
+  int size = socket_.receive(datagram, sizeof(datagram), SendIntervalMs, source);
+  if (size < static_cast<int>(HeaderSize)) {
+    return;
+  }
+
+  // the entries are imported only from the peers.
+  auto peer = std::find_if(peers_.begin(), peers_.end(), [&source](const UdpSocket::Address& address) {
+    return address.ip == source.ip && address.port == source.port;
+  });
+  if (peer == peers_.end()) {
+    return;
+  }
+
+  uint32_t magic;
+  uint16_t count;
+  memcpy(&magic, datagram, sizeof(magic));
+  memcpy(&count, datagram + 4, sizeof(count));
+  if (magic != Magic ||
+      count > MaximumEntries ||
+      static_cast<size_t>(size) != HeaderSize + EntrySize * count) {
+    LOG(warning) << "an invalid datagram is received";
+    return;
+  }
+
+  const uint8_t* p = datagram + HeaderSize;
+  for (uint16_t i = 0; i < count; i++) {
+    Zobrist::Type hash;
+    TTElement element;
+    memcpy(&hash, p, sizeof(Zobrist::Type));
+    memcpy(&element, p + sizeof(Zobrist::Type), sizeof(TTElement));
+    p += EntrySize;
+
+    if (tt_.import(hash, element) != TTStatus::Reject) {
+      imported_++;
+    }
+  }
+  received_ += count;
+}
+
+} // namespace sunfish
@@ -0,0 +1,129 @@
+/* TTShare.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_CLUSTER_TTSHARE_HPP__
+#define SUNFISH_SEARCH_CLUSTER_TTSHARE_HPP__
+
+#include "common/network/UdpSocket.hpp"
+#include "search/tt/TTElement.hpp"
+#include "core/position/Zobrist.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+class TT;
+
+/**
+ * TTShare exchanges the deep entries of TT between the processes
+ * of a cluster over UDP, so that they search like the threads of lazy SMP.
+ *
+ * A datagram is a header followed by entries:
+ *   uint32_t magic, uint16_t the number of entries, uint16_t reserved
+ *   uint64_t hash, TTElement (12 bytes) for each entry
+ * All processes must have the same byte order.
+ * A lost datagram only makes the search a little slower.
+ * The datagrams from the addresses other than the peers are dropped.
+ */
+class TTShare {
+public:
+
+  /** the minimum depth of the entries sent to the peers */
+  static CONSTEXPR_CONST int DefaultDepth = 6;
+
+  struct Stats {
+    uint64_t sent;
+    uint64_t received;
+    uint64_t imported;
+  };
+
+  TTShare(TT& tt);
+  TTShare(const TTShare&) = delete;
+  TTShare(TTShare&&) = delete;
+
+  ~TTShare();
+
+  /**
+   * Open the UDP port. (0: a free port is assigned)
+   */
+  bool open(int port);
+
+  int getPort() const {
+    return socket_.getPort();
+  }
+
+  bool addPeer(const std::string& host, int port);
+
+  /**
+   * Add the peers in `HOST:PORT,HOST:PORT,...' format.
+   */
+  bool addPeers(const std::string& peers);
+
+  /**
+   * @param depth the minimum depth in plies
+   */
+  void setDepth(int depth);
+
+  /**
+   * the minimum depth of the entries sent to the peers. (Searcher::Depth1Ply units)
+   */
+  int getDepth() const {
+    return depth_;
+  }
+
+  /**
+   * Start the thread which sends and receives the entries.
+   */
+  void start();
+
+  void stop();
+
+  /**
+   * Queue an entry to be sent to the peers.
+   * This is called by the search threads.
+   */
+  void push(Zobrist::Type hash, const TTElement& element);
+
+  Stats getStats() const;
+
+private:
+
+  struct Entry {
+    Zobrist::Type hash;
+    TTElement element;
+  };
+
+  void run();
+
+  void send();
+
+  void receive();
+
+private:
+
+  TT& tt_;
+  UdpSocket socket_;
+  std::vector<UdpSocket::Address> peers_;
+  int depth_;
+
+  std::mutex mutex_;
+  std::vector<Entry> entries_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+
+  std::atomic<uint64_t> sent_;
+  std::atomic<uint64_t> received_;
+  std::atomic<uint64_t> imported_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_CLUSTER_TTSHARE_HPP__
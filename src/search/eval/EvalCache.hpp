@@ -14,7 +14,11 @@
 
 namespace sunfish {
 
-class EvalCacheElement {
+/**
+ * EvalCacheEntry packs a hash and a score into a single word,
+ * so that it is never torn when threads share the cache without locks.
+ */
+class EvalCacheEntry {
 public:
 
   using DataType = uint64_t;
@@ -22,7 +26,7 @@ public:
   static CONSTEXPR_CONST DataType HashMask  = 0xffffffffffff0000;
 
   // XXX
-  EvalCacheElement() : data_(0llu) {
+  EvalCacheEntry() : data_(0llu) {
   }
 
   void set(Zobrist::Type hash,
@@ -30,11 +34,11 @@ public:
     data_ = (hash & HashMask) | static_cast<uint16_t>(score.raw());
   }
 
-  bool check(Zobrist::Type hash) {
+  bool check(Zobrist::Type hash) const {
     return ((data_ ^ hash) & HashMask) == 0llu;
   }
 
-  Score score() {
+  Score score() const {
     uint16_t u16score = static_cast<uint16_t>(data_);
     return Score(static_cast<int16_t>(u16score));
   }
@@ -45,24 +49,67 @@ private:
 
 };
 
-class EvalCache : public HashTable<EvalCacheElement> {
+/**
+ * EvalCacheElement is a bucket of the entries which share an index.
+ * The newest entry is stored in the first way and the oldest is dropped.
+ */
+class EvalCacheElement {
 public:
 
-  void entry(Zobrist::Type hash, const Score& score) {
-    auto e = getElement(hash);
-    e.set(hash, score);
-    getElement(hash) = e;
+  static CONSTEXPR_CONST int Ways = 4;
+
+  void set(Zobrist::Type hash,
+           const Score& score) {
+    EvalCacheEntry entry;
+    entry.set(hash, score);
+
+    int i = 0;
+    for (; i < Ways - 1; i++) {
+      if (ways_[i].check(hash)) {
+        break;
+      }
+    }
+    for (; i > 0; i--) {
+      ways_[i] = ways_[i - 1];
+    }
+    ways_[0] = entry;
   }
 
-  bool check(Zobrist::Type hash, Score& score) {
-    auto e = getElement(hash);
-    if (e.check(hash)) {
-      score = e.score();
-      return true;
+  bool check(Zobrist::Type hash, Score& score) const {
+    for (int i = 0; i < Ways; i++) {
+      EvalCacheEntry entry = ways_[i];
+      if (entry.check(hash)) {
+        score = entry.score();
+        return true;
+      }
     }
     return false;
   }
 
+private:
+
+  EvalCacheEntry ways_[Ways];
+
+};
+
+class EvalCache : public HashTable<EvalCacheElement> {
+public:
+
+  /** 2 MiB */
+  static CONSTEXPR_CONST unsigned DefaultWidth = 16;
+
+  EvalCache(unsigned width = DefaultWidth) :
+      HashTable<EvalCacheElement>(width) {
+  }
+
+  void entry(Zobrist::Type hash, const Score& score) {
+    getElement(hash).set(hash, score);
+  }
+
+  bool check(Zobrist::Type hash, Score& score) const {
+    return getElement(hash).check(hash, score);
+  }
+
 };
 
 } // namespace sunfish
@@ -156,16 +156,26 @@ Score Evaluator::calculatePositionalScore(const Position& position) {
 }
 
 Score Evaluator::calculateTotalScore(Score materialScore,
-                                     const Position& position) {
+                                     const Position& position,
+                                     bool* cacheHit /*= nullptr*/,
+                                     EvalCache* cache /*= nullptr*/) {
+  if (cache == nullptr) {
+    cache = &cache_;
+  }
+
   Score score;
-  if (cache_.check(position.getHash(), score)) {
+  bool hit = cache->check(position.getHash(), score);
+  if (cacheHit != nullptr) {
+    *cacheHit = hit;
+  }
+  if (hit) {
     return score;
   }
 
   auto positionalScore = calculatePositionalScore(position);
   score = materialScore + positionalScore;
 
-  cache_.entry(position.getHash(), score);
+  cache->entry(position.getHash(), score);
 
   return score;
 }
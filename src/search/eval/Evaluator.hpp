@@ -56,8 +56,14 @@ public:
 
   Score calculatePositionalScore(const Position& position);
 
+  /**
+   * @param cacheHit if not null, whether the score was found in the cache is stored.
+   * @param cache if not null, it is used instead of the shared cache.
+   */
   Score calculateTotalScore(Score materialScore,
-                            const Position& position);
+                            const Position& position,
+                            bool* cacheHit = nullptr,
+                            EvalCache* cache = nullptr);
 
   Score estimateScore(Score score,
                       const Position& position,
@@ -73,6 +79,18 @@ public:
     return dataSourceType_;
   }
 
+  /**
+   * resize the shared cache.
+   * this must not be called while searching.
+   */
+  void resizeCacheMB(unsigned mebiBytes) {
+    cache_.resizeMB(mebiBytes);
+  }
+
+  EvalCache& cache() {
+    return cache_;
+  }
+
 private:
 
   EvalCache cache_;
@@ -98,6 +98,74 @@ private:
   }
 };
 
+/**
+ * ContinuationHistory is indexed by the piece type and the destination
+ * of a previous move together with those of the current move.
+ * The same table is used for the move of 1 ply before and 2 plies before.
+ */
+class ContinuationHistory : public History<Square::N * PieceNumber::TypeNum
+                                         * Square::N * PieceNumber::TypeNum * 2> {
+public:
+
+  void update(Turn turn, PieceType prevPieceType, Square prevTo,
+              PieceType pieceType, Square to, HistoryValue value) {
+    updateByIndex(index(turn, prevPieceType, prevTo, pieceType, to), value);
+  }
+
+  HistoryValue get(Turn turn, PieceType prevPieceType, Square prevTo,
+                   PieceType pieceType, Square to) const {
+    return getByIndex(index(turn, prevPieceType, prevTo, pieceType, to));
+  }
+
+private:
+
+  static int index(Turn turn, PieceType prevPieceType, Square prevTo,
+                   PieceType pieceType, Square to) {
+    return ((prevPieceType.raw() * Square::N + prevTo.raw())
+          * PieceNumber::TypeNum + pieceType.raw()) * Square::N + to.raw()
+         + (turn == Turn::Black ? 0 : Square::N * PieceNumber::TypeNum
+                                    * Square::N * PieceNumber::TypeNum);
+  }
+};
+
+/**
+ * CounterMove holds the quiet move which refuted
+ * each previous move identified by its piece type and destination.
+ */
+class CounterMove {
+public:
+
+  CounterMove() {
+    clear();
+  }
+
+  void clear() {
+    for (int i = 0; i < Size; i++) {
+      moves_[i] = Move::none();
+    }
+  }
+
+  void set(Turn turn, PieceType prevPieceType, Square prevTo, Move move) {
+    moves_[index(turn, prevPieceType, prevTo)] = move.excludeExtData();
+  }
+
+  Move get(Turn turn, PieceType prevPieceType, Square prevTo) const {
+    return moves_[index(turn, prevPieceType, prevTo)];
+  }
+
+private:
+
+  static CONSTEXPR_CONST int Size = Square::N * PieceNumber::TypeNum * 2;
+
+  static int index(Turn turn, PieceType prevPieceType, Square prevTo) {
+    return prevPieceType.raw() * Square::N + prevTo.raw()
+         + (turn == Turn::Black ? 0 : Square::N * PieceNumber::TypeNum);
+  }
+
+  Move moves_[Size];
+
+};
+
 } // namespace sunfish
 
 #endif // SUNFISH_SEARCH_HISTORY_HISTORY_HPP__
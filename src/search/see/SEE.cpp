@@ -12,18 +12,25 @@ namespace sunfish {
 
 Score SEE::calculate(const Position& position,
                      Move move) {
-  Square from;
+  return calculate(position, move, extractAggressors(position, move.to()));
+}
+
+Score SEE::calculate(const Position& position,
+                     Move move,
+                     const Bitboard& aggressors,
+                     Score alpha,
+                     Score beta) {
   Square to = move.to();
   Piece piece;
   Piece captured = position.getPieceOnBoard(to);
   Score score = Score::zero();
+  Bitboard bb = aggressors;
 
   if (move.isDrop()) {
-    from = Square::invalid();
     piece = move.droppingPieceType().black();
 
   } else {
-    from = move.from();
+    Square from = move.from();
     piece = position.getPieceOnBoard(from);
     ASSERT(!piece.isEmpty());
     ASSERT(position.getTurn() == Turn::Black ? piece.isBlack() : piece.isWhite());
@@ -37,62 +44,69 @@ Score SEE::calculate(const Position& position,
     if (!captured.isEmpty()) {
       score += material::exchangeScore(captured);
     }
-  }
 
-  auto bb = extractAggressors(position, from, to);
+    bb.unset(from);
+    bb = extractShadowAggressor(position, bb, from, to);
+  }
 
   if (position.getTurn() == Turn::Black) {
-    return search(position, bb, to, score, material::exchangeScore(piece));
+    return search(position, bb, to, score, material::exchangeScore(piece), alpha, beta);
   } else {
-    return -search(position, bb, to, -score, material::exchangeScore(piece));
+    return -search(position, bb, to, -score, material::exchangeScore(piece), -beta, -alpha);
   }
 }
 
 Bitboard SEE::extractAggressors(const Position& position,
-                                Square from,
                                 Square to) {
   Bitboard occ = position.getBOccupiedBitboard() | position.getWOccupiedBitboard();
-  RotatedBitboard occ90 = position.get90RotatedBitboard();
-  RotatedBitboard occR45 = position.getRight45RotatedBitboard();
-  RotatedBitboard occL45 = position.getLeft45RotatedBitboard();
-
-  if (from.isValid()) {
-    occ.unset(from);
-    occ90.unset(from.rotate90());
-    occR45.unset(from.rotateRight45());
-    occL45.unset(from.rotateLeft45());
-  }
 
   Bitboard bb = Bitboard::zero();
   bb |= (Bitboard::mask(to).down()) & position.getBPawnBitboard();
   bb |= (Bitboard::mask(to).up()) & position.getWPawnBitboard();
-  bb |= MoveTables::whiteLance(occ, to) & position.getBLanceBitboard();
-  bb |= MoveTables::blackLance(occ, to) & position.getWLanceBitboard();
   bb |= MoveTables::whiteKnight(to) & position.getBKnightBitboard();
   bb |= MoveTables::blackKnight(to) & position.getWKnightBitboard();
   bb |= MoveTables::whiteSilver(to) & position.getBSilverBitboard();
   bb |= MoveTables::blackSilver(to) & position.getWSilverBitboard();
   bb |= MoveTables::whiteGold(to) & position.getBGoldBitboard();
   bb |= MoveTables::blackGold(to) & position.getWGoldBitboard();
-  bb |= (MoveTables::ver(occ, to) |
-         MoveTables::hor(occ90, to)) &
-        (position.getBRookBitboard() |
-         position.getBDragonBitboard() |
-         position.getWRookBitboard() |
-         position.getWDragonBitboard());
-  bb |= (MoveTables::diagR45(occR45, to) |
-         MoveTables::diagL45(occL45, to)) &
-        (position.getBBishopBitboard() |
-         position.getBHorseBitboard() |
-         position.getWBishopBitboard() |
-         position.getWHorseBitboard());
+
+  // no need to scan the lines if no long effects reach the square.
+  bool hasLongEffects = !position.isEffectBoardEnabled() ||
+                        position.getEffectBoard().getLongEffects(Turn::Black, to) != 0 ||
+                        position.getEffectBoard().getLongEffects(Turn::White, to) != 0;
+  if (hasLongEffects) {
+    bb |= MoveTables::whiteLance(occ, to) & position.getBLanceBitboard();
+    bb |= MoveTables::blackLance(occ, to) & position.getWLanceBitboard();
+    bb |= (MoveTables::ver(occ, to) |
+           MoveTables::hor(position.get90RotatedBitboard(), to)) &
+          (position.getBRookBitboard() |
+           position.getBDragonBitboard() |
+           position.getWRookBitboard() |
+           position.getWDragonBitboard());
+    bb |= (MoveTables::diagR45(position.getRight45RotatedBitboard(), to) |
+           MoveTables::diagL45(position.getLeft45RotatedBitboard(), to)) &
+          (position.getBBishopBitboard() |
+           position.getBHorseBitboard() |
+           position.getWBishopBitboard() |
+           position.getWHorseBitboard());
+  }
+
   Bitboard king = position.getBDragonBitboard() | position.getWDragonBitboard();
   king.set(position.getBlackKingSquare());
   king.set(position.getWhiteKingSquare());
   bb |= MoveTables::king(to) & king;
 
+  return bb;
+}
+
+Bitboard SEE::extractAggressors(const Position& position,
+                                Square from,
+                                Square to) {
+  Bitboard bb = extractAggressors(position, to);
+
   if (from.isValid()) {
     bb.unset(from);
+    bb = extractShadowAggressor(position, bb, from, to);
   }
 
   return bb;
@@ -150,10 +164,10 @@ Score SEE::search(const Position& position,
                   Bitboard bb,
                   Square to,
                   Score score,
-                  Score materialScore) {
+                  Score materialScore,
+                  Score alpha,
+                  Score beta) {
   Turn turn = position.getTurn() == Turn::Black ? Turn::White : Turn::Black;
-  Score alpha = -Score::infinity();
-  Score beta = Score::infinity();
   for (;;) {
     if (turn == Turn::Black) {
       alpha = std::max(alpha, score);
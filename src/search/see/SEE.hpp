@@ -30,6 +30,44 @@ public:
   static Score calculate(const Position& position,
                          Move move);
 
+  /**
+   * Calculate with the aggressors to move.to() which are
+   * extracted by extractAggressors(position, move.to()).
+   */
+  static Score calculate(const Position& position,
+                         Move move,
+                         const Bitboard& aggressors) {
+    return calculate(position, move, aggressors,
+                     -Score::infinity(), Score::infinity());
+  }
+
+  /**
+   * Check whether the SEE value is greater than or equal to the threshold.
+   * This is faster than comparing a value of calculate(),
+   * because the exchange is cut off as soon as the result is decided.
+   */
+  static bool isGreaterOrEqual(const Position& position,
+                               Move move,
+                               Score threshold) {
+    return isGreaterOrEqual(position, move,
+                            extractAggressors(position, move.to()),
+                            threshold);
+  }
+
+  static bool isGreaterOrEqual(const Position& position,
+                               Move move,
+                               const Bitboard& aggressors,
+                               Score threshold) {
+    return calculate(position, move, aggressors,
+                     threshold - 1, threshold) >= threshold;
+  }
+
+  /**
+   * Extract all pieces which can move to the specified square.
+   */
+  static Bitboard extractAggressors(const Position& position,
+                                    Square to);
+
   static Bitboard extractAggressors(const Position& position,
                                     Square from,
                                     Square to);
@@ -41,11 +79,19 @@ public:
 
 private:
 
+  static Score calculate(const Position& position,
+                         Move move,
+                         const Bitboard& aggressors,
+                         Score alpha,
+                         Score beta);
+
   static Score search(const Position& position,
                       Bitboard bb,
                       Square to,
                       Score score,
-                      Score materialScore);
+                      Score materialScore,
+                      Score alpha,
+                      Score beta);
 
   template <Turn turn>
   static Aggressor pickAggressor(const Position& position,
@@ -54,6 +100,54 @@ private:
 
 };
 
+/**
+ * A cache of aggressor bitboards for the destination squares.
+ * It is valid only while the position is unchanged.
+ * A node looks up only a few squares, so the entries are filled lazily
+ * and the oldest one is replaced when it is full.
+ */
+class SEECache {
+public:
+
+  static CONSTEXPR_CONST int Size = 8;
+
+  void clear() {
+    size_ = 0;
+  }
+
+  const Bitboard& getAggressors(const Position& position, Square to) {
+    for (int i = 0; i < size_; i++) {
+      if (squares_[i] == to.raw()) {
+        return aggressors_[i];
+      }
+    }
+
+    int i = size_ < Size ? size_++ : next_++ % Size;
+    squares_[i] = static_cast<int8_t>(to.raw());
+    aggressors_[i] = SEE::extractAggressors(position, to);
+    return aggressors_[i];
+  }
+
+  Score calculate(const Position& position, Move move) {
+    return SEE::calculate(position, move,
+                          getAggressors(position, move.to()));
+  }
+
+  bool isGreaterOrEqual(const Position& position, Move move, Score threshold) {
+    return SEE::isGreaterOrEqual(position, move,
+                                 getAggressors(position, move.to()),
+                                 threshold);
+  }
+
+private:
+
+  Bitboard aggressors_[Size];
+  int8_t squares_[Size];
+  uint8_t size_ = 0;
+  uint8_t next_ = 0;
+
+};
+
 } // namespace sunfish
 
 #endif // SUNFISH_SEARCH_SEE_SEE_HPP__
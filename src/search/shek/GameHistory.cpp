@@ -0,0 +1,82 @@
+/* GameHistory.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/shek/GameHistory.hpp"
+#include "core/record/Record.hpp"
+#include "logger/Logger.hpp"
+
+namespace sunfish {
+
+GameHistory::GameHistory() {
+  initialPosition_.initialize(Position::Handicap::Even);
+  position_ = initialPosition_;
+}
+
+void GameHistory::reset(const Position& initialPosition) {
+  // releasing each move is cheaper than clearing the whole table.
+  while (!entries_.empty()) {
+    pop();
+  }
+
+  initialPosition_ = initialPosition;
+  position_ = initialPosition;
+}
+
+bool GameHistory::append(const Move& move) {
+  Entry entry;
+  entry.move = move;
+  entry.hash = position_.getHash();
+  entry.check = position_.inCheck();
+
+  shekTable_.retain(position_, false);
+
+  if (!position_.doMove(entry.move, entry.captured)) {
+    shekTable_.release(position_);
+    LOG(error) << "illegal move: " << move.toString();
+    return false;
+  }
+
+  entries_.push_back(entry);
+
+  return true;
+}
+
+void GameHistory::pop() {
+  if (entries_.empty()) {
+    return;
+  }
+
+  const auto& entry = entries_.back();
+  position_.undoMove(entry.move, entry.captured);
+  shekTable_.release(position_);
+  entries_.pop_back();
+}
+
+bool GameHistory::sync(const Record& record) {
+  if (record.initialPosition.getHash() != initialPosition_.getHash()) {
+    reset(record.initialPosition);
+  }
+
+  size_t common = 0;
+  while (common < entries_.size() &&
+         common < record.moveList.size() &&
+         entries_[common].move == record.moveList[common]) {
+    common++;
+  }
+
+  while (entries_.size() > common) {
+    pop();
+  }
+
+  for (size_t i = common; i < record.moveList.size(); i++) {
+    if (!append(record.moveList[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace sunfish
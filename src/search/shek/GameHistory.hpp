@@ -0,0 +1,84 @@
+/* GameHistory.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_SHEK_GAMEHISTORY_HPP__
+#define SUNFISH_SEARCH_SHEK_GAMEHISTORY_HPP__
+
+#include "search/shek/ShekTable.hpp"
+#include "core/position/Position.hpp"
+#include "core/move/Move.hpp"
+#include <vector>
+
+namespace sunfish {
+
+struct Record;
+
+/**
+ * GameHistory holds the positions before each move of a game
+ * for SHEK and the successive checks repetition detector.
+ * It is extended one move at a time, and is shared by all search
+ * threads without locks, so it must not be changed while searching.
+ */
+class GameHistory {
+public:
+
+  struct Entry {
+    Move move;
+    Piece captured;
+    Zobrist::Type hash;
+    bool check;
+  };
+
+  GameHistory();
+  GameHistory(const GameHistory&) = delete;
+  GameHistory(GameHistory&&) = delete;
+
+  void reset(const Position& initialPosition);
+
+  bool append(const Move& move);
+
+  void pop();
+
+  /**
+   * make the history same as the record.
+   * only the moves which differ from the history are undone or appended.
+   */
+  bool sync(const Record& record);
+
+  const Position& getPosition() const {
+    return position_;
+  }
+
+  /**
+   * the number of moves.
+   */
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /**
+   * the entry of the specified move.
+   * entries_[size()-1] is the last move.
+   */
+  const Entry& getEntry(size_t index) const {
+    return entries_[index];
+  }
+
+  const ShekTable& getShekTable() const {
+    return shekTable_;
+  }
+
+private:
+
+  Position initialPosition_;
+  Position position_;
+  std::vector<Entry> entries_;
+  ShekTable shekTable_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_SHEK_GAMEHISTORY_HPP__
@@ -5,6 +5,7 @@
 
 #include "search/shek/SCRDetector.hpp"
 #include "search/tree/Tree.hpp"
+#include "search/shek/GameHistory.hpp"
 #include "common/string/StringUtil.hpp"
 #include "core/record/Record.hpp"
 #include "core/position/Position.hpp"
@@ -38,6 +39,20 @@ void SCRDetector::registerRecord(const Record& record) {
   length_ = std::min(recordLength, static_cast<size_t>(MaxLength));
 }
 
+void SCRDetector::registerHistory(const GameHistory& history) {
+  auto historyLength = history.size();
+
+  // static_cast is required on Clang.
+  // See https://trello.com/c/iJqg1GqN
+  length_ = std::min(historyLength, static_cast<size_t>(MaxLength));
+
+  for (size_t i = 0; i < length_; i++) {
+    const auto& entry = history.getEntry(historyLength - i - 1);
+    list_[i].hash = entry.hash;
+    list_[i].check = entry.check;
+  }
+}
+
 SCRState SCRDetector::detectShort(const Tree& tree) const {
   bool isCurrentPlayerTurn = false;
   bool currentPlayerChecking = true;
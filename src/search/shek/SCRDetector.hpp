@@ -14,6 +14,7 @@ namespace sunfish {
 
 struct Record;
 struct Tree;
+class GameHistory;
 
 enum class SCRState {
   None,
@@ -43,6 +44,12 @@ public:
 
   void registerRecord(const Record& record);
 
+  /**
+   * copy the last moves of the history.
+   * unlike registerRecord, this does not replay the game.
+   */
+  void registerHistory(const GameHistory& history);
+
   SCRState detectShort(const Tree& tree) const;
 
   SCRState detect(const Tree& tree) const;
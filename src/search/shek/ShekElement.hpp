@@ -92,12 +92,12 @@ public:
     return handSet_;
   }
 
-private:
-
   DataType count() const {
     return data_ & CountMask;
   }
 
+private:
+
   bool searched() const {
     return (data_ & Searched) != 0LU;
   }
@@ -28,6 +28,15 @@ public:
     return nullptr;
   }
 
+  const ShekElement* findSlot(Zobrist::Type hash) const {
+    for (SizeType i = 0; i < Size; i++) {
+      if (slots_[i].checkHash(hash)) {
+        return &slots_[i];
+      }
+    }
+    return nullptr;
+  }
+
   ShekElement* findSlot(Zobrist::Type hash, const HandSet& handSet) {
     for (SizeType i = 0; i < Size; i++) {
       if (slots_[i].checkHash(hash) && slots_[i].handSet() == handSet) {
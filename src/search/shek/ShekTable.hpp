@@ -19,19 +19,41 @@ public:
 
   static_assert(1LLU << Width > ~ShekElement::HashMask, "invalid hash table size");
 
-  ShekTable() : HashTable<ShekSlots>(Width) {}
+  ShekTable() : HashTable<ShekSlots>(Width), retained_(0) {}
   ShekTable(const ShekTable&) = delete;
   ShekTable(ShekTable&&) = delete;
 
-  ShekState check(const Position& position) {
+  void clear() {
+    HashTable<ShekSlots>::clear();
+    retained_ = 0;
+  }
+
+  /**
+   * returns true if all of the retained positions are released.
+   */
+  bool isEmpty() const {
+    return retained_ == 0;
+  }
+
+  ShekState check(const Position& position) const {
+    ShekElement::DataType count;
+    return check(position, count);
+  }
+
+  /**
+   * 'count' receives the number of times the compared position is retained.
+   */
+  ShekState check(const Position& position, ShekElement::DataType& count) const {
     auto hash = position.getBoardHash();
-    auto& slots = getElement(hash);
+    const auto& slots = getElement(hash);
     auto element = slots.findSlot(hash);
     if (element == nullptr) {
+      count = 0;
       return ShekState::None;
     }
 
     HandSet handSet(position.getBlackHand());
+    count = element->count();
     return element->check(handSet,
                           position.getTurn());
   }
@@ -44,6 +66,7 @@ public:
     auto element = slots.findSlot(hash, handSet);
     if (element != nullptr) {
       element->retain(inSearchNode);
+      retained_++;
       return;
     }
 
@@ -53,6 +76,7 @@ public:
                             handSet,
                             position.getTurn(),
                             inSearchNode);
+      retained_++;
     }
   }
 
@@ -64,9 +88,14 @@ public:
     auto element = slots.findSlot(hash, handSet);
     if (element != nullptr) {
       element->release();
+      retained_--;
     }
   }
 
+private:
+
+  uint64_t retained_;
+
 };
 
 } // namespace sunfish
@@ -0,0 +1,117 @@
+/* Tracer.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/trace/Tracer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+using namespace sunfish;
+
+void writeString(std::ostream& os, const char* str) {
+  os << '"';
+  for (; *str != '\0'; str++) {
+    if (*str == '"' || *str == '\\') {
+      os << '\\';
+    }
+    os << *str;
+  }
+  os << '"';
+}
+
+} // namespace
+
+namespace sunfish {
+
+void Tracer::enable(size_t capacity) {
+  if (!enabled_) {
+    base_ = Clock::now();
+  }
+  capacity_ = std::max(capacity, static_cast<size_t>(1));
+  rings_.clear();
+  enabled_ = true;
+  prepare(1);
+}
+
+void Tracer::prepare(int numberOfThreads) {
+  if (!enabled_) {
+    return;
+  }
+
+  // the buffers of previous searches are kept.
+  while (static_cast<int>(rings_.size()) < numberOfThreads) {
+    rings_.emplace_back();
+    rings_.back().events.resize(capacity_);
+    rings_.back().count = 0;
+  }
+}
+
+void Tracer::record(int index, char phase, const char* name, const char* argName, int64_t arg, const char* text) {
+  if (!enabled_ || index >= static_cast<int>(rings_.size())) {
+    return;
+  }
+
+  auto& ring = rings_[index];
+  auto& e = ring.events[ring.count % capacity_];
+  auto elapsed = Clock::now() - base_;
+  e.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  e.name = name;
+  e.argName = argName;
+  e.arg = arg;
+  e.phase = phase;
+  if (text != nullptr) {
+    strncpy(e.text, text, TraceEvent::TextSize - 1);
+    e.text[TraceEvent::TextSize - 1] = '\0';
+  } else {
+    e.text[0] = '\0';
+  }
+  ring.count++;
+}
+
+void Tracer::writeChromeTrace(std::ostream& os) const {
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  bool first = true;
+  for (size_t ti = 0; ti < rings_.size(); ti++) {
+    const auto& ring = rings_[ti];
+
+    os << (first ? "" : ",\n");
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << ti
+       << ",\"args\":{\"name\":\"" << (ti == 0 ? "main" : "helper") << ' ' << ti << "\"}}";
+    first = false;
+
+    uint64_t begin = ring.count > capacity_ ? ring.count - capacity_ : 0;
+    for (uint64_t i = begin; i < ring.count; i++) {
+      const auto& e = ring.events[i % capacity_];
+      os << ",\n{\"name\":";
+      writeString(os, e.name);
+      os << ",\"ph\":\"" << e.phase << "\""
+         << ",\"ts\":" << e.timestamp
+         << ",\"pid\":0"
+         << ",\"tid\":" << ti;
+      if (e.phase == 'i') {
+        os << ",\"s\":\"t\"";
+      }
+      if (e.argName != nullptr || e.text[0] != '\0') {
+        os << ",\"args\":{";
+        if (e.argName != nullptr) {
+          writeString(os, e.argName);
+          os << ':' << e.arg;
+        }
+        if (e.text[0] != '\0') {
+          os << (e.argName != nullptr ? "," : "") << "\"text\":";
+          writeString(os, e.text);
+        }
+        os << '}';
+      }
+      os << '}';
+    }
+  }
+
+  os << "\n]}\n";
+}
+
+} // namespace sunfish
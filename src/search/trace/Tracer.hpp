@@ -0,0 +1,94 @@
+/* Tracer.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_TRACE_TRACER_HPP__
+#define SUNFISH_SEARCH_TRACE_TRACER_HPP__
+
+#include "common/Def.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+struct TraceEvent {
+  static CONSTEXPR_CONST int TextSize = 16;
+
+  /** micro seconds from the start of tracing */
+  uint64_t timestamp;
+  /** a string literal */
+  const char* name;
+  /** a string literal or nullptr */
+  const char* argName;
+  int64_t arg;
+  char phase;
+  char text[TextSize];
+};
+
+/**
+ * Tracer records timestamped events into a ring buffer for each
+ * search thread, and exports them as a Chrome trace JSON.
+ * Each ring buffer must be written only by the thread of Tree::index.
+ */
+class Tracer {
+public:
+
+  static CONSTEXPR_CONST size_t DefaultCapacity = 16 * 1024;
+
+  Tracer() : enabled_(false), capacity_(DefaultCapacity) {
+  }
+
+  void enable(size_t capacity = DefaultCapacity);
+
+  void disable() {
+    enabled_ = false;
+  }
+
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  /**
+   * prepare ring buffers for the specified number of threads.
+   * this must not be called while searching.
+   */
+  void prepare(int numberOfThreads);
+
+  void begin(int index, const char* name, const char* argName = nullptr, int64_t arg = 0) {
+    record(index, 'B', name, argName, arg, nullptr);
+  }
+
+  void end(int index, const char* name) {
+    record(index, 'E', name, nullptr, 0, nullptr);
+  }
+
+  void instant(int index, const char* name, const char* argName = nullptr, int64_t arg = 0, const char* text = nullptr) {
+    record(index, 'i', name, argName, arg, text);
+  }
+
+  void writeChromeTrace(std::ostream& os) const;
+
+private:
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Ring {
+    std::vector<TraceEvent> events;
+    uint64_t count;
+  };
+
+  void record(int index, char phase, const char* name, const char* argName, int64_t arg, const char* text);
+
+  bool enabled_;
+  size_t capacity_;
+  Clock::time_point base_;
+  std::vector<Ring> rings_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_TRACE_TRACER_HPP__
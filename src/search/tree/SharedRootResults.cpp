@@ -0,0 +1,122 @@
+/* SharedRootResults.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "search/tree/SharedRootResults.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+
+namespace {
+
+using namespace sunfish;
+
+uint64_t packHeader(int depth, Score score, SharedRootResults::Bound bound) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(depth))
+       | static_cast<uint64_t>(static_cast<uint16_t>(score.raw())) << 32
+       | static_cast<uint64_t>(static_cast<uint8_t>(bound)) << 48;
+}
+
+int unpackDepth(uint64_t header) {
+  return static_cast<int32_t>(static_cast<uint32_t>(header));
+}
+
+} // namespace
+
+namespace sunfish {
+
+static_assert(std::is_trivially_copyable<PV>::value, "PV must be trivially copyable");
+
+SharedRootResults::SharedRootResults() :
+    slots_(new Slot[MAX_NUMBER_OF_MOVES]),
+    size_(0) {
+}
+
+void SharedRootResults::prepare(const MoveSlice& moves) {
+  // the slots are sorted for the binary search.
+  Move::RawType16 keys[MAX_NUMBER_OF_MOVES];
+  size_ = 0;
+  for (auto ite = moves.cbegin(); ite != moves.cend() && size_ < MAX_NUMBER_OF_MOVES; ite++) {
+    keys[size_++] = ite->excludeExtData().serialize16();
+  }
+  std::sort(keys, keys + size_);
+
+  for (int i = 0; i < size_; i++) {
+    slots_[i].move = keys[i];
+    slots_[i].sequence.store(0, std::memory_order_relaxed);
+  }
+}
+
+const SharedRootResults::Slot* SharedRootResults::find(Move move) const {
+  auto key = move.excludeExtData().serialize16();
+  auto end = slots_.get() + size_;
+  auto slot = std::lower_bound(slots_.get(), end, key, [](const Slot& lhs, Move::RawType16 rhs) {
+    return lhs.move < rhs;
+  });
+  return slot != end && slot->move == key ? slot : nullptr;
+}
+
+void SharedRootResults::store(Move move, int depth, Score score, Bound bound, const PV& pv) {
+  auto slot = find(move);
+  if (slot == nullptr) {
+    return;
+  }
+
+  // only this thread writes the slot.
+  uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+  if (sequence != 0 && unpackDepth(slot->header.load(std::memory_order_relaxed)) > depth) {
+    return;
+  }
+
+  uint64_t header = packHeader(depth, score, bound);
+  uint64_t words[PVWords] = {};
+  memcpy(words, &pv, sizeof(PV));
+
+  slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->header.store(header, std::memory_order_relaxed);
+  for (int i = 0; i < PVWords; i++) {
+    slot->pv[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool SharedRootResults::load(Move move, Result& result) const {
+  auto slot = find(move);
+  if (slot == nullptr) {
+    return false;
+  }
+
+  uint64_t header;
+  uint64_t words[PVWords];
+  for (;;) {
+    uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == 0) {
+      return false;
+    }
+    if (sequence & 1) {
+      continue;
+    }
+
+    header = slot->header.load(std::memory_order_relaxed);
+    for (int i = 0; i < PVWords; i++) {
+      words[i] = slot->pv[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->sequence.load(std::memory_order_relaxed) == sequence) {
+      break;
+    }
+  }
+
+  result.depth = unpackDepth(header);
+  result.score = Score(static_cast<Score::RawType>(static_cast<uint16_t>(header >> 32)));
+  result.bound = static_cast<Bound>(static_cast<uint8_t>(header >> 48));
+  memcpy(&result.pv, words, sizeof(PV));
+  return true;
+}
+
+} // namespace sunfish
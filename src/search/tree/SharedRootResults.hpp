@@ -0,0 +1,95 @@
+/* SharedRootResults.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_SEARCH_TREE_SHAREDROOTRESULTS_HPP__
+#define SUNFISH_SEARCH_TREE_SHAREDROOTRESULTS_HPP__
+
+#include "search/tree/PV.hpp"
+#include "search/eval/Score.hpp"
+#include "core/move/Moves.hpp"
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * SharedRootResults holds the latest results of the root moves
+ * searched by the helper threads in the parallel multi-PV search.
+ * Each root move is written by only one helper thread,
+ * and the main thread reads them without locks. (seqlock)
+ * The results are packed into words accessed with relaxed atomics,
+ * so a torn read is never a data race and is discarded by the sequence.
+ *
+ * This is not a top-K table. The main thread uses the result of a root
+ * move instead of searching the move, and a move outside the top K needs
+ * its (upper bound) result as much as a move inside it, to be proved
+ * worse than the K-th PV. So every root move has its own slot, found by
+ * a binary search, and the top K are consolidated in Tree::rootPVs.
+ */
+class SharedRootResults {
+public:
+
+  enum class Bound : uint8_t {
+    Exact,
+    Upper,
+    Lower,
+  };
+
+  struct Result {
+    int depth;
+    Score score;
+    Bound bound;
+    /** the PV after the root move */
+    PV pv;
+  };
+
+  SharedRootResults();
+  SharedRootResults(const SharedRootResults&) = delete;
+  SharedRootResults(SharedRootResults&&) = delete;
+
+  /**
+   * Clear the results and register the root moves.
+   * This must be called before the helper threads start.
+   */
+  void prepare(const MoveSlice& moves);
+
+  /**
+   * Store the result unless a deeper one is stored.
+   * This must be called by the owner of the root move.
+   */
+  void store(Move move, int depth, Score score, Bound bound, const PV& pv);
+
+  bool load(Move move, Result& result) const;
+
+private:
+
+  static CONSTEXPR_CONST int PVWords = (sizeof(PV) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  struct Slot {
+    Move::RawType16 move;
+    /** odd while the result is being written. (0: no result) */
+    std::atomic<uint32_t> sequence;
+    /** the depth, the score and the bound */
+    std::atomic<uint64_t> header;
+    std::atomic<uint64_t> pv[PVWords];
+  };
+
+  const Slot* find(Move move) const;
+
+  Slot* find(Move move) {
+    return const_cast<Slot*>(static_cast<const SharedRootResults*>(this)->find(move));
+  }
+
+private:
+
+  std::unique_ptr<Slot[]> slots_;
+  int size_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_SEARCH_TREE_SHAREDROOTRESULTS_HPP__
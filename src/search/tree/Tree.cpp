@@ -6,89 +6,97 @@
 #include "search/tree/Tree.hpp"
 #include "search/tt/TT.hpp"
 #include "search/eval/Evaluator.hpp"
-#include "core/record/Record.hpp"
 #include "logger/Logger.hpp"
 #include <sstream>
 
-namespace {
-
-using namespace sunfish;
-
-void initializeShekTable(ShekTable& shekTable,
-                         const Record* record) {
-  shekTable.clear();
+namespace sunfish {
 
-  if (record == nullptr) {
+void RootPVs::insert(Move move, int depth, const PV& pv, Score score) {
+  if (full() && score <= back().score) {
     return;
   }
 
-  Position pos = record->initialPosition;
-  for (auto& move : record->moveList) {
-    shekTable.retain(pos, false);
-
-    Piece captured;
-    if (!pos.doMove(move, captured)) {
-      LOG(error) << "illegal move: " << move.toString();
-      return;
-    }
-  }
-}
-
-} // namespace
-
-namespace sunfish {
-
-void insertRootPV(std::list<RootPV>& rootPVs, Move move, int depth, const PV& pv, Score score, int capacity) {
-  auto ite = rootPVs.begin();
-  for (; ite != rootPVs.end(); ite++) {
-    if (ite->score < score) {
-      break;
-    }
-  }
-  ite = rootPVs.insert(ite, RootPV{});
-  ite->pv.set(move, depth, pv);
-  ite->score = score;
-  if (rootPVs.size() > capacity) {
-    rootPVs.pop_back();
+  int i = full() ? size_ - 1 : size_++;
+  for (; i > 0 && pvs_[i-1].score < score; i--) {
+    pvs_[i] = pvs_[i-1];
   }
+  pvs_[i].pv.set(move, depth, pv);
+  pvs_[i].score = score;
 }
 
 void initializeTree(Tree& tree,
                     const Position& position,
                     Evaluator& eval,
-                    const Record* record) {
+                    const GameHistory* history) {
   tree.position = position;
   tree.ply = 0;
 
   initializeSearchInfo(tree.info);
+  tree.checkCount = 0;
 
   tree.nodes[0].materialScore = eval.calculateMaterialScore(tree.position);
   tree.nodes[0].score = Score::invalid();
   tree.nodes[0].killerMove1 = Move::none();
   tree.nodes[0].killerMove2 = Move::none();
   tree.nodes[0].excludedMove = Move::none();
+  tree.nodes[0].moves.reset(tree.moveStack);
 
   // SHEK
-  initializeShekTable(tree.shekTable, record);
+  // the search path is released on every undoMove,
+  // so the table is empty unless the previous search was broken.
+  tree.history = history;
+  if (!tree.shekTable.isEmpty()) {
+    tree.shekTable.clear();
+  }
 
   // successive checks repetition detector
-  if (record != nullptr) {
-    tree.scr.registerRecord(*record);
+  if (history != nullptr) {
+    tree.scr.registerHistory(*history);
   } else {
     tree.scr.clear();
   }
 }
 
+ShekState checkShek(const Tree& tree) {
+  ShekElement::DataType count;
+  ShekState state = tree.shekTable.check(tree.position, count);
+
+  if (tree.history == nullptr) {
+    return state;
+  }
+
+  ShekElement::DataType historyCount;
+  ShekState historyState = tree.history->getShekTable().check(tree.position, historyCount);
+
+  if (state == ShekState::None) {
+    return historyState;
+  }
+
+  // the same position is retained in both tables.
+  if ((historyState == ShekState::Equal || historyState == ShekState::Equal4) &&
+      (state == ShekState::Equal || state == ShekState::EqualS || state == ShekState::Equal4)) {
+    return count + historyCount >= 3 ? ShekState::Equal4 : state;
+  }
+
+  return state;
+}
+
 template <bool root>
 void visit(Tree& tree) {
   ASSERT(tree.ply <= Tree::StackSize - 2);
 
   Node& node = tree.nodes[tree.ply];
+  ColdNode& coldNode = tree.coldNodes[tree.ply];
   node.isHistorical = false;
   node.ttMove = Move::none();
-  node.quietsSearched.clear();
+  node.counterMove = Move::none();
+  coldNode.quietsSearched.clear();
   if (!root) {
-    node.pv.clear();
+    coldNode.pv.clear();
+
+    // The moves of this node are stacked on the moves of the parent node.
+    node.moves.reset(tree.ply != 0 ? tree.nodes[tree.ply-1].moves.end()
+                                   : tree.moveStack);
   }
 
   Node& childNode = tree.nodes[tree.ply+1];
@@ -104,10 +112,11 @@ void revisit(Tree& tree) {
   ASSERT(tree.ply <= Tree::StackSize - 2);
 
   Node& node = tree.nodes[tree.ply];
+  ColdNode& coldNode = tree.coldNodes[tree.ply];
   node.isHistorical = false;
-  node.quietsSearched.clear();
+  coldNode.quietsSearched.clear();
   if (!root) {
-    node.pv.clear();
+    coldNode.pv.clear();
   }
 
   Node& childNode = tree.nodes[tree.ply+1];
@@ -152,6 +161,30 @@ void addKiller(Tree& tree, Move move) {
   }
 }
 
+bool getPrevMove(const Tree& tree, int n, PieceType& pieceType, Square& to) {
+  ASSERT(n == 1 || n == 2);
+  if (tree.ply < n) {
+    return false;
+  }
+
+  auto& prevNode = tree.nodes[tree.ply - n];
+  if (prevNode.move.isNone()) {
+    return false;
+  }
+
+  to = prevNode.move.to();
+  if (n == 2) {
+    // the piece might have been captured by the next move.
+    auto& nextNode = tree.nodes[tree.ply - 1];
+    if (!nextNode.move.isNone() && nextNode.move.to() == to) {
+      pieceType = nextNode.captured.type();
+      return true;
+    }
+  }
+  pieceType = tree.position.getPieceOnBoard(to).type();
+  return true;
+}
+
 template <bool shek>
 bool doMove(Tree& tree, Move& move, Evaluator& eval, TT& tt) {
   auto& node = tree.nodes[tree.ply];
@@ -225,8 +258,15 @@ Score calculateStandPat(Tree& tree,
   auto& node = tree.nodes[tree.ply];
 
   if (node.score == Score::invalid()) {
+    bool cacheHit;
     node.score = eval.calculateTotalScore(node.materialScore,
-                                          tree.position);
+                                          tree.position,
+                                          &cacheHit,
+                                          tree.evalCache);
+    tree.info.evalCacheProbe++;
+    if (cacheHit) {
+      tree.info.evalCacheHit++;
+    }
   }
 
   if (tree.position.getTurn() == Turn::Black) {
@@ -11,13 +11,17 @@
 #include "search/eval/Evaluator.hpp"
 #include "search/shek/ShekTable.hpp"
 #include "search/shek/SCRDetector.hpp"
+#include "search/shek/GameHistory.hpp"
 #include "search/SearchInfo.hpp"
 #include "search/tree/NodeStat.hpp"
+#include "search/see/SEE.hpp"
+#include "search/history/History.hpp"
 #include "core/move/Moves.hpp"
 #include "core/position/Position.hpp"
 #include <string>
 #include <thread>
-#include <list>
+#include <algorithm>
+#include <memory>
 #include <cstdint>
 
 namespace sunfish {
@@ -25,6 +29,7 @@ namespace sunfish {
 struct Record;
 class Evaluator;
 class TT;
+class EvalCache;
 
 namespace GenPhase_ {
 
@@ -33,6 +38,7 @@ enum Type : uint16_t {
   Captures,
   Killers,
   Quiets,
+  BadQuiets,
   BadCaptures,
   InitEvasions,
   Evasions,
@@ -62,18 +68,30 @@ struct Node {
   Move ttMove;
   Move excludedMove;
 
+  Move counterMove;
   Move killerMove1;
   Move killerMove2;
   int16_t killerCount1;
   int16_t killerCount2;
 
   uint16_t genPhase;
+  uint16_t pickCount;
   Score probThreshold;
-  Moves::iterator moveIterator;
-  Moves::iterator badCaptureEnd;
-  Moves moves;
-  MoveArray<128> quietsSearched;
+  MoveSlice moves;
+  MoveSlice::iterator moveIterator;
+  MoveSlice::iterator badCaptureEnd;
+  MoveSlice::iterator goodQuietEnd;
+
+  SEECache seeCache;
+};
 
+/**
+ * ColdNode is the large data of a node which is not used on every visit.
+ * It is kept apart from Node, so that the nodes on the search path
+ * are packed into fewer cache lines.
+ */
+struct ColdNode {
+  MoveArray<128> quietsSearched;
   PV pv;
 };
 
@@ -82,27 +100,110 @@ struct RootPV {
   Score score;
 };
 
-void insertRootPV(std::list<RootPV>& rootPVs, Move move, int depth, const PV& pv, Score score, int capacity);
+/**
+ * RootPVs keeps the best PVs of the root moves for multi-PV
+ * in descending order of the scores.
+ * An equal score is placed after the existing ones.
+ */
+class RootPVs {
+public:
+
+  static CONSTEXPR_CONST int MaxSize = 16;
+
+  using const_iterator = const RootPV*;
+
+  RootPVs() : size_(0), capacity_(1) {
+  }
+
+  /**
+   * @param capacity the number of the PVs to keep (1 to MaxSize)
+   */
+  void clear(int capacity) {
+    size_ = 0;
+    capacity_ = std::max(std::min(capacity, static_cast<int>(MaxSize)), 1);
+  }
+
+  int size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  bool full() const {
+    return size_ >= capacity_;
+  }
+
+  const RootPV& back() const {
+    return pvs_[size_ - 1];
+  }
+
+  const_iterator begin() const {
+    return pvs_;
+  }
+
+  const_iterator end() const {
+    return pvs_ + size_;
+  }
+
+  /**
+   * Insert the PV which begins with the given root move.
+   * The PV is copied only when it is kept.
+   */
+  void insert(Move move, int depth, const PV& pv, Score score);
+
+private:
+
+  RootPV pvs_[MaxSize];
+  int size_;
+  int capacity_;
+
+};
 
 struct Tree {
   static CONSTEXPR_CONST int StackSize = 64;
+  static CONSTEXPR_CONST int MoveStackSize = MAX_NUMBER_OF_MOVES * 8;
+  /** the TT move, the killer moves and the counter move added to the generated moves */
+  static CONSTEXPR_CONST int ExtraMoveSize = 4;
+  static CONSTEXPR_CONST int CacheLineSize = 64;
 
   std::thread thread;
   int index;
   int completedDepth;
   Position position;
+  /** the positions of the game, shared by all trees */
+  const GameHistory* history;
+  /** the positions of the current search path */
   ShekTable shekTable;
-  SearchInfo info;
+  /** the evaluation cache of this tree (null: the shared cache of Evaluator) */
+  EvalCache* evalCache = nullptr;
+  // the counters are read by other threads,
+  // so they do not share cache lines with the other members.
+  uint8_t infoPadding1[CacheLineSize];
+  SearchCounters info;
+  uint8_t infoPadding2[CacheLineSize];
+  uint32_t checkCount;
   int ply;
   Node nodes[StackSize];
+  ColdNode coldNodes[StackSize];
+  Move moveStack[MoveStackSize];
   SCRDetector scr;
-  std::list<RootPV> rootPVs;
+  RootPVs rootPVs;
+  // the move ordering tables owned by each thread
+  CounterMove counterMoves;
+  std::unique_ptr<ContinuationHistory> contHistory;
 };
 
 void initializeTree(Tree& tree,
                     const Position& position,
                     Evaluator& eval,
-                    const Record* record);
+                    const GameHistory* history);
+
+/**
+ * check SHEK with the search path layered on the game history.
+ */
+ShekState checkShek(const Tree& tree);
 
 template <bool root>
 void visit(Tree& tree);
@@ -110,6 +211,17 @@ void visit(Tree& tree);
 template <bool root>
 void revisit(Tree& tree);
 
+/**
+ * Check whether the move stack has enough space to generate moves
+ * on the current node.
+ */
+inline
+bool hasMoveStackSpace(const Tree& tree) {
+  auto& node = tree.nodes[tree.ply];
+  return node.moves.begin() + MAX_NUMBER_OF_MOVES + Tree::ExtraMoveSize
+      <= tree.moveStack + Tree::MoveStackSize;
+}
+
 inline
 bool hasKiller1(const Tree& tree) {
   auto& node = tree.nodes[tree.ply];
@@ -153,6 +265,7 @@ bool isPriorMove(const Tree& tree,
                  const Move& move) {
   auto& node = tree.nodes[tree.ply];
   return move == node.ttMove ||
+         move == node.counterMove ||
          (isKiller1Good(tree) &&
           move == node.killerMove1) ||
          (isKiller2Good(tree) &&
@@ -161,6 +274,13 @@ bool isPriorMove(const Tree& tree,
 
 void addKiller(Tree& tree, Move move);
 
+/**
+ * Get the piece type and the destination of the move
+ * which was made 'n' plies before the current node. (n: 1 or 2)
+ * Return false if it is a null move or it is out of the tree.
+ */
+bool getPrevMove(const Tree& tree, int n, PieceType& pieceType, Square& to);
+
 template <bool shek>
 bool doMove(Tree& tree, Move& move, Evaluator& eval, TT& tt);
 
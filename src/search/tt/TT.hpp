@@ -30,7 +30,9 @@ public:
                  int depth,
                  int ply,
                  const Move& move,
-                 bool mateThreat) {
+                 bool mateThreat,
+                 Score eval = Score::invalid(),
+                 bool quies = false) {
     TTElement element;
     TTSlots& slots = getElement(hash);
     slots.get(hash, element);
@@ -41,12 +43,33 @@ public:
                        depth,
                        ply,
                        move,
-                       mateThreat)) {
+                       mateThreat,
+                       eval,
+                       quies)) {
       return slots.set(element);
     }
     return TTStatus::Reject;
   }
 
+  /**
+   * store an element received from another process.
+   * it is rejected if the current element of the position is deeper.
+   */
+  TTStatus import(Zobrist::Type hash, const TTElement& element) {
+    if (!element.checkHash(hash) || element.isQuies()) {
+      return TTStatus::Reject;
+    }
+
+    TTElement current;
+    TTSlots& slots = getElement(hash);
+    if (slots.get(hash, current) &&
+        !current.isQuies() &&
+        current.depth() >= element.depth()) {
+      return TTStatus::Reject;
+    }
+    return slots.set(element);
+  }
+
   bool get(Zobrist::Type hash, TTElement& e) {
     return getElement(hash).get(hash, e) &&
            e.checkHash(hash);
@@ -16,7 +16,9 @@ bool TTElement::update(Zobrist::Type newHash,
                        int newDepth,
                        int ply,
                        Move move,
-                       bool mateThreat) {
+                       bool mateThreat,
+                       Score eval,
+                       bool quies) {
   int newScoreType;
   if (newScore >= beta) {
     newScoreType = TTScoreType::Lower;
@@ -31,6 +33,11 @@ bool TTElement::update(Zobrist::Type newHash,
 
   // check if the hash value of the current data is equal to
   if (checkHash(newHash)) {
+    // the quiescence search never overwrites the result of the main search.
+    if (quies && !isQuies()) {
+      return false;
+    }
+
     // reject the data which has shallower depth than the current data.
     if (newDepth < depth() &&
         newScore < Score::mate() &&
@@ -41,6 +48,7 @@ bool TTElement::update(Zobrist::Type newHash,
   } else {
     // overwrite
     move_ = Move::none().serialize16();
+    eval_ = Score::invalid().raw();
     word_ = 0x00;
   }
 
@@ -57,8 +65,12 @@ bool TTElement::update(Zobrist::Type newHash,
   if (!move.isNone()) {
     move_ = move.serialize16();
   }
+  if (eval != Score::invalid()) {
+    eval_ = eval.raw();
+  }
   score_ = newScore.raw();
   word_ |= static_cast<uint16_t>(mateThreat) << TT_MATE_SHIFT;
+  word_ |= static_cast<uint16_t>(quies) << TT_QUIES_SHIFT;
   word_ |= static_cast<uint16_t>(newScoreType) << TT_STYPE_SHIFT;
   word_ |= static_cast<uint16_t>(newDepth) << TT_DEPTH_SHIFT;
   sum_ = calcCheckSum();
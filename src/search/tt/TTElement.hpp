@@ -17,19 +17,24 @@
 #define TT_STYPE_MASK ((uint16_t)0x0003)
 #define TT_DEPTH_MASK ((uint16_t)0x03fc)
 #define TT_MATE_MASK  ((uint16_t)0x0400)
+#define TT_QUIES_MASK ((uint16_t)0x0800)
 
 #define TT_STYPE_WIDTH 2
 #define TT_DEPTH_WIDTH 8
 #define TT_MATE_WIDTH  1
+#define TT_QUIES_WIDTH 1
 
 #define TT_STYPE_SHIFT 0
 #define TT_DEPTH_SHIFT (TT_STYPE_SHIFT + TT_STYPE_WIDTH)
 #define TT_MATE_SHIFT  (TT_DEPTH_SHIFT + TT_DEPTH_WIDTH)
+#define TT_QUIES_SHIFT (TT_MATE_SHIFT + TT_MATE_WIDTH)
 
 static_assert(TT_STYPE_WIDTH
             + TT_DEPTH_WIDTH
-            + TT_MATE_WIDTH <= 16, "invalid data size");
+            + TT_MATE_WIDTH
+            + TT_QUIES_WIDTH <= 16, "invalid data size");
 static_assert(TT_MATE_MASK == (((1LLU << TT_MATE_WIDTH) - 1LLU) << TT_MATE_SHIFT), "invalid status");
+static_assert(TT_QUIES_MASK == (((1LLU << TT_QUIES_WIDTH) - 1LLU) << TT_QUIES_SHIFT), "invalid status");
 static_assert(TT_STYPE_MASK == (((1LLU << TT_STYPE_WIDTH) - 1LLU) << TT_STYPE_SHIFT), "invalid status");
 static_assert(TT_DEPTH_MASK == (((1LLU << TT_DEPTH_WIDTH) - 1LLU) << TT_DEPTH_SHIFT), "invalid status");
 
@@ -53,6 +58,7 @@ private:
   uint16_t hash_;
   uint16_t move_;
   uint16_t score_;
+  uint16_t eval_;
   uint16_t word_;
   uint16_t sum_;
 
@@ -60,6 +66,7 @@ private:
     return hash_
          ^ move_
          ^ score_
+         ^ eval_
          ^ word_;
   }
 
@@ -68,6 +75,7 @@ public:
       hash_(0),
       move_(Move::none().serialize16()),
       score_(0),
+      eval_(Score::invalid().raw()),
       word_(0),
       sum_(0) {
   }
@@ -79,7 +87,9 @@ public:
               int newDepth,
               int ply,
               Move move,
-              bool mateThreat);
+              bool mateThreat,
+              Score eval = Score::invalid(),
+              bool quies = false);
 
   bool isLive() const {
     return (sum_ ^ calcCheckSum()) == 0LLU;
@@ -119,6 +129,14 @@ public:
     return static_cast<int>(data);
   }
 
+  /**
+   * the static evaluation of the position from the black side.
+   * Score::invalid() if it has not been stored.
+   */
+  Score eval() const {
+    return Score(static_cast<Score::RawType>(eval_));
+  }
+
   Move move() const {
     auto rawValue = static_cast<Move::RawType16>(move_);
     return Move::deserialize(rawValue);
@@ -128,6 +146,15 @@ public:
     return word_ & TT_MATE_MASK;
   }
 
+  /**
+   * Indicate whether the entry is stored by the quiescence search.
+   * The depth of such an entry is not comparable with
+   * the depth of the main search.
+   */
+  bool isQuies() const {
+    return word_ & TT_QUIES_MASK;
+  }
+
 };
 
 } // namespace sunfish
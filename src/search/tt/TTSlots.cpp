@@ -6,6 +6,26 @@
 #include "search/tt/TTSlots.hpp"
 #include <climits>
 
+namespace {
+
+using namespace sunfish;
+
+/**
+ * the order of the replacement.
+ * empty slots < quiescence search slots < main search slots
+ */
+int priority(const TTElement& e) {
+  if (!e.isLive()) {
+    return -2;
+  }
+  if (e.isQuies()) {
+    return -1;
+  }
+  return e.depth();
+}
+
+} // namespace
+
 namespace sunfish {
 
 TTStatus TTSlots::set(const TTElement& element) {
@@ -20,10 +40,16 @@ TTStatus TTSlots::set(const TTElement& element) {
   // find lesser slot
   TTElement* e = &slots_[0];
   for (SizeType i = 1; i < Size; i++) {
-    if (slots_[i].depth() < e->depth()) {
+    if (priority(slots_[i]) < priority(*e)) {
       e = &slots_[i];
     }
   }
+
+  // the quiescence search never evicts the result of the main search.
+  if (element.isQuies() && e->isLive() && !e->isQuies()) {
+    return TTStatus::Reject;
+  }
+
   *e = element;
 
   return TTStatus::Replace;
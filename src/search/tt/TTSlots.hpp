@@ -25,7 +25,7 @@ public:
 
   using SizeType = uint16_t;
 
-  static CONSTEXPR_CONST SizeType Size = 3;
+  static CONSTEXPR_CONST SizeType Size = 5;
 
   TTSlots() {
   }
@@ -42,8 +42,8 @@ private:
 
 };
 
-static_assert(sizeof(TTElement) == 10, "invalid struct size");
-static_assert(sizeof(TTSlots) <= 32, "invalid struct size");
+static_assert(sizeof(TTElement) == 12, "invalid struct size");
+static_assert(sizeof(TTSlots) <= 64, "invalid struct size");
 
 } // namespace sunfish
 
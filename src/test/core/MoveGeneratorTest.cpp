@@ -818,3 +818,60 @@ TEST(MoveGeneratorTest, testMateWithPawnDrop) {
     ASSERT_EQ(24, nocaps.size());
   }
 }
+
+TEST(MoveGeneratorTest, testLegal) {
+  {
+    // pinned gold
+    Position pos = PositionUtil::createPositionFromCsaString(
+      "P1 *  *  *  * -HI *  *  * -OU\n"
+      "P2 *  *  *  *  *  *  *  *  * \n"
+      "P3 *  *  *  *  *  *  *  *  * \n"
+      "P4 *  *  *  *  *  *  *  *  * \n"
+      "P5 *  *  *  *  *  *  *  *  * \n"
+      "P6 *  *  *  *  *  *  *  *  * \n"
+      "P7 *  *  *  *  *  *  *  *  * \n"
+      "P8 *  *  *  * +KI *  *  *  * \n"
+      "P9 *  *  *  * +OU *  *  *  * \n"
+      "P+\n"
+      "P-\n"
+      "+\n");
+
+    Moves moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
+    sortMovesForDebug(moves, pos);
+    ASSERT_EQ(5, moves.size());
+    ASSERT_EQ(Move(Square::s58(), Square::s57(), false), moves[0]);
+    ASSERT_EQ(Move(Square::s59(), Square::s48(), false), moves[1]);
+    ASSERT_EQ(Move(Square::s59(), Square::s49(), false), moves[2]);
+    ASSERT_EQ(Move(Square::s59(), Square::s68(), false), moves[3]);
+    ASSERT_EQ(Move(Square::s59(), Square::s69(), false), moves[4]);
+  }
+
+  {
+    // king can not step back along the checking line
+    Position pos = PositionUtil::createPositionFromCsaString(
+      "P1 *  *  *  *  *  *  *  * -OU\n"
+      "P2 *  *  *  *  *  *  *  *  * \n"
+      "P3 *  *  *  *  *  *  *  *  * \n"
+      "P4 *  *  *  *  *  *  *  *  * \n"
+      "P5 *  *  *  *  *  *  *  *  * \n"
+      "P6 * -KA *  *  *  *  *  *  * \n"
+      "P7 *  *  *  *  *  *  *  *  * \n"
+      "P8 *  *  * +OU *  *  *  *  * \n"
+      "P9 *  *  *  *  *  *  *  *  * \n"
+      "P+\n"
+      "P-\n"
+      "+\n");
+
+    Moves moves;
+    MoveGenerator::generateLegalEvasions(pos, pos.getCheckState(), moves);
+    sortMovesForDebug(moves, pos);
+    ASSERT_EQ(6, moves.size());
+    ASSERT_EQ(Move(Square::s68(), Square::s57(), false), moves[0]);
+    ASSERT_EQ(Move(Square::s68(), Square::s58(), false), moves[1]);
+    ASSERT_EQ(Move(Square::s68(), Square::s67(), false), moves[2]);
+    ASSERT_EQ(Move(Square::s68(), Square::s69(), false), moves[3]);
+    ASSERT_EQ(Move(Square::s68(), Square::s78(), false), moves[4]);
+    ASSERT_EQ(Move(Square::s68(), Square::s79(), false), moves[5]);
+  }
+}
@@ -6,6 +6,12 @@
 #include "test/Test.hpp"
 #include "core/position/Position.hpp"
 #include "core/util/PositionUtil.hpp"
+#include "core/record/SfenParser.hpp"
+#include "core/move/MoveGenerator.hpp"
+#include "core/move/MoveTables.hpp"
+#include "common/math/Random.hpp"
+#include <algorithm>
+#include <vector>
 
 using namespace sunfish;
 
@@ -2752,3 +2758,97 @@ TEST(PositionTest, testZobrist) {
   ASSERT_EQ(0x00LLU, pos.getTurnHash());
   ASSERT_EQ(0x00LLU, pos.getHash() & 0x01LLU);
 }
+
+TEST(PositionTest, testEffectBoard) {
+  {
+    Position pos(Position::Handicap::Even);
+    pos.enableEffectBoard();
+    const auto& eb = pos.getEffectBoard();
+
+    ASSERT_EQ(1, eb.getBlackCount(Square::s76()));
+    ASSERT_EQ(0, eb.getWhiteCount(Square::s76()));
+    ASSERT_EQ(0, eb.getBlackCount(Square::s19()));
+    ASSERT_EQ(3, eb.getBlackCount(Square::s78()));
+    ASSERT_EQ(3, eb.getBlackCount(Square::s38()));
+    ASSERT_EQ(2, eb.getBlackCount(Square::s18()));
+    ASSERT_EQ(EffectBoard::DirectionSet(0), eb.getLongEffects(Turn::Black, Square::s33()));
+
+    Piece captured;
+    ASSERT_TRUE(pos.doMove(Move(Square::s77(), Square::s76(), false), captured));
+    ASSERT_TRUE(pos.doMove(Move(Square::s33(), Square::s34(), false), captured));
+    ASSERT_EQ(1, eb.getBlackCount(Square::s33()));
+    ASSERT_TRUE(eb.hasLongEffect(Turn::Black, Square::s33(), Direction::RightUp));
+    ASSERT_EQ(1, eb.getWhiteCount(Square::s77()));
+    ASSERT_TRUE(eb.hasLongEffect(Turn::White, Square::s77(), Direction::LeftDown));
+  }
+
+  {
+    // random games
+    Random r;
+    for (int game = 0; game < 20; game++) {
+      Position pos(Position::Handicap::Even);
+      pos.enableEffectBoard();
+      std::vector<Move> history;
+      std::vector<Piece> capturedHistory;
+
+      for (int ply = 0; ply < 200; ply++) {
+        Moves moves;
+        MoveGenerator::generateLegalMoves(pos, moves);
+        if (moves.size() == 0) {
+          break;
+        }
+
+        Move move = moves[r.int32(moves.size())];
+        Piece captured;
+        if (!pos.doMove(move, captured)) {
+          continue;
+        }
+        history.push_back(move);
+        capturedHistory.push_back(captured);
+
+        EffectBoard expect;
+        expect.initialize(pos.getBoard());
+        ASSERT_TRUE(expect == pos.getEffectBoard());
+
+        Position ref = pos;
+        ref.disableEffectBoard();
+        ASSERT_EQ(ref.inCheck(), pos.inCheck());
+        if (ref.inCheck()) {
+          ASSERT_EQ(ref.isMate(), pos.isMate());
+        }
+        auto king = pos.getTurn() == Turn::Black ? pos.getBlackKingSquare()
+                                                 : pos.getWhiteKingSquare();
+        auto bb = MoveTables::king(king);
+        ASSERT_EQ(ref.extractKingSafeSquares(bb), pos.extractKingSafeSquares(bb));
+      }
+
+      while (!history.empty()) {
+        pos.undoMove(history.back(), capturedHistory.back());
+        history.pop_back();
+        capturedHistory.pop_back();
+      }
+
+      EffectBoard expect;
+      expect.initialize(pos.getBoard());
+      ASSERT_TRUE(expect == pos.getEffectBoard());
+      ASSERT_EQ(Position(Position::Handicap::Even).toString(), pos.toString());
+    }
+  }
+
+  {
+    // the dropped pawn blocks the effect of the rook, so it is not mate.
+    Position pos;
+    ASSERT_TRUE(SfenParser::parsePosition("3pkp3/R8/9/9/9/9/9/9/4K4 b P 1", pos));
+    pos.enableEffectBoard();
+    Move drop(PieceType::pawn(), Square::s52());
+    ASSERT_FALSE(pos.isMateWithPawnDrop());
+
+    Moves moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
+    ASSERT_TRUE(moves.end() != std::find(moves.begin(), moves.end(), drop));
+
+    moves.clear();
+    MoveGenerator::generateQuiets(pos, moves);
+    ASSERT_TRUE(moves.end() != std::find(moves.begin(), moves.end(), drop));
+  }
+}
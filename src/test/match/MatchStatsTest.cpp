@@ -0,0 +1,57 @@
+/* MatchStatsTest.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "test/Test.hpp"
+#include "match/MatchStats.hpp"
+#include <cmath>
+
+using namespace sunfish;
+
+TEST(MatchStatsTest, testElo) {
+  ASSERT_TRUE(std::fabs(MatchStats::scoreToElo(0.5)) < 1.0e-9);
+  ASSERT_TRUE(std::fabs(MatchStats::scoreToElo(0.75) - 190.85) < 0.01);
+  ASSERT_TRUE(std::fabs(MatchStats::eloToScore(190.85) - 0.75) < 1.0e-4);
+
+  MatchStats stats;
+  for (int i = 0; i < 60; i++) { stats.addWin(); }
+  for (int i = 0; i < 20; i++) { stats.addDraw(); }
+  for (int i = 0; i < 20; i++) { stats.addLoss(); }
+  ASSERT_EQ(100, stats.getGames());
+  ASSERT_TRUE(std::fabs(stats.score() - 0.7) < 1.0e-9);
+  ASSERT_TRUE(std::fabs(stats.elo() - 147.19) < 0.01);
+  ASSERT_TRUE(stats.eloError() > 50.0 && stats.eloError() < 100.0);
+  ASSERT_TRUE(stats.los() > 0.99);
+}
+
+TEST(MatchStatsTest, testSprt) {
+  MatchStats::SprtConfig config;
+  config.elo0 = 0.0;
+  config.elo1 = 10.0;
+  config.alpha = 0.05;
+  config.beta = 0.05;
+
+  ASSERT_TRUE(std::fabs(MatchStats::upperBound(config) - 2.944) < 0.001);
+  ASSERT_TRUE(std::fabs(MatchStats::lowerBound(config) + 2.944) < 0.001);
+
+  {
+    MatchStats stats;
+    for (int i = 0; i < 10; i++) { stats.addWin(); stats.addLoss(); }
+    ASSERT_TRUE(stats.sprt(config) == MatchStats::SprtResult::Continue);
+  }
+
+  {
+    MatchStats stats;
+    for (int i = 0; i < 600; i++) { stats.addWin(); stats.addDraw(); }
+    for (int i = 0; i < 400; i++) { stats.addLoss(); stats.addDraw(); }
+    ASSERT_TRUE(stats.sprt(config) == MatchStats::SprtResult::AcceptH1);
+  }
+
+  {
+    MatchStats stats;
+    for (int i = 0; i < 400; i++) { stats.addWin(); stats.addDraw(); }
+    for (int i = 0; i < 600; i++) { stats.addLoss(); stats.addDraw(); }
+    ASSERT_TRUE(stats.sprt(config) == MatchStats::SprtResult::AcceptH0);
+  }
+}
@@ -611,3 +611,41 @@ TEST(EvaluatorTest, testDataSourceType) {
   oss << static_cast<Evaluator::DataSourceType>(123);
   ASSERT_EQ("123", oss.str());
 }
+
+TEST(EvaluatorTest, testEvalCache) {
+  EvalCache cache(4);
+  Score score;
+
+  // the hashes share a bucket.
+  const Zobrist::Type base = 0x0123456789ab0005llu;
+  const Zobrist::Type step = 0x0000000100000000llu;
+  const int ways = EvalCacheElement::Ways;
+
+  for (int i = 0; i < ways; i++) {
+    cache.entry(base + step * i, Score(i * 10));
+  }
+  for (int i = 0; i < ways; i++) {
+    ASSERT_TRUE(cache.check(base + step * i, score));
+    ASSERT_EQ(Score(i * 10), score);
+  }
+
+  // the oldest entry is replaced.
+  cache.entry(base + step * ways, Score(-1));
+  ASSERT_FALSE(cache.check(base, score));
+  ASSERT_TRUE(cache.check(base + step * ways, score));
+  ASSERT_EQ(Score(-1), score);
+
+  // an existing entry is updated without evicting others.
+  cache.entry(base + step * 2, Score(123));
+  for (int i = 1; i <= ways; i++) {
+    ASSERT_TRUE(cache.check(base + step * i, score));
+  }
+  ASSERT_TRUE(cache.check(base + step * 2, score));
+  ASSERT_EQ(Score(123), score);
+
+  // the other buckets are not affected.
+  ASSERT_FALSE(cache.check(base + 1, score));
+
+  cache.resizeMB(1);
+  ASSERT_FALSE(cache.check(base + step, score));
+}
@@ -5,6 +5,7 @@
 
 #include "test/Test.hpp"
 #include "search/history/History.hpp"
+#include <memory>
 
 using namespace sunfish;
 
@@ -57,3 +58,47 @@ TEST(HistoryTest, testPieceToHistory) {
   ASSERT_EQ(0, pieceToHistory.get(Turn::White, PieceType::bishop(), Square::s82()));
   ASSERT_EQ(0, pieceToHistory.get(Turn::Black, PieceType::bishop(), Square::s82()));
 }
+
+TEST(HistoryTest, testContinuationHistory) {
+  std::unique_ptr<ContinuationHistory> contHistory(new ContinuationHistory());
+
+  contHistory->update(Turn::Black, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58(), 3);
+  contHistory->update(Turn::White, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58(), -2);
+  contHistory->update(Turn::Black, PieceType::dragon(), Square::s55(), PieceType::gold(), Square::s58(), 1);
+
+  ASSERT_EQ( 96, contHistory->get(Turn::Black, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+  ASSERT_EQ(-64, contHistory->get(Turn::White, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+  ASSERT_EQ( 32, contHistory->get(Turn::Black, PieceType::dragon(), Square::s55(), PieceType::gold(), Square::s58()));
+  ASSERT_EQ(  0, contHistory->get(Turn::Black, PieceType::horse(), Square::s55(), PieceType::silver(), Square::s58()));
+  ASSERT_EQ(  0, contHistory->get(Turn::Black, PieceType::horse(), Square::s58(), PieceType::gold(), Square::s55()));
+
+  contHistory->reduce();
+
+  ASSERT_EQ( 48, contHistory->get(Turn::Black, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+  ASSERT_EQ(-32, contHistory->get(Turn::White, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+
+  contHistory->clear();
+
+  ASSERT_EQ(0, contHistory->get(Turn::Black, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+  ASSERT_EQ(0, contHistory->get(Turn::White, PieceType::horse(), Square::s55(), PieceType::gold(), Square::s58()));
+}
+
+TEST(HistoryTest, testCounterMove) {
+  CounterMove counterMove;
+  Move move1(Square::s77(), Square::s76(), false);
+  Move move2(PieceType::pawn(), Square::s34());
+
+  ASSERT_TRUE(counterMove.get(Turn::Black, PieceType::pawn(), Square::s35()).isNone());
+
+  counterMove.set(Turn::Black, PieceType::pawn(), Square::s35(), move1);
+  counterMove.set(Turn::White, PieceType::pawn(), Square::s35(), move2);
+
+  ASSERT_EQ(move1, counterMove.get(Turn::Black, PieceType::pawn(), Square::s35()));
+  ASSERT_EQ(move2, counterMove.get(Turn::White, PieceType::pawn(), Square::s35()));
+  ASSERT_TRUE(counterMove.get(Turn::Black, PieceType::lance(), Square::s35()).isNone());
+
+  counterMove.clear();
+
+  ASSERT_TRUE(counterMove.get(Turn::Black, PieceType::pawn(), Square::s35()).isNone());
+  ASSERT_TRUE(counterMove.get(Turn::White, PieceType::pawn(), Square::s35()).isNone());
+}
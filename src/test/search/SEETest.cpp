@@ -344,3 +344,93 @@ TEST(SEETest, testCalculate) {
               SEE::calculate(pos, move));
   }
 }
+
+TEST(SEETest, testIsGreaterOrEqual) {
+  {
+    Position pos = PositionUtil::createPositionFromCsaString(
+      "P1 *  *  *  * -OU *  *  *  * \n"
+      "P2 *  *  *  *  *  *  *  *  * \n"
+      "P3 *  *  *  *  * +RY *  *  * \n"
+      "P4 *  *  *  *  *  * -KE *  * \n"
+      "P5 *  *  *  *  *  *  *  *  * \n"
+      "P6 *  *  *  * -KI-KY *  *  * \n"
+      "P7 *  *  *  *  *  * +GI *  * \n"
+      "P8 *  *  *  *  *  *  *  *  * \n"
+      "P9 *  *  *  * +OU *  *  * +KA\n"
+      "P+\n"
+      "P-\n"
+      "+\n");
+    Move move(Square::s37(), Square::s46(), false);
+    Score score = material::lanceEx()
+                - material::silverEx()
+                + material::knightEx()
+                - material::bishopEx()
+                + material::goldEx();
+    ASSERT_TRUE(SEE::isGreaterOrEqual(pos, move, score - 1));
+    ASSERT_TRUE(SEE::isGreaterOrEqual(pos, move, score));
+    ASSERT_FALSE(SEE::isGreaterOrEqual(pos, move, score + 1));
+  }
+
+  {
+    Position pos = PositionUtil::createPositionFromCsaString(
+      "P1 *  * -KY * -OU *  *  *  * \n"
+      "P2 *  *  *  *  *  *  *  *  * \n"
+      "P3-KA *  *  *  *  *  *  *  * \n"
+      "P4 *  *  *  *  *  *  *  *  * \n"
+      "P5 *  * +FU *  * +HI *  *  * \n"
+      "P6 * -GI+FU *  *  *  *  *  * \n"
+      "P7 *  *  * +KE *  *  *  *  * \n"
+      "P8 *  *  *  *  *  *  *  *  * \n"
+      "P9 *  *  *  * +OU *  *  *  * \n"
+      "P+\n"
+      "P-\n"
+      "-\n");
+    Move move(Square::s86(), Square::s75(), false);
+    Score score = material::pawnEx()
+                - material::silverEx();
+    ASSERT_TRUE(SEE::isGreaterOrEqual(pos, move, score));
+    ASSERT_FALSE(SEE::isGreaterOrEqual(pos, move, score + 1));
+    ASSERT_FALSE(SEE::isGreaterOrEqual(pos, move, Score::zero()));
+  }
+}
+
+TEST(SEETest, testCache) {
+  Position pos = PositionUtil::createPositionFromCsaString(
+    "P1 *  *  *  * -OU *  *  *  * \n"
+    "P2 *  *  *  *  *  *  *  *  * \n"
+    "P3 *  *  *  *  * +RY *  *  * \n"
+    "P4 *  *  *  *  *  * -KE *  * \n"
+    "P5 *  *  *  *  *  *  *  *  * \n"
+    "P6 *  *  *  * -KI-KY *  *  * \n"
+    "P7 *  *  *  *  *  * +GI *  * \n"
+    "P8 *  *  *  *  *  *  *  *  * \n"
+    "P9 *  *  *  * +OU *  *  * +KA\n"
+    "P+\n"
+    "P-\n"
+    "+\n");
+
+  SEECache cache;
+  cache.clear();
+
+  Move move1(Square::s37(), Square::s46(), false);
+  Move move2(Square::s43(), Square::s46(), false);
+  ASSERT_EQ(SEE::calculate(pos, move1), cache.calculate(pos, move1));
+  ASSERT_EQ(SEE::calculate(pos, move2), cache.calculate(pos, move2));
+
+  // more squares than the entries
+  for (int n = 0; n < 2; n++) {
+    for (int i = 0; i < SEECache::Size + 3; i++) {
+      Square to(Square::s46().raw() + i);
+      Bitboard expect = SEE::extractAggressors(pos, to);
+      const Bitboard& actual = cache.getAggressors(pos, to);
+      ASSERT_EQ(expect.first(), actual.first());
+      ASSERT_EQ(expect.second(), actual.second());
+    }
+  }
+
+  Bitboard bb = SEE::extractAggressors(pos, Square::s46());
+  bb.unset(Square::s43());
+  Bitboard bb2 = SEE::extractAggressors(pos, Square::s43(), Square::s46());
+  ASSERT_EQ(bb.first(), bb2.first());
+  ASSERT_EQ(bb.second(), bb2.second());
+}
@@ -0,0 +1,36 @@
+/* SearchParamTest.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "test/Test.hpp"
+#include "search/SearchParam.hpp"
+
+using namespace sunfish;
+
+TEST(SearchParamTest, testFind) {
+  ASSERT_EQ(SearchParam::RAZOR_MARGIN1Id, SearchParam::find("RAZOR_MARGIN1"));
+  ASSERT_EQ(SearchParam::SINGULAR_MARGINId, SearchParam::find("SINGULAR_MARGIN"));
+  ASSERT_EQ(-1, SearchParam::find("RAZOR_MARGIN"));
+}
+
+TEST(SearchParamTest, testDefault) {
+  for (int id = 0; id < SearchParam::Num; id++) {
+    const auto& info = SearchParam::getInfo(id);
+    ASSERT_EQ(info.defaultValue, SearchParam::get(id));
+    ASSERT_TRUE(info.minimumValue <= info.defaultValue);
+    ASSERT_TRUE(info.maximumValue >= info.defaultValue);
+  }
+}
+
+TEST(SearchParamTest, testSet) {
+  int id = SearchParam::RAZOR_MARGIN1Id;
+  const auto& info = SearchParam::getInfo(id);
+
+  bool ok = SearchParam::set(id, info.maximumValue + 1);
+  ASSERT_EQ(TUNING != 0, ok);
+  ASSERT_EQ(TUNING ? info.maximumValue : info.defaultValue, SearchParam::get(id));
+
+  SearchParam::reset();
+  ASSERT_EQ(info.defaultValue, SearchParam::get(id));
+}
@@ -0,0 +1,107 @@
+/* SharedRootResultsTest.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "test/Test.hpp"
+#include "search/tree/SharedRootResults.hpp"
+
+using namespace sunfish;
+
+namespace {
+
+Move move76() {
+  return Move(Square::s77(), Square::s76(), false);
+}
+
+Move move26() {
+  return Move(Square::s27(), Square::s26(), false);
+}
+
+Move move56() {
+  return Move(Square::s57(), Square::s56(), false);
+}
+
+} // namespace
+
+TEST(SharedRootResultsTest, testStoreAndLoad) {
+  Move buffer[2];
+  MoveSlice moves;
+  moves.reset(buffer);
+  moves.add(move76());
+  moves.add(move26());
+
+  SharedRootResults results;
+  results.prepare(moves);
+
+  SharedRootResults::Result result;
+  ASSERT_FALSE(results.load(move76(), result));
+
+  Move pvMoves[] = { move56() };
+  results.store(move76(), 8, Score(120), SharedRootResults::Bound::Exact, PV(1, pvMoves));
+  ASSERT_TRUE(results.load(move76(), result));
+  ASSERT_EQ(8, result.depth);
+  ASSERT_EQ(120, result.score.raw());
+  ASSERT_TRUE(result.bound == SharedRootResults::Bound::Exact);
+  ASSERT_EQ(1, result.pv.size());
+  ASSERT_EQ(move56(), result.pv.getMove(0));
+
+  ASSERT_FALSE(results.load(move26(), result));
+
+  // negative scores are kept.
+  results.store(move26(), 4, Score(-300), SharedRootResults::Bound::Upper, PV());
+  ASSERT_TRUE(results.load(move26(), result));
+  ASSERT_EQ(-300, result.score.raw());
+  ASSERT_TRUE(result.bound == SharedRootResults::Bound::Upper);
+  ASSERT_EQ(0, result.pv.size());
+
+  // the moves which are not registered
+  results.store(move56(), 8, Score(50), SharedRootResults::Bound::Exact, PV());
+  ASSERT_FALSE(results.load(move56(), result));
+}
+
+TEST(SharedRootResultsTest, testKeepDeeper) {
+  Move buffer[1];
+  MoveSlice moves;
+  moves.reset(buffer);
+  moves.add(move76());
+
+  SharedRootResults results;
+  results.prepare(moves);
+
+  SharedRootResults::Result result;
+  results.store(move76(), 12, Score(40), SharedRootResults::Bound::Exact, PV());
+  results.store(move76(), 8, Score(-40), SharedRootResults::Bound::Lower, PV());
+  ASSERT_TRUE(results.load(move76(), result));
+  ASSERT_EQ(12, result.depth);
+  ASSERT_EQ(40, result.score.raw());
+
+  // the same depth overwrites the result. (re-search)
+  results.store(move76(), 12, Score(60), SharedRootResults::Bound::Lower, PV());
+  ASSERT_TRUE(results.load(move76(), result));
+  ASSERT_EQ(60, result.score.raw());
+  ASSERT_TRUE(result.bound == SharedRootResults::Bound::Lower);
+}
+
+TEST(SharedRootResultsTest, testPrepare) {
+  Move buffer[2];
+  MoveSlice moves;
+  moves.reset(buffer);
+  moves.add(move76());
+
+  SharedRootResults results;
+  results.prepare(moves);
+
+  SharedRootResults::Result result;
+  results.store(move76(), 8, Score(10), SharedRootResults::Bound::Exact, PV());
+  ASSERT_TRUE(results.load(move76(), result));
+
+  moves.add(move26());
+  results.prepare(moves);
+  ASSERT_FALSE(results.load(move76(), result));
+  ASSERT_FALSE(results.load(move26(), result));
+
+  results.store(move26(), 4, Score(20), SharedRootResults::Bound::Exact, PV());
+  ASSERT_TRUE(results.load(move26(), result));
+  ASSERT_FALSE(results.load(move76(), result));
+}
@@ -6,6 +6,8 @@
 #include "test/Test.hpp"
 #include "core/util/PositionUtil.hpp"
 #include "search/shek/ShekTable.hpp"
+#include "search/shek/GameHistory.hpp"
+#include "core/record/Record.hpp"
 
 using namespace sunfish;
 
@@ -360,3 +362,28 @@ TEST(ShekTest, testSlot) {
   ASSERT_EQ(ShekState::None    , table.check(pos1));
   ASSERT_EQ(ShekState::None    , table.check(pos2));
 }
+
+TEST(ShekTest, testGameHistory) {
+  Record record;
+  record.initialPosition.initialize(Position::Handicap::Even);
+  record.moveList.push_back(Move(Square::s59(), Square::s58(), false));
+  record.moveList.push_back(Move(Square::s51(), Square::s52(), false));
+  record.moveList.push_back(Move(Square::s58(), Square::s59(), false));
+  record.moveList.push_back(Move(Square::s52(), Square::s51(), false));
+
+  GameHistory history;
+  ASSERT_TRUE(history.sync(record));
+  ASSERT_EQ(4u, history.size());
+  ASSERT_EQ(record.initialPosition.getHash(), history.getPosition().getHash());
+  ASSERT_EQ(record.initialPosition.getHash(), history.getEntry(0).hash);
+  ASSERT_EQ(ShekState::Equal, history.getShekTable().check(history.getPosition()));
+
+  // only the different moves are replaced.
+  record.moveList.pop_back();
+  record.moveList.pop_back();
+  record.moveList.push_back(Move(Square::s58(), Square::s48(), false));
+  ASSERT_TRUE(history.sync(record));
+  ASSERT_EQ(3u, history.size());
+  ASSERT_EQ(ShekState::None, history.getShekTable().check(history.getPosition()));
+  ASSERT_EQ(ShekState::Equal, history.getShekTable().check(record.initialPosition));
+}
@@ -0,0 +1,122 @@
+/* TTShareTest.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#if !defined(WIN32)
+
+#include "test/Test.hpp"
+#include "search/cluster/TTShare.hpp"
+#include "search/tt/TT.hpp"
+#include "search/Searcher.hpp"
+#include "core/position/Position.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace sunfish;
+
+TEST(TTShareTest, testImport) {
+  TT tt1;
+  TT tt2;
+  TTElement tte;
+
+  Position pos;
+  pos.initialize(Position::Handicap::Even);
+
+  tt1.store(pos.getHash(), Score(-100), Score(100), Score(50),
+            8 * Searcher::Depth1Ply, 0, Move(Square::s77(), Square::s76(), false), false);
+  ASSERT_TRUE(tt1.get(pos.getHash(), tte));
+  ASSERT_TRUE(tt2.import(pos.getHash(), tte) != TTStatus::Reject);
+
+  TTElement tte2;
+  ASSERT_TRUE(tt2.get(pos.getHash(), tte2));
+  ASSERT_EQ(tte.score(0).raw(), tte2.score(0).raw());
+  ASSERT_EQ(tte.depth(), tte2.depth());
+  ASSERT_TRUE(tte.move() == tte2.move());
+
+  // a shallower entry does not overwrite the deeper one.
+  TT tt3;
+  tt3.store(pos.getHash(), Score(-100), Score(100), Score(-20),
+            4 * Searcher::Depth1Ply, 0, Move(Square::s27(), Square::s26(), false), false);
+  ASSERT_TRUE(tt3.get(pos.getHash(), tte));
+  ASSERT_TRUE(tt2.import(pos.getHash(), tte) == TTStatus::Reject);
+  ASSERT_TRUE(tt2.get(pos.getHash(), tte2));
+  ASSERT_EQ(50, tte2.score(0).raw());
+}
+
+TEST(TTShareTest, testLoopback) {
+  TT tt1;
+  TT tt2;
+  TTShare share1(tt1);
+  TTShare share2(tt2);
+
+  ASSERT_TRUE(share1.open(0));
+  ASSERT_TRUE(share2.open(0));
+  ASSERT_TRUE(share1.addPeers("127.0.0.1:" + std::to_string(share2.getPort())));
+  ASSERT_TRUE(share2.addPeers("127.0.0.1:" + std::to_string(share1.getPort())));
+  share1.start();
+  share2.start();
+
+  Position pos;
+  pos.initialize(Position::Handicap::Even);
+
+  TTElement tte;
+  tt1.store(pos.getHash(), Score(-100), Score(100), Score(30),
+            10 * Searcher::Depth1Ply, 0, Move(Square::s77(), Square::s76(), false), false);
+  ASSERT_TRUE(tt1.get(pos.getHash(), tte));
+  share1.push(pos.getHash(), tte);
+
+  TTElement received;
+  bool ok = false;
+  for (int i = 0; i < 200 && !ok; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ok = tt2.get(pos.getHash(), received);
+  }
+
+  share1.stop();
+  share2.stop();
+
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(30, received.score(0).raw());
+  ASSERT_EQ(1u, share1.getStats().sent);
+  ASSERT_EQ(1u, share2.getStats().imported);
+}
+
+TEST(TTShareTest, testUnknownSource) {
+  TT tt1;
+  TT tt2;
+  TTShare share1(tt1);
+  TTShare share2(tt2);
+
+  ASSERT_TRUE(share1.open(0));
+  ASSERT_TRUE(share2.open(0));
+  ASSERT_TRUE(share1.addPeers("127.0.0.1:" + std::to_string(share2.getPort())));
+  // share1 is not a peer of share2.
+  ASSERT_TRUE(share2.addPeers("127.0.0.1:" + std::to_string(share2.getPort())));
+  share1.start();
+  share2.start();
+
+  Position pos;
+  pos.initialize(Position::Handicap::Even);
+
+  TTElement tte;
+  tt1.store(pos.getHash(), Score(-100), Score(100), Score(30),
+            10 * Searcher::Depth1Ply, 0, Move(Square::s77(), Square::s76(), false), false);
+  ASSERT_TRUE(tt1.get(pos.getHash(), tte));
+  share1.push(pos.getHash(), tte);
+
+  for (int i = 0; i < 20 && share1.getStats().sent == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  share1.stop();
+  share2.stop();
+
+  TTElement received;
+  ASSERT_EQ(1u, share1.getStats().sent);
+  ASSERT_EQ(0u, share2.getStats().received);
+  ASSERT_FALSE(tt2.get(pos.getHash(), received));
+}
+
+#endif // !defined(WIN32)
@@ -263,3 +263,94 @@ TEST(TTTest, testUpdate) {
                  /* mate  */ false);
   ASSERT_TRUE(TTStatus::Update == tts);
 }
+
+TEST(TTTest, testQuies) {
+  TT tt;
+  TTElement tte;
+  TTStatus tts;
+
+  // the entries share a single bucket.
+  auto hash = [](uint64_t key) {
+    return static_cast<Zobrist::Type>((key << 48) | 0x1234);
+  };
+
+  for (uint64_t key = 1; key <= TTSlots::Size; key++) {
+    tts = tt.store(/* hash  */ hash(key),
+                   /* alpha */ Score(-123),
+                   /* beta  */ Score(456),
+                   /* score */ Score(77),
+                   /* depth */ static_cast<int>(key) + 4,
+                   /* ply   */ 3,
+                   /* move  */ Move::none(),
+                   /* mate  */ false);
+    ASSERT_TRUE(TTStatus::Replace == tts);
+  }
+
+  // a quiescence search entry does not evict any main search entries.
+  tts = tt.store(/* hash  */ hash(0x100),
+                 /* alpha */ Score(-123),
+                 /* beta  */ Score(456),
+                 /* score */ Score(77),
+                 /* depth */ 1,
+                 /* ply   */ 3,
+                 /* move  */ Move::none(),
+                 /* mate  */ false,
+                 /* eval  */ Score(35),
+                 /* quies */ true);
+  ASSERT_TRUE(TTStatus::Reject == tts);
+  ASSERT_FALSE(tt.get(hash(0x100), tte));
+
+  // and does not overwrite a main search entry of the same position.
+  tts = tt.store(/* hash  */ hash(1),
+                 /* alpha */ Score(-123),
+                 /* beta  */ Score(456),
+                 /* score */ Score(88),
+                 /* depth */ 1,
+                 /* ply   */ 3,
+                 /* move  */ Move::none(),
+                 /* mate  */ false,
+                 /* eval  */ Score(35),
+                 /* quies */ true);
+  ASSERT_TRUE(TTStatus::Reject == tts);
+  ASSERT_TRUE(tt.get(hash(1), tte));
+  ASSERT_FALSE(tte.isQuies());
+  ASSERT_EQ(Score(77), tte.score(3));
+  ASSERT_EQ(Score::invalid(), tte.eval());
+
+  // a quiescence search entry is stored in an empty slot.
+  tt.clear();
+  tts = tt.store(/* hash  */ hash(1),
+                 /* alpha */ Score(-123),
+                 /* beta  */ Score(456),
+                 /* score */ Score(88),
+                 /* depth */ 0,
+                 /* ply   */ 3,
+                 /* move  */ Move(Square::s77(), Square::s76(), false),
+                 /* mate  */ false,
+                 /* eval  */ Score(35),
+                 /* quies */ true);
+  ASSERT_TRUE(TTStatus::Replace == tts);
+  ASSERT_TRUE(tt.get(hash(1), tte));
+  ASSERT_TRUE(tte.isQuies());
+  ASSERT_EQ(0, tte.depth());
+  ASSERT_EQ(Score(35), tte.eval());
+  ASSERT_EQ(Move(Square::s77(), Square::s76(), false), tte.move());
+
+  // the main search takes over the entry of the quiescence search
+  // and keeps the static evaluation.
+  tts = tt.store(/* hash  */ hash(1),
+                 /* alpha */ Score(-123),
+                 /* beta  */ Score(456),
+                 /* score */ Score(99),
+                 /* depth */ 4,
+                 /* ply   */ 3,
+                 /* move  */ Move::none(),
+                 /* mate  */ false);
+  ASSERT_TRUE(TTStatus::Update == tts);
+  ASSERT_TRUE(tt.get(hash(1), tte));
+  ASSERT_FALSE(tte.isQuies());
+  ASSERT_EQ(4, tte.depth());
+  ASSERT_EQ(Score(99), tte.score(3));
+  ASSERT_EQ(Score(35), tte.eval());
+  ASSERT_EQ(Move(Square::s77(), Square::s76(), false), tte.move());
+}
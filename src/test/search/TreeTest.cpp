@@ -41,7 +41,7 @@ TEST(TreeTest, testInitializeTree) {
   ASSERT_EQ(Piece::blackPawn(), tree.position.getPieceOnBoard(Square::s36()));
   ASSERT_EQ(Piece::whiteDragon(), tree.position.getPieceOnBoard(Square::s88()));
   ASSERT_EQ(0, tree.ply);
-  ASSERT_EQ(0, tree.info.nodes);
+  ASSERT_EQ(0, static_cast<uint64_t>(tree.info.nodes));
   ASSERT_EQ(g_eval.calculateMaterialScore(position), tree.nodes[0].materialScore);
   ASSERT_EQ(Score::invalid(), tree.nodes[0].score);
   ASSERT_EQ(Move::none(), tree.nodes[0].killerMove1);
@@ -53,23 +53,23 @@ TEST(TreeTest, testVisit) {
   tree.ply = 0;
   tree.nodes[0].isHistorical = true;
   tree.nodes[0].ttMove = Move(Square::s77(), Square::s76(), false);
-  tree.nodes[0].quietsSearched.add(Move(Square::s77(), Square::s76(), false));
-  tree.nodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
+  tree.coldNodes[0].quietsSearched.add(Move(Square::s77(), Square::s76(), false));
+  tree.coldNodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
   tree.nodes[1].killerMove1 = Move(Square::s77(), Square::s76(), false);
   tree.nodes[1].killerMove2 = Move(Square::s77(), Square::s76(), false);
   tree.nodes[1].excludedMove = Move(Square::s77(), Square::s76(), false);
   visit<false>(tree);
   ASSERT_FALSE(tree.nodes[0].isHistorical);
   ASSERT_EQ(Move::none(), tree.nodes[0].ttMove);
-  ASSERT_EQ(0, tree.nodes[0].quietsSearched.size());
-  ASSERT_EQ(0, tree.nodes[0].pv.size());
+  ASSERT_EQ(0, tree.coldNodes[0].quietsSearched.size());
+  ASSERT_EQ(0, tree.coldNodes[0].pv.size());
   ASSERT_EQ(Move::none(), tree.nodes[1].killerMove1);
   ASSERT_EQ(Move::none(), tree.nodes[1].killerMove2);
   ASSERT_EQ(Move::none(), tree.nodes[1].excludedMove);
 
-  tree.nodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
+  tree.coldNodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
   visit<true>(tree);
-  ASSERT_EQ(1, tree.nodes[0].pv.size());
+  ASSERT_EQ(1, tree.coldNodes[0].pv.size());
 }
 
 TEST(TreeTest, testRevisit) {
@@ -77,23 +77,23 @@ TEST(TreeTest, testRevisit) {
   tree.ply = 0;
   tree.nodes[0].isHistorical = true;
   tree.nodes[0].ttMove = Move(Square::s77(), Square::s76(), false);
-  tree.nodes[0].quietsSearched.add(Move(Square::s77(), Square::s76(), false));
-  tree.nodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
+  tree.coldNodes[0].quietsSearched.add(Move(Square::s77(), Square::s76(), false));
+  tree.coldNodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
   tree.nodes[1].killerMove1 = Move(Square::s77(), Square::s76(), false);
   tree.nodes[1].killerMove2 = Move(Square::s77(), Square::s76(), false);
   tree.nodes[1].excludedMove = Move(Square::s77(), Square::s76(), false);
   revisit<false>(tree);
   ASSERT_FALSE(tree.nodes[0].isHistorical);
   ASSERT_EQ(Move(Square::s77(), Square::s76(), false), tree.nodes[0].ttMove);
-  ASSERT_EQ(0, tree.nodes[0].quietsSearched.size());
-  ASSERT_EQ(0, tree.nodes[0].pv.size());
+  ASSERT_EQ(0, tree.coldNodes[0].quietsSearched.size());
+  ASSERT_EQ(0, tree.coldNodes[0].pv.size());
   ASSERT_EQ(Move::none(), tree.nodes[1].killerMove1);
   ASSERT_EQ(Move::none(), tree.nodes[1].killerMove2);
   ASSERT_EQ(Move::none(), tree.nodes[1].excludedMove);
 
-  tree.nodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
+  tree.coldNodes[0].pv.set(Move(Square::s77(), Square::s76(), false), 0, PV());
   revisit<true>(tree);
-  ASSERT_EQ(1, tree.nodes[0].pv.size());
+  ASSERT_EQ(1, tree.coldNodes[0].pv.size());
 }
 
 TEST(TreeTest, testHasKiller1) {
@@ -153,6 +153,7 @@ TEST(TreeTest, testIsPriorMove) {
   tree.nodes[3].killerCount1 = -1;
   tree.nodes[3].killerMove2 = move3;
   tree.nodes[3].killerCount2 = -1;
+  tree.nodes[3].counterMove = Move::none();
 
   // TTMove
   ASSERT_TRUE(isPriorMove(tree, move1));
@@ -167,7 +168,13 @@ TEST(TreeTest, testIsPriorMove) {
   tree.nodes[3].killerCount2 = 1;
   ASSERT_TRUE(isPriorMove(tree, move3));
 
+  // Counter move
+  ASSERT_FALSE(isPriorMove(tree, move4));
+  tree.nodes[3].counterMove = move4;
+  ASSERT_TRUE(isPriorMove(tree, move4));
+
   // Not match
+  tree.nodes[3].counterMove = Move::none();
   ASSERT_FALSE(isPriorMove(tree, move4));
 }
 
@@ -405,3 +412,30 @@ TEST(TreeTest, testIsRecapture) {
 TEST(TreeTest, testTargetPiece) {
   // TODO
 }
+
+TEST(TreeTest, testRootPVs) {
+  Move move76(Square::s77(), Square::s76(), false);
+  Move move26(Square::s27(), Square::s26(), false);
+  Move move56(Square::s57(), Square::s56(), false);
+  Move move16(Square::s17(), Square::s16(), false);
+
+  RootPVs rootPVs;
+  rootPVs.clear(3);
+  rootPVs.insert(move76, 4, PV(), Score(10));
+  rootPVs.insert(move26, 4, PV(), Score(30));
+  rootPVs.insert(move56, 4, PV(), Score(10));
+  ASSERT_TRUE(rootPVs.full());
+  ASSERT_EQ(move26, rootPVs.begin()[0].pv.getMove(0));
+  ASSERT_EQ(move76, rootPVs.begin()[1].pv.getMove(0));
+  ASSERT_EQ(move56, rootPVs.begin()[2].pv.getMove(0));
+
+  // an equal score is not kept when it is full.
+  rootPVs.insert(move16, 4, PV(), Score(10));
+  ASSERT_EQ(move56, rootPVs.back().pv.getMove(0));
+
+  rootPVs.insert(move16, 4, PV(), Score(20));
+  ASSERT_EQ(3, rootPVs.size());
+  ASSERT_EQ(move16, rootPVs.begin()[1].pv.getMove(0));
+  ASSERT_EQ(move76, rootPVs.back().pv.getMove(0));
+  ASSERT_EQ(10, rootPVs.back().score.raw());
+}
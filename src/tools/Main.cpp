@@ -11,6 +11,9 @@
 #include "logger/Logger.hpp"
 #include "tools/sfen2csa/Sfen2Csa.hpp"
 #include "tools/csa2kifu/Csa2Kifu.hpp"
+#include "tools/match/Match.hpp"
+#include "common/string/StringUtil.hpp"
+#include <string>
 
 using namespace sunfish;
 
@@ -23,6 +26,23 @@ int main(int argc, char** argv, char**) {
   po.addOption("sfen2csa", "SFEN-CSA converter");
   po.addOption("csa2kifu", "CSA-KIFU converter");
   po.addOption("gen-book", "generate opening book", true);
+  po.addOption("match", "play games between two USI engines and print Elo, SPRT and NPS");
+  po.addOption("engine1", "a path of the first USI engine (This option will used when the --match option is specified.)", true);
+  po.addOption("engine2", "a path of the second USI engine (default: the first engine)", true);
+  po.addOption("options1", "USI options of the first engine in NAME=VALUE,... format", true);
+  po.addOption("options2", "USI options of the second engine in NAME=VALUE,... format", true);
+  po.addOption("games", "a number of games", true);
+  po.addOption("jobs", "j", "a number of games played concurrently", true);
+  po.addOption("nodes", "a number of nodes for each move", true);
+  po.addOption("depth", "d", "a depth for each move", true);
+  po.addOption("byoyomi", "a time for each move in milliseconds (default: 1000 if neither --nodes nor --depth is specified)", true);
+  po.addOption("max-plies", "a number of plies adjudicated as a draw", true);
+  po.addOption("hash", "a TT size of each engine in MiB", true);
+  po.addOption("openings", "a file of opening positions (SFEN, `startpos moves ...' or `sfen ... moves ...' in each line)", true);
+  po.addOption("book-plies", "a number of plies played from the opening book when --openings is not specified", true);
+  po.addOption("sprt", "run SPRT with the specified hypotheses in ELO0,ELO1 format", true);
+  po.addOption("alpha", "a probability of type I error of SPRT", true);
+  po.addOption("beta", "a probability of type II error of SPRT", true);
   po.addOption("help", "h", "show this help");
   po.parse(argc, argv);
 
@@ -78,6 +98,75 @@ int main(int argc, char** argv, char**) {
     return 0;
   }
 
+  // match
+  if (po.has("match")) {
+    Match match;
+
+    auto config = match.getConfig();
+    if (!po.has("engine1")) {
+      MSG(error) << "--engine1 is required";
+      return 1;
+    }
+    config.enginePaths[0] = po.getValue("engine1");
+    config.enginePaths[1] = po.has("engine2") ? po.getValue("engine2") : config.enginePaths[0];
+    if (po.has("options1") && !Match::parseOptions(po.getValue("options1"), config.engineOptions[0])) {
+      return 1;
+    }
+    if (po.has("options2") && !Match::parseOptions(po.getValue("options2"), config.engineOptions[1])) {
+      return 1;
+    }
+    if (po.has("games")) {
+      config.numberOfGames = std::stoi(po.getValue("games"));
+    }
+    if (po.has("jobs")) {
+      config.numberOfJobs = std::stoi(po.getValue("jobs"));
+    }
+    if (po.has("nodes") || po.has("depth")) {
+      config.byoyomiMs = 0;
+    }
+    if (po.has("nodes")) {
+      config.nodes = std::stoull(po.getValue("nodes"));
+    }
+    if (po.has("depth")) {
+      config.depth = std::stoi(po.getValue("depth"));
+    }
+    if (po.has("byoyomi")) {
+      config.byoyomiMs = std::stoi(po.getValue("byoyomi"));
+    }
+    if (po.has("max-plies")) {
+      config.maximumPlies = std::stoi(po.getValue("max-plies"));
+    }
+    if (po.has("hash")) {
+      config.hashMebiBytes = std::stoi(po.getValue("hash"));
+    }
+    if (po.has("openings")) {
+      config.openingFile = po.getValue("openings");
+    }
+    if (po.has("book-plies")) {
+      config.bookPlies = std::stoi(po.getValue("book-plies"));
+    }
+    if (po.has("sprt")) {
+      auto elos = StringUtil::split(po.getValue("sprt"), ',');
+      if (elos.size() != 2) {
+        MSG(error) << "invalid hypotheses: " << po.getValue("sprt");
+        return 1;
+      }
+      config.sprt = true;
+      config.sprtConfig.elo0 = std::stod(elos[0]);
+      config.sprtConfig.elo1 = std::stod(elos[1]);
+    }
+    if (po.has("alpha")) {
+      config.sprtConfig.alpha = std::stod(po.getValue("alpha"));
+    }
+    if (po.has("beta")) {
+      config.sprtConfig.beta = std::stod(po.getValue("beta"));
+    }
+    match.setConfig(config);
+
+    bool ok = match.run(std::cout);
+    return ok ? 0 : 1;
+  }
+
   MSG(error) << "No action is specified.";
   std::cout << po.help();
 
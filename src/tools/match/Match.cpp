@@ -0,0 +1,355 @@
+/* Match.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "tools/match/Match.hpp"
+#include "book/Book.hpp"
+#include "book/BookUtil.hpp"
+#include "core/record/SfenParser.hpp"
+#include "common/string/StringUtil.hpp"
+#include "logger/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using namespace sunfish;
+
+const char* EngineLabels[] = { "engine1", "engine2" };
+
+const char* resultString(Game::Result result) {
+  switch (result) {
+  case Game::Result::BlackWin: return "1-0";
+  case Game::Result::WhiteWin: return "0-1";
+  default: return "1/2-1/2";
+  }
+}
+
+uint64_t nps(uint64_t nodes, int64_t timeMs) {
+  return nodes * 1000 / std::max(timeMs, static_cast<int64_t>(1));
+}
+
+void writeEngineStats(std::ostream& os, const Game::PlayerStats& stats) {
+  os << "nps=" << nps(stats.nodes, stats.timeMs)
+     << " time=" << stats.timeMs << "ms"
+     << " max=" << stats.maximumTimeMs << "ms";
+}
+
+} // namespace
+
+namespace sunfish {
+
+Match::Match() {
+  config_.numberOfGames = 100;
+  config_.numberOfJobs = 1;
+  config_.nodes = 0;
+  config_.depth = 0;
+  config_.byoyomiMs = 1000;
+  config_.maximumPlies = 256;
+  config_.hashMebiBytes = 64;
+  config_.bookPlies = 24;
+  config_.sprt = false;
+  config_.sprtConfig.elo0 = 0.0;
+  config_.sprtConfig.elo1 = 5.0;
+  config_.sprtConfig.alpha = 0.05;
+  config_.sprtConfig.beta = 0.05;
+}
+
+bool Match::run(std::ostream& os) {
+  if (config_.numberOfGames < 1 || config_.numberOfJobs < 1) {
+    LOG(error) << "invalid configuration";
+    return false;
+  }
+
+  if (config_.nodes == 0 && config_.depth == 0 && config_.byoyomiMs == 0) {
+    LOG(error) << "no limit of search is specified";
+    return false;
+  }
+
+  int numberOfPairs = (config_.numberOfGames + 1) / 2;
+
+  if (config_.openingFile.empty()) {
+    generateBookOpenings(numberOfPairs);
+  } else if (!loadOpeningFile()) {
+    return false;
+  }
+
+  int numberOfJobs = std::min(config_.numberOfJobs, numberOfPairs);
+  workers_.clear();
+  for (int i = 0; i < numberOfJobs; i++) {
+    std::unique_ptr<Worker> worker(new Worker());
+    for (int e = 0; e < NumberOfEngines; e++) {
+      if (!startEngine(worker->engines[e], e)) {
+        return false;
+      }
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  for (int e = 0; e < NumberOfEngines; e++) {
+    engineNames_[e] = workers_[0]->engines[e].getName();
+    engineStats_[e].moves = 0;
+    engineStats_[e].nodes = 0;
+    engineStats_[e].timeMs = 0;
+    engineStats_[e].maximumTimeMs = 0;
+    os << EngineLabels[e] << ": " << engineNames_[e]
+       << " (" << config_.enginePaths[e] << ")\n";
+  }
+  os << "games   : " << config_.numberOfGames << '\n';
+  os << "jobs    : " << numberOfJobs << '\n';
+  os << "openings: " << openings_.size() << '\n';
+  os << std::flush;
+
+  stats_ = MatchStats();
+
+  std::atomic<int> next(0);
+  std::atomic<bool> stop(false);
+  std::mutex mutex;
+  int gameNumber = 0;
+
+  auto work = [&](Worker& worker) {
+    Game game;
+    auto gameConfig = game.getConfig();
+    gameConfig.nodes = config_.nodes;
+    gameConfig.depth = config_.depth;
+    gameConfig.byoyomiMs = config_.byoyomiMs;
+    gameConfig.maximumPlies = config_.maximumPlies;
+    game.setConfig(gameConfig);
+
+    while (!stop.load()) {
+      int pair = next.fetch_add(1);
+      if (pair >= numberOfPairs) {
+        break;
+      }
+
+      const auto& opening = openings_[pair % openings_.size()];
+      for (int blackIndex = 0; blackIndex < NumberOfEngines; blackIndex++) {
+        if (pair * 2 + blackIndex >= config_.numberOfGames) {
+          break;
+        }
+
+        int whiteIndex = 1 - blackIndex;
+        auto result = game.play(worker.engines[blackIndex],
+                                worker.engines[whiteIndex],
+                                opening);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (result == Game::Result::Draw) {
+            stats_.addDraw();
+          } else if ((result == Game::Result::BlackWin) == (blackIndex == 0)) {
+            stats_.addWin();
+          } else {
+            stats_.addLoss();
+          }
+
+          for (int e = 0; e < NumberOfEngines; e++) {
+            const auto& gameStats = game.getStats(e == blackIndex ? Turn::Black : Turn::White);
+            auto& stats = engineStats_[e];
+            stats.moves += gameStats.moves;
+            stats.nodes += gameStats.nodes;
+            stats.timeMs += gameStats.timeMs;
+            stats.maximumTimeMs = std::max(stats.maximumTimeMs, gameStats.maximumTimeMs);
+          }
+
+          writeGame(os, ++gameNumber, blackIndex, result, game);
+
+          if (config_.sprt && stats_.sprt(config_.sprtConfig) != MatchStats::SprtResult::Continue) {
+            stop.store(true);
+          }
+        }
+
+        // a crashed engine is restarted for the next game.
+        if (game.getReason() == Game::Reason::EngineError) {
+          LOG(warning) << "engine error: restarting the engines";
+          for (int e = 0; e < NumberOfEngines; e++) {
+            startEngine(worker.engines[e], e);
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < workers_.size(); i++) {
+    Worker* worker = workers_[i].get();
+    threads.emplace_back([&work, worker]() {
+      work(*worker);
+    });
+  }
+  work(*workers_[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  workers_.clear();
+
+  writeSummary(os);
+
+  return true;
+}
+
+bool Match::parseOptions(const std::string& str, OptionList& options) {
+  auto items = StringUtil::split(str, [](char c) {
+    return c == ',';
+  });
+
+  for (const auto& item : items) {
+    auto pos = item.find('=');
+    if (pos == std::string::npos || pos == 0) {
+      LOG(error) << "invalid option: " << item;
+      return false;
+    }
+    options.push_back({ item.substr(0, pos), item.substr(pos + 1) });
+  }
+
+  return true;
+}
+
+bool Match::loadOpeningFile() {
+  std::ifstream file(config_.openingFile);
+  if (!file) {
+    LOG(error) << "could not open a file: " << config_.openingFile;
+    return false;
+  }
+
+  openings_.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    line = StringUtil::trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    // `startpos moves ...', `sfen ... moves ...' or a SFEN string
+    Position pos;
+    if (line.compare(0, 8, "startpos") == 0 || line.compare(0, 4, "sfen") == 0) {
+      auto args = StringUtil::split("position " + line, [](char c) {
+        return isspace(c);
+      });
+      Record record;
+      if (!SfenParser::parseUsiCommand(args.begin(), args.end(), record)) {
+        LOG(error) << "invalid position: " << line;
+        return false;
+      }
+      pos = generatePosition(record, -1);
+    } else if (!SfenParser::parsePosition(line, pos)) {
+      LOG(error) << "invalid SFEN: " << line;
+      return false;
+    }
+    openings_.push_back(pos);
+  }
+
+  if (openings_.empty()) {
+    LOG(error) << "no opening positions: " << config_.openingFile;
+    return false;
+  }
+
+  return true;
+}
+
+void Match::generateBookOpenings(int numberOfPairs) {
+  Book book;
+  if (!book.load()) {
+    LOG(warning) << "all games are started from the initial position";
+  }
+
+  openings_.clear();
+  for (int i = 0; i < numberOfPairs; i++) {
+    Position pos;
+    pos.initialize(Position::Handicap::Even);
+    for (int ply = 0; ply < config_.bookPlies; ply++) {
+      Move move = BookUtil::select(book, pos, random_);
+      Piece captured;
+      if (move.isNone() || !pos.doMove(move, captured)) {
+        break;
+      }
+    }
+    openings_.push_back(pos);
+  }
+}
+
+bool Match::startEngine(UsiEngine& engine, int index) {
+  if (!engine.start(config_.enginePaths[index])) {
+    return false;
+  }
+
+  engine.setOption("USI_Ponder", "false");
+  engine.setOption("USI_Hash", config_.hashMebiBytes);
+  // the openings are given by the match.
+  if (engine.hasOption("UseBook")) {
+    engine.setOption("UseBook", "false");
+  }
+
+  for (const auto& option : config_.engineOptions[index]) {
+    if (!engine.hasOption(option.first)) {
+      LOG(warning) << EngineLabels[index] << " does not have the option " << option.first;
+    }
+    engine.setOption(option.first, option.second);
+  }
+
+  return true;
+}
+
+void Match::writeGame(std::ostream& os, int number, int blackIndex,
+                      Game::Result result, const Game& game) const {
+  int whiteIndex = 1 - blackIndex;
+  os << "game " << number << ": "
+     << EngineLabels[blackIndex] << " - " << EngineLabels[whiteIndex] << ' '
+     << resultString(result)
+     << " (" << Game::toString(game.getReason())
+     << ", " << game.getRecord().moveList.size() << " plies)"
+     << " | " << EngineLabels[blackIndex] << ": ";
+  writeEngineStats(os, game.getStats(Turn::Black));
+  os << " | " << EngineLabels[whiteIndex] << ": ";
+  writeEngineStats(os, game.getStats(Turn::White));
+  os << " | W-D-L " << stats_.getWins() << '-' << stats_.getDraws() << '-' << stats_.getLosses()
+     << std::endl;
+}
+
+void Match::writeSummary(std::ostream& os) const {
+  auto flags = os.flags();
+
+  os << '\n';
+  os << "games   : " << stats_.getGames()
+     << " (W-D-L " << stats_.getWins() << '-' << stats_.getDraws() << '-' << stats_.getLosses() << ")\n";
+  os << std::fixed;
+  os << "score   : " << std::setprecision(1) << stats_.score() * 100.0 << "%\n";
+  os << "elo     : " << std::showpos << stats_.elo() << std::noshowpos
+     << " +/- " << stats_.eloError() << '\n';
+  os << "los     : " << stats_.los() * 100.0 << "%\n";
+
+  if (config_.sprt) {
+    const auto& sprtConfig = config_.sprtConfig;
+    os << "sprt    : elo0=" << sprtConfig.elo0 << " elo1=" << sprtConfig.elo1
+       << " alpha=" << std::setprecision(3) << sprtConfig.alpha
+       << " beta=" << sprtConfig.beta
+       << " llr=" << stats_.llr(sprtConfig)
+       << " [" << MatchStats::lowerBound(sprtConfig)
+       << ", " << MatchStats::upperBound(sprtConfig) << "] ";
+    switch (stats_.sprt(sprtConfig)) {
+    case MatchStats::SprtResult::AcceptH0: os << "H0 accepted\n"; break;
+    case MatchStats::SprtResult::AcceptH1: os << "H1 accepted\n"; break;
+    default: os << "continue\n"; break;
+    }
+  }
+
+  for (int e = 0; e < NumberOfEngines; e++) {
+    const auto& stats = engineStats_[e];
+    os << EngineLabels[e] << " : nps=" << nps(stats.nodes, stats.timeMs)
+       << " time/move=" << std::setprecision(1)
+       << static_cast<double>(stats.timeMs) / std::max(stats.moves, 1) << "ms"
+       << " max=" << stats.maximumTimeMs << "ms"
+       << " moves=" << stats.moves << '\n';
+  }
+
+  os.flags(flags);
+  os << std::flush;
+}
+
+} // namespace sunfish
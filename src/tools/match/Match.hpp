@@ -0,0 +1,125 @@
+/* Match.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_TOOLS_MATCH_MATCH_HPP__
+#define SUNFISH_TOOLS_MATCH_MATCH_HPP__
+
+#include "match/Game.hpp"
+#include "match/MatchStats.hpp"
+#include "match/UsiEngine.hpp"
+#include "common/math/Random.hpp"
+#include "core/position/Position.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace sunfish {
+
+/**
+ * Match plays games between two USI engines concurrently
+ * and reports the Elo difference, SPRT and the speed of each engine.
+ * Each opening is played twice with the colors swapped.
+ */
+class Match {
+public:
+
+  static CONSTEXPR_CONST int NumberOfEngines = 2;
+
+  using OptionList = std::vector<std::pair<std::string, std::string>>;
+
+  struct Config {
+    std::string enginePaths[NumberOfEngines];
+    /** the USI options of each engine */
+    OptionList engineOptions[NumberOfEngines];
+    int numberOfGames;
+    /** the number of games played concurrently */
+    int numberOfJobs;
+    /** the number of nodes for each move (0: unlimited) */
+    uint64_t nodes;
+    /** the depth for each move (0: unlimited) */
+    int depth;
+    /** the time for each move (0: unlimited) */
+    int byoyomiMs;
+    int maximumPlies;
+    unsigned hashMebiBytes;
+    /** a file of the opening positions (empty: use the opening book) */
+    std::string openingFile;
+    /** the number of plies played from the opening book */
+    int bookPlies;
+    bool sprt;
+    MatchStats::SprtConfig sprtConfig;
+  };
+
+  /**
+   * the speed of an engine over the games.
+   */
+  struct EngineStats {
+    int moves;
+    uint64_t nodes;
+    int64_t timeMs;
+    int maximumTimeMs;
+  };
+
+  Match();
+
+  bool run(std::ostream& os);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  /**
+   * the results from the first engine's point of view.
+   */
+  const MatchStats& getStats() const {
+    return stats_;
+  }
+
+  /**
+   * Parse the options in `NAME=VALUE,NAME=VALUE,...' format.
+   */
+  static bool parseOptions(const std::string& str, OptionList& options);
+
+private:
+
+  struct Worker {
+    UsiEngine engines[NumberOfEngines];
+  };
+
+  bool loadOpenings();
+
+  bool loadOpeningFile();
+
+  void generateBookOpenings(int numberOfPairs);
+
+  bool startEngine(UsiEngine& engine, int index);
+
+  void writeGame(std::ostream& os, int number, int blackIndex,
+                 Game::Result result, const Game& game) const;
+
+  void writeSummary(std::ostream& os) const;
+
+private:
+
+  Config config_;
+  MatchStats stats_;
+  EngineStats engineStats_[NumberOfEngines];
+  std::string engineNames_[NumberOfEngines];
+  std::vector<Position> openings_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Random random_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_TOOLS_MATCH_MATCH_HPP__
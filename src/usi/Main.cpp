@@ -3,10 +3,12 @@
  * Kubo Ryosuke
  */
 
+#include "common/program_options/ProgramOptions.hpp"
 #include "common/resource/Resource.hpp"
 #include "core/util/CoreUtil.hpp"
 #include "search/util/SearchUtil.hpp"
 #include "usi/client/UsiClient.hpp"
+#include "usi/cluster/ClusterCoordinator.hpp"
 #include "logger/Logger.hpp"
 #include <iostream>
 #include <fstream>
@@ -21,11 +23,23 @@ const char* UsiLogPath = "res/strings/usi_log_path";
 
 using namespace sunfish;
 
-int main(int, char**, char**) {
+int main(int argc, char** argv, char**) {
   // initialize static objects
   CoreUtil::initialize();
   SearchUtil::initialize();
 
+  // program options
+  ProgramOptions po;
+  po.addOption("cluster", "run as the coordinator of the workers defined in the specified INI file", true);
+  po.addOption("help", "h", "show this help");
+  po.parse(argc, argv);
+
+  // --help or -h
+  if (po.has("help")) {
+    std::cout << po.help();
+    return 0;
+  }
+
   // Logger settings
   std::ofstream fout;
   auto logPath = Resource::string(resources::UsiLogPath, "");
@@ -39,6 +53,15 @@ int main(int, char**, char**) {
     Loggers::receive.addStream(fout, true, true);
   }
 
+  if (po.has("cluster")) {
+    ClusterCoordinator coordinator;
+    if (!coordinator.readConfig(po.getValue("cluster")) ||
+        !coordinator.start()) {
+      return 1;
+    }
+    return 0;
+  }
+
   // USI client
   UsiClient().start();
 
@@ -10,14 +10,18 @@
 #include "book/BookUtil.hpp"
 #include "core/record/SfenParser.hpp"
 #include "search/eval/Material.hpp"
+#include "search/bench/Bench.hpp"
+#include "search/SearchParam.hpp"
 #include "logger/Logger.hpp"
 #include <iomanip>
+#include <fstream>
 #include <sstream>
 #include <utility>
 #include <unordered_map>
 #include <functional>
 #include <chrono>
 #include <cctype>
+#include <ctime>
 #include <cstdint>
 #include <cstdlib>
 
@@ -43,12 +47,20 @@ UsiClient::UsiClient() : breakReceiver_(false), isBookLoaded(false) {
 
   options_.ponder = true;
   options_.hash = 32;
+  options_.evalHash = 2;
+  options_.evalHashPerThread = false;
   options_.useBook = true;
   options_.snappy = true;
   options_.marginMs = 500;
   options_.numberOfThreads = 1;
   options_.maxDepth = 64;
   options_.multiPV = 1;
+  options_.nodesTime = 0;
+  options_.statsIntervalMs = 0;
+  options_.effectBoard = false;
+  options_.clusterIndex = 0;
+  options_.clusterPort = 0;
+  options_.clusterShareDepth = TTShare::DefaultDepth;
 }
 
 void UsiClient::start() {
@@ -69,6 +81,11 @@ void UsiClient::ready() {
     auto command = receive();
 
     if (command == "isready") {
+      // TT must not be changed by the other processes while it is resized.
+      if (ttShare_) {
+        ttShare_->stop();
+      }
+
       if (!searcher_) {
         auto dataSourceType = Evaluator::sharedEvaluator()->dataSourceType();
         if (dataSourceType != Evaluator::DataSourceType::EvalBin) {
@@ -82,10 +99,22 @@ void UsiClient::ready() {
         searcher_->clean();
       }
 
+      if (options_.traceFile.empty()) {
+        searcher_->getTracer().disable();
+      } else if (!searcher_->getTracer().isEnabled()) {
+        searcher_->getTracer().enable();
+      }
+
       if (options_.hash != 0) {
         searcher_->ttResizeMB(options_.hash);
       }
 
+      if (options_.evalHash != 0) {
+        searcher_->evalCacheResizeMB(options_.evalHash, options_.evalHashPerThread);
+      }
+
+      setupCluster();
+
       if (!isBookLoaded) {
         book_.load();
         isBookLoaded = true;
@@ -99,11 +128,64 @@ void UsiClient::ready() {
       return isspace(c);
     });
 
+    // >bench [depth]
+    if (args[0] == "bench") {
+      runBench(args);
+      continue;
+    }
+
     LOG(error) << "unknown command: " << command;
     exit(0);
   }
 }
 
+void UsiClient::setupCluster() {
+  searcher_->setClusterIndex(options_.clusterIndex);
+  searcher_->setTTShare(nullptr);
+  ttShare_.reset();
+
+  if (options_.clusterPort == 0) {
+    return;
+  }
+
+  // the processes started at the same time must shuffle the root moves differently.
+  searcher_->seedRandom(static_cast<unsigned>(time(nullptr)) + options_.clusterIndex);
+
+  ttShare_.reset(new TTShare(searcher_->getTT()));
+  if (!ttShare_->open(options_.clusterPort) ||
+      !ttShare_->addPeers(options_.clusterPeers)) {
+    LOG(error) << "failed to join the cluster";
+    ttShare_.reset();
+    return;
+  }
+  ttShare_->setDepth(options_.clusterShareDepth);
+  ttShare_->start();
+  searcher_->setTTShare(ttShare_.get());
+}
+
+void UsiClient::runBench(const CommandArguments& args) {
+  Searcher searcher(Evaluator::sharedEvaluator());
+  Bench bench;
+
+  auto config = bench.getConfig();
+  if (args.size() >= 2) {
+    config.depth = StringUtil::toInt(args[1], config.depth);
+  }
+  config.numberOfThreads = options_.numberOfThreads;
+  bench.setConfig(config);
+
+  if (!bench.run(searcher)) {
+    send("info", "string", "bench failed");
+    return;
+  }
+
+  const auto& result = bench.getResult();
+  send("info", "string", "positions", result.positions);
+  send("info", "string", "nodes", result.nodes);
+  send("info", "string", "nps", bench.nps());
+  send("info", "string", "signature", bench.signatureString());
+}
+
 void UsiClient::receiveNewGame() {
   auto command = receive();
 
@@ -184,6 +266,8 @@ void UsiClient::runSearch(const CommandArguments& args) {
   byoyomiMs_ = 0;
   blackIncMs_ = 0;
   whiteIncMs_ = 0;
+  maximumNodes_ = SearchConfig::InfinityNodes;
+  maximumDepth_ = 0;
   isInfinite_ = false;
 
   for (size_t i = 1; i < args.size(); i++) {
@@ -202,6 +286,12 @@ void UsiClient::runSearch(const CommandArguments& args) {
     } else if (args[i] == "winc") {
       whiteIncMs_ = strtol(args[++i].c_str(), nullptr, 10);
 
+    } else if (args[i] == "nodes") {
+      maximumNodes_ = strtoull(args[++i].c_str(), nullptr, 10);
+
+    } else if (args[i] == "depth") {
+      maximumDepth_ = static_cast<int>(strtol(args[++i].c_str(), nullptr, 10));
+
     } else if (args[i] == "infinite") {
       isInfinite_ = true;
     }
@@ -212,6 +302,8 @@ void UsiClient::runSearch(const CommandArguments& args) {
   MSG(info) << "byoyomi  : " << byoyomiMs_;
   MSG(info) << "binc     : " << blackIncMs_;
   MSG(info) << "winc     : " << whiteIncMs_;
+  MSG(info) << "nodes    : " << maximumNodes_;
+  MSG(info) << "depth    : " << maximumDepth_;
   MSG(info) << "inifinite: " << (isInfinite_ ? "true" : "false");
 
   // check opening book
@@ -236,7 +328,7 @@ void UsiClient::runSearch(const CommandArguments& args) {
     search();
   }, [this]() {
     searcher_->interrupt();
-    stopCommandReceived_ = true;
+    setFlag(stopCommandReceived_);
   });
   waitForSearcherIsStarted();
 
@@ -260,7 +352,10 @@ void UsiClient::search() {
   auto pos = generatePosition(record_, -1);
   auto config = searcher_->getConfig();
 
-  if (isInfinite_) {
+  bool noTimeLimit = blackTimeMs_ == 0 && whiteTimeMs_ == 0 && byoyomiMs_ == 0 &&
+                     blackIncMs_ == 0 && whiteIncMs_ == 0;
+  bool hasLimit = maximumNodes_ != SearchConfig::InfinityNodes || maximumDepth_ != 0;
+  if (isInfinite_ || (hasLimit && noTimeLimit)) {
     config.maximumTimeMs = SearchConfig::InfinityTime;
     config.optimumTimeMs = SearchConfig::InfinityTime;
 
@@ -284,10 +379,20 @@ void UsiClient::search() {
 
   config.numberOfThreads = options_.numberOfThreads;
   config.multiPV = options_.multiPV;
+  config.maximumNodes = maximumNodes_;
+  config.nodesPerMs = options_.nodesTime;
+  config.statsIntervalMs = options_.statsIntervalMs;
+  config.effectBoard = options_.effectBoard;
 
   searcher_->setConfig(config);
 
-  searcher_->idsearch(pos, options_.maxDepth * Searcher::Depth1Ply, &record_);
+  int maxDepth = options_.maxDepth;
+  if (maximumDepth_ != 0) {
+    maxDepth = std::min(maxDepth, maximumDepth_);
+  }
+
+  history_.sync(record_);
+  searcher_->idsearch(pos, maxDepth * Searcher::Depth1Ply, &history_);
 
   if (isInfinite_) {
     waitForStopCommand();
@@ -298,6 +403,17 @@ void UsiClient::search() {
   bool canPonder = !result.move.isNone() &&
                    result.pv.size() >= 2;
 
+  // the final statistics
+  {
+    auto timeMs = static_cast<uint32_t>(result.elapsed * 1e3);
+    auto totalNodes = info.nodes + info.quiesNodes;
+    auto nps = static_cast<uint64_t>(totalNodes / std::max(result.elapsed, 1.0e-3f));
+    send("info",
+         "time", timeMs,
+         "nodes", totalNodes,
+         "nps", nps);
+  }
+
   // send the result of search
   if (canPonder) {
     send("bestmove", result.move.toStringSFEN(),
@@ -310,6 +426,14 @@ void UsiClient::search() {
 
   // print the result of search
   printSearchInfo(MSG(info), info, result.elapsed);
+  if (ttShare_) {
+    auto stats = ttShare_->getStats();
+    MSG(info) << "cluster: sent=" << stats.sent
+              << " received=" << stats.received
+              << " imported=" << stats.imported;
+  }
+
+  writeTrace();
 
   // notify to receiver
   breakReceive();
@@ -317,6 +441,20 @@ void UsiClient::search() {
   MSG(info) << "search thread is stopped. tid=" << std::this_thread::get_id();
 }
 
+void UsiClient::writeTrace() {
+  if (!searcher_->getTracer().isEnabled()) {
+    return;
+  }
+
+  std::ofstream file(options_.traceFile);
+  if (!file) {
+    LOG(error) << "could not open a file: " << options_.traceFile;
+    return;
+  }
+
+  searcher_->getTracer().writeChromeTrace(file);
+}
+
 void UsiClient::runPonder(const CommandArguments&) {
   searcherIsStarted_ = false;
   inPonder_ = true;
@@ -364,34 +502,48 @@ void UsiClient::ponder() {
   config.optimumTimeMs = SearchConfig::InfinityTime;
   config.numberOfThreads = options_.numberOfThreads;
   config.multiPV = options_.multiPV;
+  config.maximumNodes = SearchConfig::InfinityNodes;
+  config.nodesPerMs = 0;
+  config.statsIntervalMs = options_.statsIntervalMs;
+  config.effectBoard = options_.effectBoard;
 
   searcher_->setConfig(config);
 
-  searcher_->idsearch(pos, options_.maxDepth * Searcher::Depth1Ply, &record_);
+  history_.sync(record_);
+  searcher_->idsearch(pos, options_.maxDepth * Searcher::Depth1Ply, &history_);
 
   MSG(info) << "ponder thread is stopped. tid=" << std::this_thread::get_id();
 }
 
 void UsiClient::waitForSearcherIsStarted() {
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    if (searcherIsStarted_) { break; }
-  }
+  waitForFlag(searcherIsStarted_);
 }
 
 void UsiClient::waitForStopCommand() {
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    if (stopCommandReceived_) { break; }
+  waitForFlag(stopCommandReceived_);
+}
+
+void UsiClient::setFlag(std::atomic<bool>& flag) {
+  {
+    std::lock_guard<std::mutex> lock(flagMutex_);
+    flag = true;
   }
+  flagCond_.notify_all();
+}
+
+void UsiClient::waitForFlag(const std::atomic<bool>& flag) {
+  std::unique_lock<std::mutex> lock(flagMutex_);
+  flagCond_.wait(lock, [&flag]() {
+    return flag.load();
+  });
 }
 
 void UsiClient::onStart(const Searcher&) {
-  searcherIsStarted_ = true;
+  setFlag(searcherIsStarted_);
 }
 
 void UsiClient::onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, bool failLow, bool failHigh, int multiPV) {
-  auto& info = searcher.getInfo();
+  const auto& info = searcher.getInfo();
 
   auto timeMs = static_cast<uint32_t>(elapsed * 1e3);
   auto realDepth = depth / Searcher::Depth1Ply;
@@ -453,6 +605,23 @@ void UsiClient::onFailHigh(const Searcher& searcher, const PV& pv, float elapsed
 void UsiClient::onIterateEnd(const Searcher& searcher, float elapsed, int depth) {
 }
 
+void UsiClient::onStats(const Searcher& searcher, float elapsed) {
+  const auto& info = searcher.getInfo();
+
+  auto timeMs = static_cast<uint32_t>(elapsed * 1e3);
+  auto totalNodes = info.nodes + info.quiesNodes;
+  auto nps = static_cast<uint64_t>(totalNodes / std::max(elapsed, 1.0e-3f));
+  auto hashfull = static_cast<int>(searcher.ttUsageRates() * 1000);
+
+  if (!inPonder_) {
+    send("info",
+         "time", timeMs,
+         "nodes", totalNodes,
+         "nps", nps,
+         "hashfull", hashfull);
+  }
+}
+
 std::string UsiClient::receive() {
   for (;;) {
     auto command = receiveWithBreak();
@@ -469,20 +638,19 @@ std::pair<UsiClient::CommandState, std::string> UsiClient::receiveWithBreak() {
     return { CommandState::Ok, command };
   }
 
-  while (!breakReceiver_) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    {
-      std::lock_guard<std::mutex> lock(receiveMutex_);
-      if (!commandQueue_.empty()) {
-        auto cs = commandQueue_.front();
-        commandQueue_.pop();
-        return { CommandState::Ok, cs };
-      }
-    }
+  std::unique_lock<std::mutex> lock(receiveMutex_);
+  receiveCond_.wait(lock, [this]() {
+    return breakReceiver_ || !commandQueue_.empty();
+  });
+
+  if (breakReceiver_) {
+    breakReceiver_ = false;
+    return { CommandState::Broken, "" };
   }
-  breakReceiver_ = false;
 
-  return { CommandState::Broken, "" };
+  auto cs = commandQueue_.front();
+  commandQueue_.pop();
+  return { CommandState::Ok, cs };
 }
 
 void UsiClient::receiver() {
@@ -539,6 +707,7 @@ void UsiClient::receiver() {
         command
       });
     }
+    receiveCond_.notify_one();
   }
 }
 
@@ -548,12 +717,32 @@ void UsiClient::acceptUsi() {
   send("id", "name", name);
   send("id", "author", author);
 
+  send("option", "name", "EvalHash", "type", "spin", "default", "2", "min", "1", "max", "1024");
+  send("option", "name", "EvalHashPerThread", "type", "check", "default", "false");
   send("option", "name", "UseBook", "type", "check", "default", "true");
   send("option", "name", "Snappy", "type", "check", "default", "true");
   send("option", "name", "MarginMs", "type", "spin", "default", "500", "min", "0", "max", "2000");
   send("option", "name", "Threads", "type", "spin", "default", "1", "min", "1", "max", "32");
   send("option", "name", "MaxDepth", "type", "spin", "default", "64", "min", "1", "max", "64");
   send("option", "name", "MultiPV", "type", "spin", "default", "1", "min", "1", "max", "10");
+  send("option", "name", "NodesTime", "type", "spin", "default", "0", "min", "0", "max", "100000");
+  send("option", "name", "StatsIntervalMs", "type", "spin", "default", "0", "min", "0", "max", "60000");
+  send("option", "name", "TraceFile", "type", "string", "default", "<empty>");
+  send("option", "name", "EffectBoard", "type", "check", "default", "false");
+  send("option", "name", "ClusterIndex", "type", "spin", "default", "0", "min", "0", "max", "255");
+  send("option", "name", "ClusterPort", "type", "spin", "default", "0", "min", "0", "max", "65535");
+  send("option", "name", "ClusterPeers", "type", "string", "default", "<empty>");
+  send("option", "name", "ClusterShareDepth", "type", "spin", "default", TTShare::DefaultDepth, "min", "1", "max", "64");
+
+#if TUNING
+  for (int id = 0; id < SearchParam::Num; id++) {
+    const auto& info = SearchParam::getInfo(id);
+    send("option", "name", info.name, "type", "spin",
+         "default", SearchParam::get(id),
+         "min", info.minimumValue,
+         "max", info.maximumValue);
+  }
+#endif
 
   send("usiok");
 }
@@ -566,6 +755,10 @@ void UsiClient::setOption(const CommandArguments& args) {
     options_.ponder = value == "true";
   } else if (name == "USI_Hash") {
     options_.hash = std::stoi(value);
+  } else if (name == "EvalHash") {
+    options_.evalHash = StringUtil::toInt(value, options_.evalHash);
+  } else if (name == "EvalHashPerThread") {
+    options_.evalHashPerThread = value == "true";
   } else if (name == "UseBook") {
     options_.useBook = value == "true";
   } else if (name == "Snappy") {
@@ -578,13 +771,39 @@ void UsiClient::setOption(const CommandArguments& args) {
     options_.maxDepth = StringUtil::toInt(value, options_.maxDepth);
   } else if (name == "MultiPV") {
     options_.multiPV = StringUtil::toInt(value, options_.multiPV);
+  } else if (name == "NodesTime") {
+    options_.nodesTime = StringUtil::toInt(value, options_.nodesTime);
+  } else if (name == "StatsIntervalMs") {
+    options_.statsIntervalMs = StringUtil::toInt(value, options_.statsIntervalMs);
+  } else if (name == "EffectBoard") {
+    options_.effectBoard = value == "true";
+  } else if (name == "TraceFile") {
+    options_.traceFile = value != "<empty>" ? value : "";
+  } else if (name == "ClusterIndex") {
+    options_.clusterIndex = StringUtil::toInt(value, options_.clusterIndex);
+  } else if (name == "ClusterPort") {
+    options_.clusterPort = StringUtil::toInt(value, options_.clusterPort);
+  } else if (name == "ClusterShareDepth") {
+    options_.clusterShareDepth = StringUtil::toInt(value, options_.clusterShareDepth);
+  } else if (name == "ClusterPeers") {
+    options_.clusterPeers = value != "<empty>" ? value : "";
+#if TUNING
+  } else if (SearchParam::find(name.c_str()) != -1) {
+    int id = SearchParam::find(name.c_str());
+    SearchParam::set(id, StringUtil::toInt(value, SearchParam::get(id)));
+    Searcher::initialize();
+#endif
   } else {
     LOG(warning) << "unknown option: " << name;
   }
 }
 
 void UsiClient::breakReceive() {
-  breakReceiver_ = true;
+  {
+    std::lock_guard<std::mutex> lock(receiveMutex_);
+    breakReceiver_ = true;
+  }
+  receiveCond_.notify_one();
 }
 
 template <class T>
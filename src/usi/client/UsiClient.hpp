@@ -11,7 +11,9 @@
 #include "core/record/Record.hpp"
 #include "book/Book.hpp"
 #include "search/Searcher.hpp"
+#include "search/cluster/TTShare.hpp"
 #include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -34,12 +36,22 @@ private:
   struct Options {
     std::atomic_bool ponder;
     std::atomic_uint hash;
+    std::atomic_uint evalHash;
+    std::atomic_bool evalHashPerThread;
     std::atomic_bool useBook;
     std::atomic_bool snappy;
     std::atomic_int marginMs;
     std::atomic_int numberOfThreads;
     std::atomic_int maxDepth;
     std::atomic_int multiPV;
+    std::atomic_uint nodesTime;
+    std::atomic_uint statsIntervalMs;
+    std::atomic_bool effectBoard;
+    std::string traceFile;
+    std::atomic_int clusterIndex;
+    std::atomic_int clusterPort;
+    std::atomic_int clusterShareDepth;
+    std::string clusterPeers;
   };
 
   enum class CommandState : uint8_t {
@@ -56,12 +68,15 @@ public:
 private:
 
   void ready();
+  void setupCluster();
+  void runBench(const CommandArguments& args);
   void receiveNewGame();
   void game();
   void receiveGo();
 
   void runSearch(const CommandArguments& args);
   void search();
+  void writeTrace();
 
   void runPonder(const CommandArguments& args);
   void ponder();
@@ -69,12 +84,16 @@ private:
   void waitForSearcherIsStarted();
   void waitForStopCommand();
 
+  void setFlag(std::atomic<bool>& flag);
+  void waitForFlag(const std::atomic<bool>& flag);
+
   void onStart(const Searcher&) override;
   void onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, bool failLow, bool failHigh, int multiPV);
   void onUpdatePV(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score, int multiPV) override;
   void onFailLow(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
   void onFailHigh(const Searcher& searcher, const PV& pv, float elapsed, int depth, Score score) override;
   void onIterateEnd(const Searcher& searcher, float elapsed, int depth) override;
+  void onStats(const Searcher& searcher, float elapsed) override;
 
   std::string receive();
 
@@ -107,16 +126,20 @@ private:
   std::string lastGoCommand_;
 
   Record record_;
+  GameHistory history_;
 
   TimeType blackTimeMs_;
   TimeType whiteTimeMs_;
   TimeType byoyomiMs_;
   TimeType blackIncMs_;
   TimeType whiteIncMs_;
+  uint64_t maximumNodes_;
+  int maximumDepth_;
   bool isInfinite_;
   bool inPonder_;
 
   std::unique_ptr<Searcher> searcher_;
+  std::unique_ptr<TTShare> ttShare_;
   std::atomic<bool> searcherIsStarted_;
   std::atomic<bool> stopCommandReceived_;
   std::atomic<bool> breakReceiver_;
@@ -128,6 +151,9 @@ private:
 
   std::mutex sendMutex_;
   std::mutex receiveMutex_;
+  std::condition_variable receiveCond_;
+  std::mutex flagMutex_;
+  std::condition_variable flagCond_;
   std::thread receiver_;
 
 };
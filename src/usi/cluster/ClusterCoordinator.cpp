@@ -0,0 +1,440 @@
+/* ClusterCoordinator.cpp
+ *
+ * Kubo Ryosuke
+ */
+
+#include "usi/cluster/ClusterCoordinator.hpp"
+#include "search/cluster/TTShare.hpp"
+#include "common/resource/Resource.hpp"
+#include "common/string/StringUtil.hpp"
+#include "logger/Logger.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <cctype>
+
+namespace {
+
+using namespace sunfish;
+
+const char* const ClusterSection = "Cluster";
+
+/** the time limit of the responses to usi and quit */
+CONSTEXPR_CONST int CommandTimeoutMs = 30 * 1000;
+CONSTEXPR_CONST int QuitTimeoutMs = 3 * 1000;
+
+CONSTEXPR_CONST int MateScore = 32000;
+
+std::vector<std::string> splitCommand(const std::string& line) {
+  return StringUtil::split(line, [](char c) {
+    return isspace(c);
+  });
+}
+
+} // namespace
+
+namespace sunfish {
+
+ClusterCoordinator::ClusterCoordinator() :
+    waitingForReady_(0),
+    searching_(0),
+    quit_(false) {
+  config_.shareDepth = TTShare::DefaultDepth;
+}
+
+bool ClusterCoordinator::readConfig(const char* path) {
+  auto ini = Resource::ini(path);
+
+  config_.workers.clear();
+  for (int i = 0; ; i++) {
+    auto key = "Worker" + std::to_string(i);
+    auto value = getValue(ini, ClusterSection, key.c_str());
+    if (value.empty()) {
+      break;
+    }
+
+    auto args = splitCommand(value);
+    WorkerConfig worker;
+    worker.port = args.size() >= 3 ? StringUtil::toInt(args[1], 0) : 0;
+    if (worker.port <= 0) {
+      LOG(error) << "invalid worker: " << key << " = " << value;
+      return false;
+    }
+    worker.host = args[0];
+    worker.command.assign(args.begin() + 2, args.end());
+    config_.workers.push_back(worker);
+  }
+
+  config_.shareDepth = StringUtil::toInt(getValue(ini, ClusterSection, "ShareDepth"),
+                                         TTShare::DefaultDepth);
+
+  if (config_.workers.empty()) {
+    LOG(error) << "no workers are defined: " << path;
+    return false;
+  }
+
+  return true;
+}
+
+bool ClusterCoordinator::start() {
+  workers_.clear();
+  for (int i = 0; i < static_cast<int>(config_.workers.size()); i++) {
+    workers_.emplace_back(new Worker());
+    if (!startWorker(i)) {
+      return false;
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(workers_.size()); i++) {
+    auto& worker = *workers_[i];
+    worker.reader = std::thread([this, i, &worker]() {
+      std::string line;
+      while (worker.process.readLine(line)) {
+        push({ i, line, false });
+      }
+      push({ i, "", true });
+    });
+  }
+
+  // std::getline can not be interrupted, so this thread is never joined.
+  std::thread([this]() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+      push({ Gui, line, false });
+    }
+    push({ Gui, "quit", false });
+  }).detach();
+
+  quit_ = false;
+  while (!quit_) {
+    auto event = pop();
+    if (event.source == Gui) {
+      MSG(receive) << event.line;
+      onGuiCommand(event.line);
+    } else if (event.closed) {
+      onWorkerClosed(event.source);
+    } else {
+      onWorkerLine(event.source, event.line);
+    }
+  }
+
+  quit();
+
+  return true;
+}
+
+bool ClusterCoordinator::startWorker(int index) {
+  const auto& config = config_.workers[index];
+  auto& worker = *workers_[index];
+
+  std::vector<std::string> args(config.command.begin() + 1, config.command.end());
+  if (!worker.process.start(config.command[0], args)) {
+    LOG(error) << "could not start the worker " << index << ": " << config.command[0];
+    return false;
+  }
+  worker.alive = true;
+  worker.searching = false;
+
+  sendToWorker(index, "usi");
+  for (;;) {
+    std::string line;
+    if (!worker.process.readLine(line, CommandTimeoutMs)) {
+      LOG(error) << "no response to usi from the worker " << index;
+      return false;
+    }
+
+    if (line == "usiok") {
+      return true;
+    }
+
+    // the first worker tells the GUI its name and options.
+    if (index != 0) {
+      continue;
+    }
+    if (line.compare(0, 8, "id name ") == 0) {
+      name_ = line.substr(8);
+    } else if (line.compare(0, 7, "option ") == 0 &&
+               line.compare(0, 19, "option name Cluster") != 0) {
+      optionLines_.push_back(line);
+    }
+  }
+}
+
+void ClusterCoordinator::onGuiCommand(const std::string& line) {
+  auto args = splitCommand(line);
+  if (args.empty()) {
+    return;
+  }
+
+  const auto& command = args[0];
+
+  if (command == "usi") {
+    sendToGui("id name " + name_ + " Cluster");
+    sendToGui("id author Kubo Ryosuke");
+    for (const auto& optionLine : optionLines_) {
+      sendToGui(optionLine);
+    }
+    sendToGui("usiok");
+
+  } else if (command == "setoption") {
+    // the cluster options are given by this coordinator.
+    if (args.size() >= 3 && args[2].compare(0, 7, "Cluster") == 0) {
+      return;
+    }
+    broadcast(line);
+
+  } else if (command == "isready") {
+    waitingForReady_ = 0;
+    for (int i = 0; i < static_cast<int>(workers_.size()); i++) {
+      if (!workers_[i]->alive) {
+        continue;
+      }
+
+      std::ostringstream peers;
+      for (int j = 0; j < static_cast<int>(workers_.size()); j++) {
+        if (j != i) {
+          peers << (peers.tellp() != 0 ? "," : "")
+                << config_.workers[j].host << ':' << config_.workers[j].port;
+        }
+      }
+
+      sendToWorker(i, "setoption name ClusterIndex value " + std::to_string(i));
+      sendToWorker(i, "setoption name ClusterPort value " + std::to_string(config_.workers[i].port));
+      sendToWorker(i, "setoption name ClusterPeers value " + (peers.tellp() != 0 ? peers.str() : "<empty>"));
+      sendToWorker(i, "setoption name ClusterShareDepth value " + std::to_string(config_.shareDepth));
+      sendToWorker(i, "isready");
+      waitingForReady_++;
+    }
+
+  } else if (command == "go") {
+    searching_ = 0;
+    for (auto& worker : workers_) {
+      worker->searching = worker->alive;
+      worker->bestMove.clear();
+      worker->depth = 0;
+      worker->score = 0;
+      worker->pvMove.clear();
+      if (worker->alive) {
+        searching_++;
+      }
+    }
+    broadcast(line);
+
+  } else if (command == "quit") {
+    quit_ = true;
+
+  } else {
+    // usinewgame, position, stop, ponderhit and gameover
+    broadcast(line);
+  }
+}
+
+void ClusterCoordinator::onWorkerLine(int index, const std::string& line) {
+  auto& worker = *workers_[index];
+
+  if (line == "readyok") {
+    if (waitingForReady_ > 0 && --waitingForReady_ == 0) {
+      sendToGui("readyok");
+    }
+    return;
+  }
+
+  // the first alive worker is the main worker.
+  int mainIndex = 0;
+  while (mainIndex + 1 < static_cast<int>(workers_.size()) && !workers_[mainIndex]->alive) {
+    mainIndex++;
+  }
+
+  if (line.compare(0, 5, "info ") == 0) {
+    if (index == mainIndex) {
+      sendToGui(line);
+    }
+
+    // the bounds are reported before the iteration is completed.
+    if (line.find(" lowerbound") != std::string::npos ||
+        line.find(" upperbound") != std::string::npos) {
+      return;
+    }
+
+    auto args = splitCommand(line);
+    int depth = -1;
+    int score = 0;
+    for (size_t i = 1; i + 1 < args.size(); i++) {
+      if (args[i] == "depth") {
+        depth = StringUtil::toInt(args[i + 1], -1);
+      } else if (args[i] == "score" && i + 2 < args.size()) {
+        if (args[i + 1] == "cp") {
+          score = StringUtil::toInt(args[i + 2], 0);
+        } else if (args[i + 1] == "mate") {
+          score = args[i + 2][0] == '-' ? -MateScore : MateScore;
+        }
+      } else if (args[i] == "pv") {
+        if (depth >= worker.depth) {
+          worker.depth = depth;
+          worker.score = score;
+          worker.pvMove = args[i + 1];
+        }
+        break;
+      }
+    }
+    return;
+  }
+
+  if (line.compare(0, 9, "bestmove ") == 0) {
+    worker.bestMove = line;
+    if (!worker.searching) {
+      return;
+    }
+    worker.searching = false;
+    searching_--;
+
+    // the other workers follow the main worker.
+    if (index == mainIndex) {
+      for (int i = 0; i < static_cast<int>(workers_.size()); i++) {
+        if (workers_[i]->searching) {
+          sendToWorker(i, "stop");
+        }
+      }
+    }
+
+    if (searching_ == 0) {
+      finishSearch();
+    }
+  }
+}
+
+void ClusterCoordinator::onWorkerClosed(int index) {
+  auto& worker = *workers_[index];
+  if (!worker.alive) {
+    return;
+  }
+
+  LOG(error) << "the worker " << index << " exited";
+  worker.alive = false;
+
+  bool anyAlive = false;
+  for (const auto& w : workers_) {
+    anyAlive = anyAlive || w->alive;
+  }
+  if (!anyAlive) {
+    LOG(error) << "all workers exited";
+    quit_ = true;
+    return;
+  }
+
+  if (waitingForReady_ > 0 && --waitingForReady_ == 0) {
+    sendToGui("readyok");
+  }
+
+  if (worker.searching) {
+    worker.searching = false;
+    if (--searching_ == 0) {
+      finishSearch();
+    }
+  }
+}
+
+void ClusterCoordinator::finishSearch() {
+  // the main worker unless the other worker searched deeper.
+  int first = -1;
+  int best = -1;
+  for (int i = 0; i < static_cast<int>(workers_.size()); i++) {
+    const auto& worker = *workers_[i];
+    if (worker.bestMove.empty()) {
+      continue;
+    }
+    if (best == -1) {
+      first = best = i;
+      continue;
+    }
+
+    auto args = splitCommand(worker.bestMove);
+    if (args.size() >= 2 &&
+        args[1] == worker.pvMove &&
+        worker.depth > workers_[best]->depth) {
+      best = i;
+    }
+  }
+
+  if (best == -1) {
+    sendToGui("bestmove resign");
+    return;
+  }
+
+  const auto& worker = *workers_[best];
+  if (best != first) {
+    std::ostringstream oss;
+    oss << "info string cluster: worker " << best
+        << " depth " << worker.depth
+        << " score " << worker.score;
+    sendToGui(oss.str());
+  }
+  sendToGui(worker.bestMove);
+}
+
+void ClusterCoordinator::broadcast(const std::string& command) {
+  for (int i = 0; i < static_cast<int>(workers_.size()); i++) {
+    if (workers_[i]->alive) {
+      sendToWorker(i, command);
+    }
+  }
+}
+
+void ClusterCoordinator::sendToWorker(int index, const std::string& command) {
+  workers_[index]->process.writeLine(command);
+}
+
+void ClusterCoordinator::sendToGui(const std::string& line) {
+  std::cout << line << std::endl;
+  MSG(send) << line;
+}
+
+void ClusterCoordinator::push(Event&& event) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push(std::move(event));
+  }
+  cond_.notify_one();
+}
+
+ClusterCoordinator::Event ClusterCoordinator::pop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this]() {
+    return !events_.empty();
+  });
+  Event event = std::move(events_.front());
+  events_.pop();
+  return event;
+}
+
+void ClusterCoordinator::quit() {
+  broadcast("quit");
+
+  // wait for the exits of the workers.
+  int alive = 0;
+  for (const auto& worker : workers_) {
+    alive += worker->alive ? 1 : 0;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(QuitTimeoutMs);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (alive > 0) {
+    if (!cond_.wait_until(lock, deadline, [this]() { return !events_.empty(); })) {
+      break;
+    }
+    auto event = std::move(events_.front());
+    events_.pop();
+    if (event.source != Gui && event.closed && workers_[event.source]->alive) {
+      workers_[event.source]->alive = false;
+      alive--;
+    }
+  }
+  lock.unlock();
+
+  for (auto& worker : workers_) {
+    worker->process.stop();
+    worker->reader.join();
+  }
+}
+
+} // namespace sunfish
@@ -0,0 +1,135 @@
+/* ClusterCoordinator.hpp
+ *
+ * Kubo Ryosuke
+ */
+
+#ifndef SUNFISH_USI_CLUSTER_CLUSTERCOORDINATOR_HPP__
+#define SUNFISH_USI_CLUSTER_CLUSTERCOORDINATOR_HPP__
+
+#include "common/process/ChildProcess.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sunfish {
+
+/**
+ * ClusterCoordinator is a USI front end of a cluster of USI engines.
+ * It passes the commands of the GUI to all workers,
+ * and the workers search the same position sharing the deep entries
+ * of their TTs with each other. (see TTShare)
+ * The first worker decides when to stop, and the bestmove of the worker
+ * which reported the deepest PV is sent to the GUI.
+ */
+class ClusterCoordinator {
+public:
+
+  struct WorkerConfig {
+    /** the address of the UDP port of the worker seen from the other workers */
+    std::string host;
+    int port;
+    /** the program and its arguments */
+    std::vector<std::string> command;
+  };
+
+  struct Config {
+    std::vector<WorkerConfig> workers;
+    /** the minimum depth of the shared TT entries */
+    int shareDepth;
+  };
+
+  ClusterCoordinator();
+
+  /**
+   * Read the configuration from an INI file:
+   *   [Cluster]
+   *   Worker0 = HOST PORT COMMAND [ARGS...]
+   *   Worker1 = HOST PORT COMMAND [ARGS...]
+   *   ShareDepth = 6
+   */
+  bool readConfig(const char* path);
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+  void setConfig(const Config& config) {
+    config_ = config;
+  }
+
+  /**
+   * Start the workers and process the commands until `quit'.
+   */
+  bool start();
+
+private:
+
+  /** the source of the events from the GUI */
+  static CONSTEXPR_CONST int Gui = -1;
+
+  struct Event {
+    int source;
+    std::string line;
+    /** the worker exited */
+    bool closed;
+  };
+
+  struct Worker {
+    ChildProcess process;
+    std::thread reader;
+    bool alive;
+    bool searching;
+    std::string bestMove;
+    /** the depth, score and first move of the last PV */
+    int depth;
+    int score;
+    std::string pvMove;
+  };
+
+  bool startWorker(int index);
+
+  void onGuiCommand(const std::string& line);
+
+  void onWorkerLine(int index, const std::string& line);
+
+  void onWorkerClosed(int index);
+
+  void finishSearch();
+
+  void broadcast(const std::string& command);
+
+  void sendToWorker(int index, const std::string& command);
+
+  void sendToGui(const std::string& line);
+
+  void push(Event&& event);
+
+  Event pop();
+
+  void quit();
+
+private:
+
+  Config config_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::string name_;
+  std::vector<std::string> optionLines_;
+
+  int waitingForReady_;
+  int searching_;
+  bool quit_;
+
+  std::queue<Event> events_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+};
+
+} // namespace sunfish
+
+#endif // SUNFISH_USI_CLUSTER_CLUSTERCOORDINATOR_HPP__